@@ -25,11 +25,17 @@ public:
     return myIndex;
   };
 
+  size_t Size() const
+  {
+    return mySize;
+  };
+
   void Seek(size_t index);
 
   uint8_t ReadByte();
   uint16_t ReadUInt16();
   int16_t ReadInt16();
+  int32_t ReadInt32();
 
 private:
   size_t myIndex;
@@ -64,4 +70,13 @@ int16_t ArrayReader::ReadInt16()
   return (myArray[myIndex - 1] << 8) + myArray[myIndex - 2];
 }
 
+int32_t ArrayReader::ReadInt32()
+{
+  myIndex += 4;
+  return static_cast<int32_t>(
+    (static_cast<uint32_t>(myArray[myIndex - 1]) << 24) +
+    (myArray[myIndex - 2] << 16) + (myArray[myIndex - 3] << 8) +
+    myArray[myIndex - 4]);
+}
+
 #endif
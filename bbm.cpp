@@ -0,0 +1,254 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : BbmReader
+// PURPOSE      : Providing a decoder for the BBM (and LBM) image format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Finds the chunks of the file, expands the ByteRun1 runs of
+//                each row, converts bit planes to an index per pixel and then
+//                expands those with the palette.
+//
+//===----------------------------------------------------------------------===//
+
+#include "bbm.hpp"
+
+#include "image.hpp"
+
+#include <string.h>
+
+// The size of the FORM header and of the header of each chunk.
+static const size_t formSize = 12;
+static const size_t chunkHeaderSize = 8;
+
+// The size of the BMHD chunk.
+static const uint32_t headerSize = 20;
+
+enum Masking
+{
+  MaskNone = 0,
+  MaskHasMask = 1, // There is an extra plane after the others.
+  MaskTransparentColour = 2,
+};
+
+enum Compression
+{
+  CompressionNone = 0,
+  CompressionByteRun1 = 1,
+};
+
+static uint16_t readUInt16(const uint8_t* data)
+{
+  return static_cast<uint16_t>(data[0] << 8 | data[1]);
+}
+
+static uint32_t readUInt32(const uint8_t* data)
+{
+  return static_cast<uint32_t>(data[0]) << 24 | data[1] << 16 | data[2] << 8 |
+         data[3];
+}
+
+// Expands the ByteRun1 runs until size bytes have been written to the output.
+// Returns the position after the last run read, or nullptr if the input ran
+// out first.
+static const uint8_t* unpackByteRun1(const uint8_t* input,
+                                     const uint8_t* inputEnd, uint8_t* output,
+                                     size_t size)
+{
+  uint8_t* const outputEnd = output + size;
+  while (output < outputEnd)
+  {
+    if (input >= inputEnd) return nullptr;
+
+    const int8_t control = static_cast<int8_t>(*input++);
+    if (control >= 0)
+    {
+      size_t count = control + 1;
+      if (count > size_t(inputEnd - input)) return nullptr;
+      if (count > size_t(outputEnd - output)) count = outputEnd - output;
+      memcpy(output, input, count);
+      output += count;
+      input += control + 1;
+    }
+    else if (control != -128)
+    {
+      if (input >= inputEnd) return nullptr;
+      size_t count = 1 - control;
+      if (count > size_t(outputEnd - output)) count = outputEnd - output;
+      memset(output, *input++, count);
+      output += count;
+    }
+  }
+  return input;
+}
+
+// A table where entry n has a byte for each bit of n, from the most
+// significant, which is 1 if that bit is set. Or-ing the entries for a byte of
+// each plane shifted by the number of the plane turns 8 pixels from planes
+// into indices at once.
+struct BitsToBytes
+{
+  uint64_t table[256];
+
+  BitsToBytes()
+  {
+    for (int value = 0; value < 256; ++value)
+    {
+      uint8_t bytes[8];
+      for (int bit = 0; bit < 8; ++bit)
+      {
+        bytes[bit] = (value >> (7 - bit)) & 1;
+      }
+      memcpy(&table[value], bytes, sizeof(bytes));
+    }
+  }
+};
+
+static const BitsToBytes bitsToBytes;
+
+BbmReader::BbmReader(const uint8_t* data, size_t size)
+: myData(data), mySize(size)
+{
+}
+
+const uint8_t* BbmReader::Chunk(const char* name, uint32_t* size) const
+{
+  size_t offset = formSize;
+  while (offset + chunkHeaderSize <= mySize)
+  {
+    const uint32_t chunkSize = readUInt32(myData + offset + 4);
+    const size_t dataOffset = offset + chunkHeaderSize;
+    if (chunkSize > mySize - dataOffset) return nullptr;
+
+    if (memcmp(myData + offset, name, 4) == 0)
+    {
+      *size = chunkSize;
+      return myData + dataOffset;
+    }
+
+    // Chunks are padded to an even number of bytes.
+    offset = dataOffset + chunkSize + (chunkSize & 1);
+  }
+  return nullptr;
+}
+
+bool BbmReader::IsValid() const
+{
+  if (mySize < formSize) return false;
+  if (memcmp(myData, "FORM", 4) != 0) return false;
+  if (memcmp(myData + 8, "ILBM", 4) != 0 && memcmp(myData + 8, "PBM ", 4) != 0)
+  {
+    return false;
+  }
+
+  uint32_t size;
+  const uint8_t* header = Chunk("BMHD", &size);
+  if (!header || size < headerSize) return false;
+
+  const uint8_t planes = header[8];
+  const uint8_t compression = header[10];
+  if (planes == 0 || planes > 8) return false;
+  if (compression != CompressionNone && compression != CompressionByteRun1)
+  {
+    return false;
+  }
+
+  return Chunk("BODY", &size) != nullptr && Chunk("CMAP", &size) != nullptr &&
+         Width() > 0 && Height() > 0;
+}
+
+uint32_t BbmReader::Width() const
+{
+  uint32_t size;
+  const uint8_t* header = Chunk("BMHD", &size);
+  return header ? readUInt16(header) : 0;
+}
+
+uint32_t BbmReader::Height() const
+{
+  uint32_t size;
+  const uint8_t* header = Chunk("BMHD", &size);
+  return header ? readUInt16(header + 2) : 0;
+}
+
+bool BbmReader::Decode(Image* image) const
+{
+  if (!IsValid()) return false;
+
+  uint32_t size;
+  const uint8_t* header = Chunk("BMHD", &size);
+  const uint32_t width = readUInt16(header);
+  const uint32_t height = readUInt16(header + 2);
+  const uint8_t planes = header[8];
+  const uint8_t masking = header[9];
+  const uint8_t compression = header[10];
+  const uint16_t transparent = readUInt16(header + 12);
+  const bool isPlanar = memcmp(myData + 8, "ILBM", 4) == 0;
+
+  // Colours missing from the palette are black.
+  uint32_t colourMapSize;
+  const uint8_t* colourMap = Chunk("CMAP", &colourMapSize);
+  Palette palette;
+  memset(palette.colours, 0, sizeof(palette.colours));
+  memcpy(palette.colours, colourMap,
+         colourMapSize < sizeof(palette.colours) ? colourMapSize :
+                                                   sizeof(palette.colours));
+
+  uint32_t bodySize;
+  const uint8_t* body = Chunk("BODY", &bodySize);
+  const uint8_t* const bodyEnd = body + bodySize;
+
+  // Rows are padded to a multiple of 16 bits for each plane, the mask is an
+  // extra plane which is skipped.
+  const size_t planeRowSize = (width + 15) / 16 * 2;
+  const size_t rowSize = isPlanar ?
+                           planeRowSize * (planes + (masking == MaskHasMask)) :
+                           width + (width & 1);
+
+  // Each byte of a run is at most 128 bytes of the image, so anything bigger
+  // than that is bad data, which shouldn't cause a large allocation.
+  if (rowSize * height > size_t(bodySize) * 128) return false;
+
+  image->width = width;
+  image->height = height;
+  image->pixels.resize(size_t(width) * height * 4);
+
+  const uint64_t* const table = bitsToBytes.table;
+  std::vector<uint8_t> row(rowSize);
+  std::vector<uint8_t> indices(planeRowSize * 8);
+  for (uint32_t y = 0; y < height; ++y)
+  {
+    if (compression == CompressionByteRun1)
+    {
+      body = unpackByteRun1(body, bodyEnd, row.data(), rowSize);
+      if (!body) return false;
+    }
+    else
+    {
+      if (rowSize > size_t(bodyEnd - body)) return false;
+      memcpy(row.data(), body, rowSize);
+      body += rowSize;
+    }
+
+    const uint8_t* rowIndices = row.data();
+    if (isPlanar)
+    {
+      for (size_t x = 0; x < planeRowSize; ++x)
+      {
+        uint64_t eight = 0;
+        for (uint8_t plane = 0; plane < planes; ++plane)
+        {
+          eight |= table[row[plane * planeRowSize + x]] << plane;
+        }
+        memcpy(indices.data() + x * 8, &eight, sizeof(eight));
+      }
+      rowIndices = indices.data();
+    }
+
+    ExpandPalette(rowIndices, width, palette,
+                  image->pixels.data() + size_t(y) * width * 4,
+                  masking == MaskTransparentColour ? transparent : -1);
+  }
+  return true;
+}
@@ -0,0 +1,68 @@
+#ifndef BBM_HPP_GUARD
+#define BBM_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : BbmReader
+// PURPOSE      : Providing a decoder for the BBM (and LBM) image format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The game uses BBM images for things like the menu background
+//                and the pictures of the robots in the briefings.
+//
+//                These are the Interleaved Bitmap format from Deluxe Paint, an
+//                Interchange File Format (IFF) file where all the numbers are
+//                big endian. The file format is as follows:
+//
+//                 | "FORM" - 4 bytes
+//                 | size - 4 bytes
+//                 | "ILBM" or "PBM " - 4 bytes
+//                 | chunks - each is a 4 byte name, a 4 byte size and then
+//                 |          the data padded to an even size:
+//                 |   BMHD - the size of the image, the number of planes and
+//                 |          how it is compressed.
+//                 |   CMAP - the red, green and blue of each colour.
+//                 |   BODY - the pixels, one row at a time.
+//
+//                ILBM images store each row one bit plane after another where
+//                plane n has bit n of the index of each pixel, while PBM
+//                images store the index of each pixel as a byte. Either may
+//                be compressed with ByteRun1 where each run starts with a
+//                byte n, 0 to 127 means the next n + 1 bytes are copied and
+//                -1 to -127 means the next byte is repeated 1 - n times.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Image;
+
+class BbmReader
+{
+public:
+  // The reader should not outlive the data.
+  BbmReader(const uint8_t* data, size_t size);
+
+  bool IsValid() const;
+  // Returns true if the file has the header, palette and pixels of an image
+  // that is supported.
+
+  uint32_t Width() const;
+  uint32_t Height() const;
+
+  bool Decode(Image* image) const;
+  // Decodes the image into red, green, blue and alpha. Returns false if the
+  // data ends early.
+
+private:
+  const uint8_t* Chunk(const char* name, uint32_t* size) const;
+  // Returns the data of the chunk with the given name or nullptr if there is
+  // no such chunk.
+
+  const uint8_t* const myData;
+  const size_t mySize;
+};
+
+#endif
@@ -0,0 +1,772 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Benchmark
+// PURPOSE      : Providing timings of the level queries.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Times the level queries against every level in an archive.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark.hpp"
+
+#include "bvh.hpp"
+#include "collision.hpp"
+#include "cube.hpp"
+#include "file.hpp"
+#include "geometry.hpp"
+#include "graph.hpp"
+#include "hash.hpp"
+#include "hogiterator.hpp"
+#include "hogreader.hpp"
+#include "levelcache.hpp"
+#include "levelpack.hpp"
+#include "object.hpp"
+#include "prefetch.hpp"
+#include "quads.hpp"
+#include "rdl.hpp"
+#include "server.hpp"
+#include "sight.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <string>
+
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+
+namespace
+{
+  struct Level
+  {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<Cube> cubes;
+    std::vector<Wall> walls;
+  };
+
+  // Returns the seconds since the given start time.
+  double secondsSince(std::chrono::steady_clock::time_point start)
+  {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double>(elapsed).count();
+  }
+
+  // Returns every level in the archive, the largest level first.
+  std::vector<Level> levels(HogReader& reader)
+  {
+    std::vector<Level> levels;
+    for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+    {
+      const std::string name(file->name);
+      if (!IsLevelName(name.c_str())) continue;
+
+      const auto data = file.FileContents();
+      RdlReader rdlReader(data);
+      if (!rdlReader.IsValid()) continue;
+
+      Level level;
+      level.name = name;
+      level.vertices = rdlReader.Vertices();
+      level.cubes = rdlReader.Cubes();
+      level.walls = rdlReader.Walls();
+      levels.push_back(level);
+    }
+
+    std::stable_sort(levels.begin(), levels.end(),
+                     [](const Level& a, const Level& b)
+    { return a.cubes.size() > b.cubes.size(); });
+    return levels;
+  }
+
+  // Returns points spread over the level, a point at the centre of each cube
+  // (which will be found) and the rest random within the bounds of the level
+  // (which may be outside of it).
+  std::vector<Vertex> samplePoints(const Level& level, size_t count)
+  {
+    std::vector<Vertex> points;
+    points.reserve(count);
+
+    Vertex minimum = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+    Vertex maximum = { -HUGE_VAL, -HUGE_VAL, -HUGE_VAL };
+    for (auto cube = level.cubes.begin(); cube != level.cubes.end(); ++cube)
+    {
+      Vertex centre = { 0.0, 0.0, 0.0 };
+      for (int i = 0; i < 8; ++i)
+      {
+        const Vertex& vertex = level.vertices[cube->vertices[i]];
+        centre.x += vertex.x / 8;
+        centre.y += vertex.y / 8;
+        centre.z += vertex.z / 8;
+        minimum.x = std::min(minimum.x, vertex.x);
+        minimum.y = std::min(minimum.y, vertex.y);
+        minimum.z = std::min(minimum.z, vertex.z);
+        maximum.x = std::max(maximum.x, vertex.x);
+        maximum.y = std::max(maximum.y, vertex.y);
+        maximum.z = std::max(maximum.z, vertex.z);
+      }
+      if (points.size() < count / 2) points.push_back(centre);
+    }
+
+    std::mt19937 generator(1996);
+    std::uniform_real_distribution<double> x(minimum.x, maximum.x);
+    std::uniform_real_distribution<double> y(minimum.y, maximum.y);
+    std::uniform_real_distribution<double> z(minimum.z, maximum.z);
+    while (points.size() < count)
+    {
+      const Vertex point = { x(generator), y(generator), z(generator) };
+      points.push_back(point);
+    }
+    return points;
+  }
+
+  // Returns the centre of the cube.
+  Vertex centre(const Cube& cube, const std::vector<Vertex>& vertices)
+  {
+    Vertex centre = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < 8; ++i)
+    {
+      const Vertex& vertex = vertices[cube.vertices[i]];
+      centre.x += vertex.x / 8;
+      centre.y += vertex.y / 8;
+      centre.z += vertex.z / 8;
+    }
+    return centre;
+  }
+
+  // Returns queries between the centres of cubes which are a few sides apart,
+  // which are close enough that a good number of them can be seen.
+  std::vector<SightQuery> sightQueries(const Level& level, size_t count)
+  {
+    std::mt19937 generator(1996);
+    std::uniform_int_distribution<size_t> cubes(0, level.cubes.size() - 1);
+    std::uniform_int_distribution<int> sides(0, 5);
+    std::uniform_int_distribution<int> steps(1, 8);
+
+    std::vector<SightQuery> queries;
+    queries.reserve(count);
+    while (queries.size() < count)
+    {
+      const size_t source = cubes(generator);
+      size_t target = source;
+      for (int step = steps(generator); step > 0; --step)
+      {
+        const int16_t next = level.cubes[target].neighbors[sides(generator)];
+        if (next >= 0 && static_cast<size_t>(next) < level.cubes.size())
+        {
+          target = next;
+        }
+      }
+
+      const SightQuery query = {
+        centre(level.cubes[source], level.vertices),
+        centre(level.cubes[target], level.vertices),
+        static_cast<uint32_t>(source)
+      };
+      queries.push_back(query);
+    }
+    return queries;
+  }
+}
+
+void BenchmarkLocate(HogReader& reader, std::ostream& output)
+{
+  // The brute force search is slow on large levels so it uses fewer points.
+  const size_t pointCount = 200000;
+  const size_t bruteForceCount = 5000;
+
+  output << std::left << std::setw(14) << "Level" << std::right
+         << std::setw(7) << "Cubes" << std::setw(11) << "Build ms"
+         << std::setw(12) << "BVH ns/pt" << std::setw(14) << "Batch ns/pt"
+         << std::setw(14) << "Brute ns/pt" << std::setw(10) << "Differ"
+         << std::endl;
+
+  const auto allLevels = levels(reader);
+  for (auto level = allLevels.begin(); level != allLevels.end(); ++level)
+  {
+    if (level->cubes.empty()) continue;
+
+    auto start = std::chrono::steady_clock::now();
+    const CubeBvh bvh(level->cubes, level->vertices);
+    const double build = secondsSince(start);
+
+    const auto points = samplePoints(*level, pointCount);
+
+    std::vector<int32_t> single(points.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      single[i] = bvh.Locate(points[i]);
+    }
+    const double bvhTime = secondsSince(start);
+
+    std::vector<int32_t> batch(points.size());
+    start = std::chrono::steady_clock::now();
+    bvh.Locate(points.data(), points.size(), batch.data());
+    const double batchTime = secondsSince(start);
+
+    std::vector<CubePlanes> planes;
+    planes.reserve(level->cubes.size());
+    for (auto cube = level->cubes.begin(); cube != level->cubes.end(); ++cube)
+    {
+      planes.push_back(Planes(*cube, level->vertices));
+    }
+
+    // Points on a shared side are in both cubes so only count the points
+    // where one found a cube and the other didn't.
+    const size_t bruteCount = std::min(bruteForceCount, points.size());
+    size_t differences = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < bruteCount; ++i)
+    {
+      const int32_t cube = LocateByTestingAll(planes, points[i]);
+      if ((cube == -1) != (single[i] == -1)) ++differences;
+    }
+    const double bruteTime = secondsSince(start);
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      if (single[i] != batch[i]) ++differences;
+    }
+
+    output << std::left << std::setw(14) << level->name << std::right
+           << std::setw(7) << level->cubes.size() << std::fixed
+           << std::setprecision(3) << std::setw(11) << build * 1e3
+           << std::setprecision(1) << std::setw(12)
+           << bvhTime * 1e9 / points.size() << std::setw(14)
+           << batchTime * 1e9 / points.size() << std::setw(14)
+           << bruteTime * 1e9 / bruteCount << std::setw(10) << differences
+           << std::endl;
+  }
+}
+
+void BenchmarkDecode(HogReader& reader, std::ostream& output)
+{
+  // Each level is decoded until at least this much time has passed so small
+  // levels are timed over enough runs.
+  const double minimumSeconds = 0.2;
+
+  output << std::left << std::setw(14) << "Level" << std::right
+         << std::setw(9) << "Version" << std::setw(7) << "Cubes"
+         << std::setw(12) << "Decode us" << std::setw(12) << "MB/s"
+         << std::setw(14) << "Mcubes/s" << std::endl;
+
+  for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+  {
+    const std::string name(file->name);
+    if (!IsLevelName(name.c_str())) continue;
+
+    const auto data = file.FileContents();
+    RdlReader rdlReader(data);
+    if (!rdlReader.IsValid()) continue;
+
+    uint32_t version;
+    memcpy(&version, data.data() + 4, sizeof(version));
+
+    size_t runs = 0;
+    size_t cubes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    double seconds;
+    do
+    {
+      cubes = rdlReader.Cubes().size();
+      ++runs;
+      seconds = secondsSince(start);
+    } while (seconds < minimumSeconds);
+
+    const double perRun = seconds / runs;
+    output << std::left << std::setw(14) << name << std::right
+           << std::setw(9) << version << std::setw(7) << cubes << std::fixed
+           << std::setprecision(1) << std::setw(12) << perRun * 1e6
+           << std::setw(12) << data.size() / perRun / 1e6 << std::setw(14)
+           << cubes / perRun / 1e6 << std::endl;
+  }
+}
+
+void BenchmarkSight(HogReader& reader, std::ostream& output)
+{
+  // The brute force search is slow on large levels so it uses fewer queries.
+  const size_t queryCount = 200000;
+  const size_t bruteForceCount = 2000;
+
+  output << std::left << std::setw(14) << "Level" << std::right
+         << std::setw(7) << "Cubes" << std::setw(11) << "Build ms"
+         << std::setw(12) << "Walk ns/q" << std::setw(14) << "Batch ns/q"
+         << std::setw(14) << "Brute ns/q" << std::setw(10) << "Visible"
+         << std::setw(10) << "Differ" << std::endl;
+
+  const auto allLevels = levels(reader);
+  for (auto level = allLevels.begin(); level != allLevels.end(); ++level)
+  {
+    if (level->cubes.empty()) continue;
+
+    auto start = std::chrono::steady_clock::now();
+    const LineOfSight sight(level->cubes, level->vertices);
+    const double build = secondsSince(start);
+
+    const auto queries = sightQueries(*level, queryCount);
+
+    std::vector<uint8_t> single(queries.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      single[i] = sight.IsVisible(queries[i]) ? 1 : 0;
+    }
+    const double walkTime = secondsSince(start);
+
+    std::vector<uint8_t> batch(queries.size());
+    start = std::chrono::steady_clock::now();
+    sight.IsVisible(queries.data(), queries.size(), batch.data());
+    const double batchTime = secondsSince(start);
+
+    const auto triangles = SolidTriangles(level->cubes, level->vertices);
+    const size_t bruteCount = std::min(bruteForceCount, queries.size());
+    size_t differences = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < bruteCount; ++i)
+    {
+      const bool visible = IsVisibleByTestingAll(triangles, queries[i].from,
+                                                 queries[i].to);
+      if (visible != (single[i] != 0)) ++differences;
+    }
+    const double bruteTime = secondsSince(start);
+
+    size_t visible = 0;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      if (single[i] != batch[i]) ++differences;
+      if (single[i]) ++visible;
+    }
+
+    output << std::left << std::setw(14) << level->name << std::right
+           << std::setw(7) << level->cubes.size() << std::fixed
+           << std::setprecision(3) << std::setw(11) << build * 1e3
+           << std::setprecision(1) << std::setw(12)
+           << walkTime * 1e9 / queries.size() << std::setw(14)
+           << batchTime * 1e9 / queries.size() << std::setw(14)
+           << bruteTime * 1e9 / bruteCount << std::setw(9)
+           << visible * 100.0 / queries.size() << '%' << std::setw(10)
+           << differences << std::endl;
+  }
+}
+
+void BenchmarkCollision(HogReader& reader, std::ostream& output)
+{
+  const size_t queryCount = 200000;
+
+  // The spheres range from the size of a laser bolt to a large robot.
+  std::mt19937 generator(1996);
+  std::uniform_real_distribution<float> radii(0.5f, 8.0f);
+
+  output << std::left << std::setw(14) << "Level" << std::right
+         << std::setw(7) << "Cubes" << std::setw(11) << "Build ms"
+         << std::setw(12) << "Walk ns/q" << std::setw(14) << "Batch ns/q"
+         << std::setw(12) << "Msweeps/s" << std::setw(10) << "Blocked"
+         << std::setw(10) << "Differ" << std::endl;
+
+  const auto allLevels = levels(reader);
+  for (auto level = allLevels.begin(); level != allLevels.end(); ++level)
+  {
+    if (level->cubes.empty()) continue;
+
+    auto start = std::chrono::steady_clock::now();
+    const SphereSweep sweep(level->cubes, level->vertices);
+    const double build = secondsSince(start);
+
+    // The sweeps go twice as far as the cube they are aimed at, so plenty of
+    // them run into something.
+    auto sightQueries = ::sightQueries(*level, queryCount);
+    std::vector<SweepQuery> queries(sightQueries.size());
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      SightQuery& sightQuery = sightQueries[i];
+      sightQuery.to.x += sightQuery.to.x - sightQuery.from.x;
+      sightQuery.to.y += sightQuery.to.y - sightQuery.from.y;
+      sightQuery.to.z += sightQuery.to.z - sightQuery.from.z;
+
+      queries[i].from = sightQuery.from;
+      queries[i].to = sightQuery.to;
+      queries[i].radius = radii(generator);
+      queries[i].cube = sightQuery.cube;
+    }
+
+    std::vector<SweepContact> single(queries.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      single[i] = sweep.Sweep(queries[i]);
+    }
+    const double walkTime = secondsSince(start);
+
+    std::vector<SweepContact> batch(queries.size());
+    start = std::chrono::steady_clock::now();
+    sweep.Sweep(queries.data(), queries.size(), batch.data());
+    const double batchTime = secondsSince(start);
+
+    size_t differences = 0;
+    size_t blocked = 0;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      if (single[i].isBlocked != batch[i].isBlocked ||
+          single[i].fraction != batch[i].fraction)
+      {
+        ++differences;
+      }
+      if (single[i].isBlocked) ++blocked;
+    }
+
+    // A sphere with no radius is blocked exactly when the segment is.
+    const LineOfSight sight(level->cubes, level->vertices);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      SweepQuery point = queries[i];
+      point.radius = 0.0f;
+      const bool isBlocked = sweep.Sweep(point).isBlocked != 0;
+      if (isBlocked == sight.IsVisible(sightQueries[i])) ++differences;
+    }
+
+    output << std::left << std::setw(14) << level->name << std::right
+           << std::setw(7) << level->cubes.size() << std::fixed
+           << std::setprecision(3) << std::setw(11) << build * 1e3
+           << std::setprecision(1) << std::setw(12)
+           << walkTime * 1e9 / queries.size() << std::setw(14)
+           << batchTime * 1e9 / queries.size() << std::setw(12)
+           << queries.size() / batchTime / 1e6 << std::setw(9)
+           << blocked * 100.0 / queries.size() << '%' << std::setw(10)
+           << differences << std::endl;
+  }
+}
+
+void BenchmarkPath(HogReader& reader, std::ostream& output)
+{
+  // The queries come from a few sources, like the robots of a level heading
+  // for the player, so the batch shares a search between many of them. The
+  // queries answered one at a time and by A* are fewer as they are slower.
+  const size_t queryCount = 200000;
+  const size_t sourceCount = 64;
+  const size_t singleCount = 2000;
+  const size_t aStarCount = 20000;
+
+  output << std::left << std::setw(14) << "Level" << std::right
+         << std::setw(7) << "Cubes" << std::setw(11) << "Build ms"
+         << std::setw(13) << "Single ns/q" << std::setw(14) << "Batch ns/q"
+         << std::setw(12) << "A* ns/q" << std::setw(12) << "Reachable"
+         << std::setw(10) << "Differ" << std::endl;
+
+  const auto allLevels = levels(reader);
+  for (auto level = allLevels.begin(); level != allLevels.end(); ++level)
+  {
+    if (level->cubes.empty()) continue;
+
+    auto start = std::chrono::steady_clock::now();
+    const CubeGraph graph(level->cubes, level->vertices, level->walls);
+    const double build = secondsSince(start);
+
+    std::mt19937 generator(1996);
+    std::uniform_int_distribution<uint32_t> cubes(
+        0, static_cast<uint32_t>(level->cubes.size() - 1));
+    std::vector<uint32_t> sources(sourceCount);
+    for (size_t i = 0; i < sources.size(); ++i) sources[i] = cubes(generator);
+    std::uniform_int_distribution<size_t> source(0, sources.size() - 1);
+
+    std::vector<PathQuery> queries(queryCount);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      queries[i].source = sources[source(generator)];
+      queries[i].target = cubes(generator);
+    }
+
+    start = std::chrono::steady_clock::now();
+    const auto hops = BreadthFirst(graph, queries);
+    const double batchTime = secondsSince(start);
+
+    // A search for each query on its own, which is what the batch saves.
+    const size_t singles = std::min(singleCount, queries.size());
+    size_t differences = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < singles; ++i)
+    {
+      const std::vector<PathQuery> single(1, queries[i]);
+      if (BreadthFirst(graph, single)[0] != hops[i]) ++differences;
+    }
+    const double singleTime = secondsSince(start);
+
+    // The shortest path is found exactly when there is one, and it can't
+    // pass through fewer sides than the breadth first search found.
+    const std::vector<PathQuery> aStarQueries(
+        queries.begin(),
+        queries.begin() + std::min(aStarCount, queries.size()));
+    std::vector<std::vector<uint32_t>> paths;
+    start = std::chrono::steady_clock::now();
+    const auto distances = AStar(graph, aStarQueries, &paths);
+    const double aStarTime = secondsSince(start);
+    for (size_t i = 0; i < aStarQueries.size(); ++i)
+    {
+      const bool isReached = distances[i] != unreachableDistance;
+      if (isReached != (hops[i] != unreachableHops) ||
+          (isReached && paths[i].size() - 1 < hops[i]))
+      {
+        ++differences;
+      }
+    }
+
+    size_t reachable = 0;
+    for (size_t i = 0; i < hops.size(); ++i)
+    {
+      if (hops[i] != unreachableHops) ++reachable;
+    }
+
+    output << std::left << std::setw(14) << level->name << std::right
+           << std::setw(7) << level->cubes.size() << std::fixed
+           << std::setprecision(3) << std::setw(11) << build * 1e3
+           << std::setprecision(1) << std::setw(13)
+           << singleTime * 1e9 / singles << std::setw(14)
+           << batchTime * 1e9 / queries.size() << std::setw(12)
+           << aStarTime * 1e9 / aStarQueries.size() << std::setw(11)
+           << reachable * 100.0 / queries.size() << '%' << std::setw(10)
+           << differences << std::endl;
+  }
+}
+
+void BenchmarkPrefetch(HogReader& reader, std::ostream& output)
+{
+  const struct
+  {
+    Prefetcher::Backend backend;
+    size_t depth;
+  } configurations[] = {
+    { Prefetcher::Synchronous, 1 }, { Prefetcher::IoUring, 1 },
+    { Prefetcher::IoUring, 4 }, { Prefetcher::IoUring, 16 },
+    { Prefetcher::IoUring, 64 }
+  };
+
+  const auto entries = reader.Entries();
+  uint64_t totalSize = 0;
+  for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+  {
+    totalSize += entry->size;
+  }
+
+  output << std::left << std::setw(14) << "Backend" << std::right
+         << std::setw(7) << "Depth" << std::setw(8) << "Files"
+         << std::setw(9) << "Cubes" << std::setw(12) << "Total ms"
+         << std::setw(10) << "MB/s" << std::setw(10) << "Failed"
+         << std::setw(10) << "Differ" << std::endl;
+
+  // The hash of each file read the first time, which the other runs are
+  // checked against.
+  std::vector<uint64_t> expected;
+  for (auto configuration = std::begin(configurations);
+       configuration != std::end(configurations); ++configuration)
+  {
+    reader.Archive().DontNeed();
+
+    const auto start = std::chrono::steady_clock::now();
+    Prefetcher prefetcher(reader.Archive(), entries, configuration->depth,
+                          configuration->backend);
+    std::vector<uint64_t> hashes(entries.size());
+    size_t failed = 0;
+    size_t cubes = 0;
+    PrefetchedEntry entry;
+    while (prefetcher.Next(&entry))
+    {
+      if (!entry.succeeded) ++failed;
+      hashes[entry.index] = Hash64(entry.data.data(), entry.data.size());
+
+      if (IsLevelName(entries[entry.index].name))
+      {
+        RdlReader rdlReader(entry.data);
+        if (rdlReader.IsValid()) cubes += rdlReader.Cubes().size();
+      }
+    }
+    const double seconds = secondsSince(start);
+
+    if (expected.empty()) expected = hashes;
+    size_t differences = 0;
+    for (size_t i = 0; i < hashes.size(); ++i)
+    {
+      if (hashes[i] != expected[i]) ++differences;
+    }
+
+    const bool isRing = prefetcher.ActiveBackend() == Prefetcher::IoUring;
+    output << std::left << std::setw(14)
+           << (isRing ? "io_uring" : "pread") << std::right << std::setw(7)
+           << configuration->depth << std::setw(8) << entries.size()
+           << std::setw(9) << cubes << std::fixed << std::setprecision(1)
+           << std::setw(12) << seconds * 1e3 << std::setw(10)
+           << totalSize / seconds / 1e6 << std::setw(10) << failed
+           << std::setw(10) << differences << std::endl;
+  }
+}
+
+void BenchmarkServer(HogReader& reader, const char* archive,
+                     const char* socketPath, std::ostream& output)
+{
+  // The requests are sent this many times after the first time, when the
+  // levels have been decoded by the server.
+  const int warmRuns = 5;
+
+  HogClient client(socketPath);
+  if (!client.IsValid())
+  {
+    output << "Unable to connect to " << socketPath << std::endl;
+    return;
+  }
+
+  std::vector<std::string> entries;
+  std::vector<std::string> levels;
+  std::vector<std::string> texts;
+  for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+  {
+    std::string name(file->name);
+    entries.push_back(name);
+    if (IsLevelName(name.c_str())) levels.push_back(name);
+
+    for (auto c = name.begin(); c != name.end(); ++c)
+    {
+      *c = static_cast<char>(tolower(*c));
+    }
+    if (name.length() > 4 && name.substr(name.length() - 4) == ".txb")
+    {
+      texts.push_back(file->name);
+    }
+  }
+
+  output << std::left << std::setw(14) << "Request" << std::right
+         << std::setw(7) << "Count" << std::setw(12) << "Cold us"
+         << std::setw(12) << "First us" << std::setw(12) << "Warm us"
+         << std::setw(10) << "Speedup" << std::setw(8) << "Differ"
+         << std::endl;
+
+  const auto time = [&](const char* kind, ServerCommand command,
+                        const std::vector<std::string>& names)
+  {
+    if (names.empty()) return;
+
+    std::vector<std::string> expected(names.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      LevelCache noLevels(0);
+      HogServer server(noLevels, 0);
+      server.AddArchive(archive);
+
+      std::string request(1, static_cast<char>(command));
+      request += archive;
+      request.push_back('\0');
+      request += names[i];
+      server.Handle(request, &expected[i]);
+    }
+    const double cold = secondsSince(start) / names.size();
+
+    size_t differences = 0;
+    std::string response;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+      client.Request(command, archive, names[i], &response);
+      if (response != expected[i]) ++differences;
+    }
+    const double first = secondsSince(start) / names.size();
+
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < warmRuns; ++run)
+    {
+      for (size_t i = 0; i < names.size(); ++i)
+      {
+        client.Request(command, archive, names[i], &response);
+        if (response != expected[i]) ++differences;
+      }
+    }
+    const double warm = secondsSince(start) / (names.size() * warmRuns);
+
+    output << std::left << std::setw(14) << kind << std::right
+           << std::setw(7) << names.size() << std::fixed
+           << std::setprecision(1) << std::setw(12) << cold * 1e6
+           << std::setw(12) << first * 1e6 << std::setw(12) << warm * 1e6
+           << std::setw(10) << cold / warm << std::setw(8) << differences
+           << std::endl;
+  };
+
+  time("list", ServerList, std::vector<std::string>(1));
+  time("fetch", ServerFetch, entries);
+  time("export-level", ServerExportLevel, levels);
+  time("decode-text", ServerDecodeText, texts);
+}
+
+void BenchmarkPack(HogReader& reader, const char* packFilename,
+                   std::ostream& output)
+{
+  // Each level is loaded until at least this much time has passed so small
+  // levels are timed over enough runs.
+  const double minimumSeconds = 0.2;
+
+  if (!LevelPack(packFilename).IsValid())
+  {
+    output << "Unable to open the level pack " << packFilename << std::endl;
+    return;
+  }
+
+  output << std::left << std::setw(14) << "Level" << std::right
+         << std::setw(7) << "Cubes" << std::setw(12) << "Decode us"
+         << std::setw(12) << "Pack us" << std::setw(10) << "Speedup"
+         << std::endl;
+
+  for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+  {
+    const std::string name(file->name);
+    if (!IsLevelName(name.c_str())) continue;
+
+    const auto data = file.FileContents();
+    RdlReader rdlReader(data);
+    if (!rdlReader.IsValid()) continue;
+
+    size_t runs = 0;
+    size_t cubes = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds;
+    do
+    {
+      const auto vertices = rdlReader.Vertices();
+      const auto levelCubes = rdlReader.Cubes();
+      const auto quads = Quads(levelCubes);
+      cubes = levelCubes.size();
+      ++runs;
+      seconds = secondsSince(start);
+    } while (seconds < minimumSeconds);
+    const double decodeRun = seconds / runs;
+
+    runs = 0;
+    size_t packedCubes = 0;
+    start = std::chrono::steady_clock::now();
+    do
+    {
+      const LevelPack pack(packFilename);
+      size_t index;
+      if (!pack.Find(name.c_str(), &index)) break;
+      packedCubes = pack.Level(index).cubeCount;
+      ++runs;
+      seconds = secondsSince(start);
+    } while (seconds < minimumSeconds);
+
+    if (runs == 0 || packedCubes != cubes)
+    {
+      output << std::left << std::setw(14) << name << std::right
+             << " is not the same in the level pack" << std::endl;
+      continue;
+    }
+
+    const double packRun = seconds / runs;
+    output << std::left << std::setw(14) << name << std::right
+           << std::setw(7) << cubes << std::fixed << std::setprecision(1)
+           << std::setw(12) << decodeRun * 1e6 << std::setw(12)
+           << packRun * 1e6 << std::setw(10) << decodeRun / packRun
+           << std::endl;
+  }
+}
@@ -0,0 +1,66 @@
+#ifndef BENCHMARK_HPP_GUARD
+#define BENCHMARK_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Benchmark
+// PURPOSE      : Providing timings of the level queries.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Each benchmark runs over every level in an archive and prints
+//                a line per level, from the level with the most cubes to the
+//                least, comparing the fast path against the simple one.
+//
+//                The server benchmark instead prints a line per kind of
+//                request.
+//
+//===----------------------------------------------------------------------===//
+
+#include <iosfwd>
+
+class HogReader;
+
+void BenchmarkLocate(HogReader& reader, std::ostream& output);
+// Times finding the cube that contains random points with the bounding
+// volume hierarchy against testing every cube.
+
+void BenchmarkDecode(HogReader& reader, std::ostream& output);
+// Times decoding the cubes of each level, whichever version it is.
+
+void BenchmarkSight(HogReader& reader, std::ostream& output);
+// Times line of sight queries by following them through the cubes against
+// testing every solid side.
+
+void BenchmarkCollision(HogReader& reader, std::ostream& output);
+// Times sweeping spheres of different sizes through the cubes one at a time
+// against all of them at once on many threads. The sweeps of spheres with no
+// radius are checked against the line of sight.
+
+void BenchmarkPath(HogReader& reader, std::ostream& output);
+// Times finding how many sides apart the cubes are, with a search for each
+// query against one search for all the queries from the same cube, and times
+// finding the shortest path with A*. The paths don't go through walls which
+// can't be flown through.
+
+void BenchmarkPrefetch(HogReader& reader, std::ostream& output);
+// Times reading every file in the archive, starting with none of it cached,
+// and decoding the levels and hashing the rest, reading each file when it is
+// needed against queuing the reads ahead of time. A line is printed for each
+// backend and depth rather than each level.
+
+void BenchmarkServer(HogReader& reader, const char* archive,
+                     const char* socketPath, std::ostream& output);
+// Times each kind of request to the server listening on the socket against
+// answering it the way a separate run of this program would, which opens
+// the archive and reads its directory for every request. The time to start
+// the process isn't included so the real difference is larger.
+
+void BenchmarkPack(HogReader& reader, const char* packFilename,
+                   std::ostream& output);
+// Times decoding the vertices, cubes and quads of each level against mapping
+// the pack built from the archive and finding the level in it. The pack is
+// mapped again for each run but its pages stay cached, like they would for a
+// program which loads levels from it often.
+
+#endif
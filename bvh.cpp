@@ -0,0 +1,225 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : CubeBvh
+// PURPOSE      : Providing a way to find the cube that contains a point.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Builds a bounding volume hierarchy over the cubes of a level
+//                and uses it to find the cubes that contain points.
+//
+//===----------------------------------------------------------------------===//
+
+#include "bvh.hpp"
+
+#include "cube.hpp"
+#include "parallel.hpp"
+#include "rdl.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include <math.h>
+
+// The most cubes that are stored in a leaf.
+static const uint32_t leafSize = 4;
+
+// Subtrees are built on separate threads down to this depth.
+static const int parallelDepth = 3;
+
+// The number of points that are given to a thread at a time.
+static const size_t batchSize = 1024;
+
+// Returns the number of nodes in the tree over the given number of cubes.
+static uint32_t nodeCount(uint32_t cubeCount)
+{
+  if (cubeCount <= leafSize) return 1;
+  return 1 + nodeCount(cubeCount / 2) + nodeCount(cubeCount - cubeCount / 2);
+}
+
+static bool contains(const Bounds& bounds, float x, float y, float z)
+{
+  return x >= bounds.min[0] && x <= bounds.max[0] && y >= bounds.min[1] &&
+         y <= bounds.max[1] && z >= bounds.min[2] && z <= bounds.max[2];
+}
+
+CubeBvh::CubeBvh(const std::vector<Cube>& cubes,
+                 const std::vector<Vertex>& vertices)
+: myPlanes(cubes.size())
+{
+  std::vector<Bounds> bounds(cubes.size());
+  std::vector<uint8_t> isValidCube(cubes.size());
+  ParallelFor(cubes.size(), [&](size_t i, size_t)
+  {
+    bool isValid = true;
+    for (int j = 0; j < 8; ++j)
+    {
+      if (cubes[i].vertices[j] >= vertices.size()) isValid = false;
+    }
+
+    isValidCube[i] = isValid ? 1 : 0;
+    if (isValid)
+    {
+      myPlanes[i] = Planes(cubes[i], vertices);
+      bounds[i] = CubeBounds(cubes[i], vertices);
+    }
+    else
+    {
+      // Nothing is inside a cube which can't be built.
+      CubePlanes& planes = myPlanes[i];
+      for (int j = 0; j < 12; ++j)
+      {
+        planes.nx[j] = planes.ny[j] = planes.nz[j] = 0.0f;
+        planes.d[j] = -1.0f;
+      }
+      planes.convexSides = 0x3F;
+    }
+  });
+
+  // The cubes which can't be built have no bounds so are left out of the
+  // tree, as their centres would not be numbers.
+  for (size_t i = 0; i < cubes.size(); ++i)
+  {
+    if (isValidCube[i]) myCubes.push_back(static_cast<uint32_t>(i));
+  }
+
+  if (myCubes.empty()) return;
+
+  const uint32_t count = static_cast<uint32_t>(myCubes.size());
+  myNodes.resize(nodeCount(count));
+  Build(0, 0, count, bounds, 0);
+}
+
+void CubeBvh::Build(uint32_t node, uint32_t first, uint32_t count,
+                    const std::vector<Bounds>& bounds, int depth)
+{
+  // Work out the box around all the cubes and around their centres, which is
+  // used to decide how to split them.
+  Bounds total;
+  Bounds centres;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    total.min[axis] = centres.min[axis] = HUGE_VALF;
+    total.max[axis] = centres.max[axis] = -HUGE_VALF;
+  }
+
+  for (uint32_t i = first; i < first + count; ++i)
+  {
+    const Bounds& cube = bounds[myCubes[i]];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      const float centre = (cube.min[axis] + cube.max[axis]) * 0.5f;
+      total.min[axis] = std::min(total.min[axis], cube.min[axis]);
+      total.max[axis] = std::max(total.max[axis], cube.max[axis]);
+      centres.min[axis] = std::min(centres.min[axis], centre);
+      centres.max[axis] = std::max(centres.max[axis], centre);
+    }
+  }
+
+  myNodes[node].bounds = total;
+  if (count <= leafSize)
+  {
+    myNodes[node].first = first;
+    myNodes[node].count = count;
+    return;
+  }
+
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+  {
+    if (centres.max[i] - centres.min[i] > centres.max[axis] - centres.min[axis])
+    {
+      axis = i;
+    }
+  }
+
+  const uint32_t half = count / 2;
+  std::nth_element(myCubes.begin() + first, myCubes.begin() + first + half,
+                   myCubes.begin() + first + count,
+                   [&bounds, axis](uint32_t a, uint32_t b)
+  {
+    return bounds[a].min[axis] + bounds[a].max[axis] <
+           bounds[b].min[axis] + bounds[b].max[axis];
+  });
+
+  const uint32_t left = node + 1;
+  const uint32_t right = left + nodeCount(half);
+  myNodes[node].first = right;
+  myNodes[node].count = 0;
+
+  if (depth < parallelDepth && count > 1024)
+  {
+    std::thread leftBuilder(&CubeBvh::Build, this, left, first, half,
+                            std::cref(bounds), depth + 1);
+    Build(right, first + half, count - half, bounds, depth + 1);
+    leftBuilder.join();
+  }
+  else
+  {
+    Build(left, first, half, bounds, depth + 1);
+    Build(right, first + half, count - half, bounds, depth + 1);
+  }
+}
+
+int32_t CubeBvh::Locate(const Vertex& point) const
+{
+  if (myNodes.empty()) return -1;
+
+  const float x = static_cast<float>(point.x);
+  const float y = static_cast<float>(point.y);
+  const float z = static_cast<float>(point.z);
+
+  // The tree is balanced so its depth is at most 32 for 2^32 cubes.
+  uint32_t stack[64];
+  size_t stackSize = 0;
+  stack[stackSize++] = 0;
+  while (stackSize > 0)
+  {
+    const Node& node = myNodes[stack[--stackSize]];
+    if (!contains(node.bounds, x, y, z)) continue;
+
+    if (node.count == 0)
+    {
+      stack[stackSize++] = node.first;
+      stack[stackSize++] = static_cast<uint32_t>(&node - myNodes.data()) + 1;
+      continue;
+    }
+
+    for (uint32_t i = node.first; i < node.first + node.count; ++i)
+    {
+      if (Contains(myPlanes[myCubes[i]], x, y, z))
+      {
+        return static_cast<int32_t>(myCubes[i]);
+      }
+    }
+  }
+
+  return -1;
+}
+
+void CubeBvh::Locate(const Vertex* points, size_t count, int32_t* cubes) const
+{
+  const size_t batches = (count + batchSize - 1) / batchSize;
+  ParallelFor(batches, [=](size_t batch, size_t)
+  {
+    const size_t end = std::min(count, (batch + 1) * batchSize);
+    for (size_t i = batch * batchSize; i < end; ++i)
+    {
+      cubes[i] = Locate(points[i]);
+    }
+  });
+}
+
+int32_t LocateByTestingAll(const std::vector<CubePlanes>& planes,
+                           const Vertex& point)
+{
+  const float x = static_cast<float>(point.x);
+  const float y = static_cast<float>(point.y);
+  const float z = static_cast<float>(point.z);
+  for (size_t i = 0; i < planes.size(); ++i)
+  {
+    if (Contains(planes[i], x, y, z)) return static_cast<int32_t>(i);
+  }
+  return -1;
+}
@@ -0,0 +1,71 @@
+#ifndef BVH_HPP_GUARD
+#define BVH_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : CubeBvh
+// PURPOSE      : Providing a way to find the cube that contains a point.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A bounding volume hierarchy over the cubes of a level.
+//
+//                Each node holds the box around the cubes below it and the
+//                cubes are split in half along the longest axis of the box at
+//                each level, so finding the boxes that hold a point visits a
+//                logarithmic number of nodes. The cubes in those boxes are
+//                then tested against the planes of their sides.
+//
+//                The nodes are stored depth first in one array where the left
+//                child of a node follows it, since the size of each subtree
+//                is known from the number of cubes in it the subtrees can be
+//                built in parallel.
+//
+//===----------------------------------------------------------------------===//
+
+#include "geometry.hpp"
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+struct Vertex;
+
+class CubeBvh
+{
+public:
+  CubeBvh(const std::vector<Cube>& cubes, const std::vector<Vertex>& vertices);
+
+  int32_t Locate(const Vertex& point) const;
+  // Returns the cube which contains the point or -1 if it is outside the
+  // level.
+
+  void Locate(const Vertex* points, size_t count, int32_t* cubes) const;
+  // Finds the cube which contains each point (or -1), the points are split
+  // between all the cores.
+
+private:
+  struct Node
+  {
+    Bounds bounds;
+    uint32_t first; // The first cube for a leaf or the right child.
+    uint32_t count; // The number of cubes for a leaf or 0.
+  };
+
+  void Build(uint32_t node, uint32_t first, uint32_t count,
+             const std::vector<Bounds>& bounds, int depth);
+
+  std::vector<Node> myNodes;
+  std::vector<uint32_t> myCubes; // The cubes in the order of the leaves,
+                                 // without the ones which can't be built.
+  std::vector<CubePlanes> myPlanes;
+};
+
+int32_t LocateByTestingAll(const std::vector<CubePlanes>& planes,
+                           const Vertex& point);
+// Returns the cube which contains the point by testing every cube, this is
+// for comparison.
+
+#endif
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : SphereSweep
+// PURPOSE      : Providing where a sphere moving through a level first touches
+//                the sides of the mine.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Follows the centres of spheres through the cubes of a level
+//                by finding the side of each cube that they leave through or
+//                come within their radius of.
+//
+//===----------------------------------------------------------------------===//
+
+#include "collision.hpp"
+
+#include "cube.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+
+// The number of queries that are given to a thread at a time.
+static const size_t batchSize = 256;
+
+SphereSweep::SphereSweep(const std::vector<Cube>& cubes,
+                         const std::vector<Vertex>& vertices)
+: myPlanes(cubes.size()), myIsValid(cubes.size()),
+  myNext(cubes.size() * 6), mySolid(cubes.size() * 12)
+{
+  ParallelFor(cubes.size(), [&](size_t i, size_t)
+  {
+    const Cube& cube = cubes[i];
+
+    bool isValid = true;
+    for (int j = 0; j < 8; ++j)
+    {
+      if (cube.vertices[j] >= vertices.size()) isValid = false;
+    }
+
+    myIsValid[i] = isValid ? 1 : 0;
+    if (isValid) myPlanes[i] = Planes(cube, vertices);
+
+    for (int side = 0; side < 6; ++side)
+    {
+      const int16_t neighbour = cube.neighbors[side];
+      const bool isOpen = isValid && neighbour >= 0 &&
+                          static_cast<size_t>(neighbour) < cubes.size() &&
+                          cube.walls[side] == 255;
+      myNext[i * 6 + side] = isOpen ? neighbour : -1;
+      mySolid[i * 12 + side * 2] = isOpen ? 0.0f : 1.0f;
+      mySolid[i * 12 + side * 2 + 1] = isOpen ? 0.0f : 1.0f;
+    }
+  });
+}
+
+SweepContact SphereSweep::Sweep(const SweepQuery& query) const
+{
+  SweepContact contact = { 0.0f, query.cube, -1, 1 };
+  if (query.cube >= myPlanes.size()) return contact;
+
+  const float from[3] = { static_cast<float>(query.from.x),
+                          static_cast<float>(query.from.y),
+                          static_cast<float>(query.from.z) };
+  const float to[3] = { static_cast<float>(query.to.x),
+                        static_cast<float>(query.to.y),
+                        static_cast<float>(query.to.z) };
+  const float radius = query.radius;
+
+  // How far along the sweep the centre entered the current cube. Nothing can
+  // be left before it is entered, which stops planes the sweep started on the
+  // wrong side of (because the cube bends inwards) from being left behind it.
+  float entry = 0.0f;
+
+  // The sphere moves from one cube to the next each step so it can't take
+  // more steps than there are cubes, unless it gets stuck going back and
+  // forth along a side in which case it is treated as blocked by that side.
+  uint32_t cube = query.cube;
+  for (size_t step = 0; step <= myPlanes.size(); ++step)
+  {
+    contact.cube = cube;
+    contact.fraction = entry;
+    if (!myIsValid[cube])
+    {
+      contact.side = -1;
+      return contact;
+    }
+
+    const CubePlanes& planes = myPlanes[cube];
+    const float* solid = &mySolid[cube * 12];
+
+    // Work out how far along the sweep (from 0 to 1) the centre leaves the
+    // inside of each plane, after the solid ones have been moved in by the
+    // radius.
+    float offset[12];
+    for (int i = 0; i < 12; ++i) offset[i] = -radius * solid[i];
+    float leave[12];
+    LeavePlanes(planes, from, to, offset, entry, leave);
+
+    // The centre leaves a side that bends outwards when it leaves either of
+    // its triangles, otherwise when it leaves both of them.
+    float exit = HUGE_VALF;
+    int exitSide = -1;
+    for (int side = 0; side < 6; ++side)
+    {
+      const float first = leave[side * 2];
+      const float second = leave[side * 2 + 1];
+      const float leaves = ((planes.convexSides >> side) & 1) ?
+                               std::min(first, second) :
+                               std::max(first, second);
+      if (leaves < exit)
+      {
+        exit = leaves;
+        exitSide = side;
+      }
+    }
+
+    if (exit >= 1.0f)
+    {
+      contact.fraction = 1.0f;
+      contact.side = -1;
+      contact.isBlocked = 0;
+      return contact;
+    }
+
+    contact.fraction = exit;
+    contact.side = static_cast<int8_t>(exitSide);
+    const int32_t next = myNext[cube * 6 + exitSide];
+    if (next < 0) return contact;
+
+    cube = static_cast<uint32_t>(next);
+    entry = exit;
+  }
+
+  return contact;
+}
+
+void SphereSweep::Sweep(const SweepQuery* queries, size_t count,
+                        SweepContact* contacts) const
+{
+  const size_t batches = (count + batchSize - 1) / batchSize;
+  ParallelFor(batches, [=](size_t batch, size_t)
+  {
+    const size_t end = std::min(count, (batch + 1) * batchSize);
+    for (size_t i = batch * batchSize; i < end; ++i)
+    {
+      contacts[i] = Sweep(queries[i]);
+    }
+  });
+}
@@ -0,0 +1,79 @@
+#ifndef COLLISION_HPP_GUARD
+#define COLLISION_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : SphereSweep
+// PURPOSE      : Providing where a sphere moving through a level first touches
+//                the sides of the mine.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The centre of the sphere is followed from cube to cube in the
+//                same way as LineOfSight follows a segment, moving into the
+//                next cube when it crosses a side which is open. The sphere
+//                touches a solid side when its centre comes within the radius
+//                of the plane of that side, so the solid planes are moved in
+//                by the radius and the open ones are left where they are.
+//
+//                Only the sides of the cube the centre is in are tested, like
+//                the game does, so a sphere which is wider than the opening it
+//                passes through can reach past the corner of it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "geometry.hpp"
+#include "rdl.hpp"
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+
+struct SweepQuery
+{
+  Vertex from;
+  Vertex to;
+  float radius;
+  uint32_t cube; // The cube that contains the from point.
+};
+
+struct SweepContact
+{
+  float fraction; // How far from the from point to the to point (0 to 1) the
+                  // sphere moves before it touches a side, or 1.
+  uint32_t cube; // The cube the centre of the sphere is in at that point.
+  int8_t side; // The side of that cube which it touches, or -1.
+  uint8_t isBlocked; // 1 if the sphere touched something before the end.
+};
+
+class SphereSweep
+{
+public:
+  SphereSweep(const std::vector<Cube>& cubes,
+              const std::vector<Vertex>& vertices);
+
+  SweepContact Sweep(const SweepQuery& query) const;
+  // Returns where the sphere first touches a solid side. A cube which can't
+  // be built blocks the sphere as soon as it enters it, without a side.
+
+  void Sweep(const SweepQuery* queries, size_t count,
+             SweepContact* contacts) const;
+  // Sets contacts[i] to the contact for queries[i]. The queries are split
+  // between threads.
+
+private:
+  std::vector<CubePlanes> myPlanes;
+  std::vector<uint8_t> myIsValid; // Set if the cube could be built.
+
+  // The cube through each side of each cube, or -1 if the side is solid.
+  std::vector<int32_t> myNext;
+
+  // 1 for each of the planes of each cube which is solid and 0 for the ones
+  // which are open, which is how far each of them is moved by the radius.
+  std::vector<float> mySolid;
+};
+
+#endif
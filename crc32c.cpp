@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Crc32c
+// PURPOSE      : Providing checksums for verifying the contents of archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Computes the CRC-32C (Castagnoli) checksum of data.
+//
+//                The implementation is picked the first time it is used based
+//                on what the processor supports.
+//
+//===----------------------------------------------------------------------===//
+
+#include "crc32c.hpp"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define CRC32C_HAS_SSE42 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC32C_TARGET
+#else
+#include <cpuid.h>
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#endif
+#endif
+
+// The Castagnoli polynomial in reversed bit order.
+static const uint32_t polynomial = 0x82F63B78;
+
+// The tables for processing 8 bytes at a time (slicing-by-8), table[0] is
+// the usual byte at a time table.
+struct Crc32cTables
+{
+  uint32_t table[8][256];
+
+  Crc32cTables()
+  {
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j)
+      {
+        crc = (crc & 1) ? (crc >> 1) ^ polynomial : crc >> 1;
+      }
+      table[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      for (int j = 1; j < 8; ++j)
+      {
+        table[j][i] = (table[j - 1][i] >> 8) ^ table[0][table[j - 1][i] & 0xFF];
+      }
+    }
+  }
+};
+
+static uint32_t crc32cSoftware(const uint8_t* data, size_t size, uint32_t crc)
+{
+  static const Crc32cTables tables;
+  const uint32_t(&t)[8][256] = tables.table;
+
+  for (; size >= 8; size -= 8, data += 8)
+  {
+    uint32_t low;
+    uint32_t high;
+    memcpy(&low, data, 4);
+    memcpy(&high, data + 4, 4);
+    low ^= crc;
+    crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^
+          t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^ t[3][high & 0xFF] ^
+          t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^
+          t[0][high >> 24];
+  }
+
+  for (; size > 0; --size, ++data)
+  {
+    crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+  }
+  return crc;
+}
+
+#ifdef CRC32C_HAS_SSE42
+CRC32C_TARGET
+static uint32_t crc32cHardware(const uint8_t* data, size_t size, uint32_t crc)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+  uint64_t crc64 = crc;
+  for (; size >= 8; size -= 8, data += 8)
+  {
+    uint64_t value;
+    memcpy(&value, data, 8);
+    crc64 = _mm_crc32_u64(crc64, value);
+  }
+  crc = static_cast<uint32_t>(crc64);
+#endif
+
+  for (; size >= 4; size -= 4, data += 4)
+  {
+    uint32_t value;
+    memcpy(&value, data, 4);
+    crc = _mm_crc32_u32(crc, value);
+  }
+
+  for (; size > 0; --size, ++data)
+  {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+  return crc;
+}
+
+static bool hasSse42()
+{
+#ifdef _MSC_VER
+  int registers[4];
+  __cpuid(registers, 1);
+  return (registers[2] & (1 << 20)) != 0;
+#else
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+  return (ecx & bit_SSE4_2) != 0;
+#endif
+}
+#endif
+
+typedef uint32_t (*Crc32cFunction)(const uint8_t*, size_t, uint32_t);
+
+static Crc32cFunction selectCrc32c()
+{
+#ifdef CRC32C_HAS_SSE42
+  if (hasSse42()) return crc32cHardware;
+#endif
+  return crc32cSoftware;
+}
+
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc)
+{
+  static const Crc32cFunction function = selectCrc32c();
+  return ~function(static_cast<const uint8_t*>(data), size, ~crc);
+}
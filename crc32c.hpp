@@ -0,0 +1,26 @@
+#ifndef CRC32C_HPP_GUARD
+#define CRC32C_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Crc32c
+// PURPOSE      : Providing checksums for verifying the contents of archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Computes the CRC-32C (Castagnoli) checksum of data.
+//
+//                On x86 processors with SSE 4.2 this uses the crc32
+//                instruction, otherwise it uses a table driven implementation
+//                which processes 8 bytes at a time.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0);
+// Returns the CRC-32C of size bytes of data. The crc of the previous data can
+// be passed in to continue on from it.
+
+#endif
@@ -36,6 +36,13 @@ struct Cube
   // there is no wall.
   uint8_t walls[6];
 
+  // What is special about the cube, such as being an energy centre or having
+  // a robot maker (matcen) in it, and a value for it. This is 0 if the cube is
+  // a normal cube and matcen is -1 if there is no robot maker.
+  uint8_t special;
+  int8_t matcen;
+  int16_t value;
+
   // The static lighting value for the cube.
   double lighting;
 
@@ -44,4 +51,12 @@ struct Cube
   Texture textures[6];
 };
 
+struct CubeLights
+{
+  // The light at each corner of each side, which is 1 at full brightness, in
+  // the same order as the corners in sideVertices. The sides which aren't
+  // drawn have no light so are 0.
+  float corners[6][4];
+};
+
 #endif
@@ -0,0 +1,170 @@
+#ifndef ENTRY_CACHE_HPP_GUARD
+#define ENTRY_CACHE_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : EntryCache
+// PURPOSE      : Providing a cache of what has been worked out from the files
+//                in archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The values are keyed by the name of the archive and the name
+//                of the file in it. Each value is given with how many bytes it
+//                takes up, and when the total is over the capacity of the
+//                cache the least recently used values are evicted.
+//
+//                The values are shared and can't be changed, so a value which
+//                is evicted while something is still using it stays around
+//                until it is no longer used.
+//
+//                It is safe to use from multiple threads. The cache is only
+//                locked while looking up or adding values, so two threads may
+//                both work out the same value, in which case the first one to
+//                be added is kept.
+//
+//===----------------------------------------------------------------------===//
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct CacheStatistics
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  size_t count; // The number of values in the cache.
+  size_t bytes; // The total size of the values in the cache.
+  size_t capacity;
+};
+
+template <typename Value>
+class EntryCache
+{
+public:
+  EntryCache(size_t capacity);
+  // The cache holds up to capacity bytes of values.
+
+  std::shared_ptr<const Value> Find(const std::string& archive,
+                                    const std::string& entry);
+  // Returns the value and makes it the most recently used or returns nullptr
+  // if it isn't in the cache.
+
+  std::shared_ptr<const Value> Insert(const std::string& archive,
+                                      const std::string& entry,
+                                      std::shared_ptr<const Value> value,
+                                      size_t size);
+  // Adds the value which takes up size bytes and returns it, unless the
+  // value was added in the meantime in which case that one is returned. A
+  // value that is larger than the whole cache is returned without adding it.
+
+  CacheStatistics Statistics() const;
+
+private:
+  EntryCache(const EntryCache&) = delete;
+  EntryCache& operator=(const EntryCache&) = delete;
+
+  struct Item
+  {
+    std::string key;
+    std::shared_ptr<const Value> value;
+    size_t size;
+  };
+
+  static std::string Key(const std::string& archive, const std::string& entry);
+
+  mutable std::mutex myMutex;
+
+  // The most recently used value is at the front.
+  std::list<Item> myItems;
+  std::unordered_map<std::string, typename std::list<Item>::iterator> myIndex;
+
+  size_t myCapacity;
+  size_t myBytes;
+  uint64_t myHits;
+  uint64_t myMisses;
+  uint64_t myEvictions;
+};
+
+template <typename Value>
+EntryCache<Value>::EntryCache(size_t capacity)
+: myCapacity(capacity), myBytes(0), myHits(0), myMisses(0), myEvictions(0)
+{
+}
+
+template <typename Value>
+std::string EntryCache<Value>::Key(const std::string& archive,
+                                   const std::string& entry)
+{
+  // Neither name can contain a \0 so it separates them.
+  std::string key = archive;
+  key.push_back('\0');
+  key += entry;
+  return key;
+}
+
+template <typename Value>
+std::shared_ptr<const Value> EntryCache<Value>::Find(
+  const std::string& archive, const std::string& entry)
+{
+  const std::string key = Key(archive, entry);
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  const auto found = myIndex.find(key);
+  if (found == myIndex.end())
+  {
+    ++myMisses;
+    return nullptr;
+  }
+
+  ++myHits;
+  myItems.splice(myItems.begin(), myItems, found->second);
+  return found->second->value;
+}
+
+template <typename Value>
+std::shared_ptr<const Value> EntryCache<Value>::Insert(
+  const std::string& archive, const std::string& entry,
+  std::shared_ptr<const Value> value, size_t size)
+{
+  if (size > myCapacity) return value;
+
+  const std::string key = Key(archive, entry);
+
+  std::lock_guard<std::mutex> lock(myMutex);
+  const auto found = myIndex.find(key);
+  if (found != myIndex.end()) return found->second->value;
+
+  while (myBytes + size > myCapacity)
+  {
+    const Item& oldest = myItems.back();
+    myBytes -= oldest.size;
+    myIndex.erase(oldest.key);
+    myItems.pop_back();
+    ++myEvictions;
+  }
+
+  const Item item = { key, value, size };
+  myItems.push_front(item);
+  myIndex[key] = myItems.begin();
+  myBytes += size;
+  return value;
+}
+
+template <typename Value>
+CacheStatistics EntryCache<Value>::Statistics() const
+{
+  std::lock_guard<std::mutex> lock(myMutex);
+  const CacheStatistics statistics = {
+    myHits, myMisses, myEvictions, myItems.size(), myBytes, myCapacity
+  };
+  return statistics;
+}
+
+#endif
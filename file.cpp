@@ -0,0 +1,301 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : File
+// PURPOSE      : Providing positional (offset based) access to files on disk.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A thin wrapper over the platform's file descriptors which
+//                uses 64-bit offsets throughout and reads from an explicit
+//                offset rather than relying on a shared cursor.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "file.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+
+#include <errno.h>
+
+File::File(const char* filename, Mode mode) : myDescriptor(-1)
+{
+#ifdef _WIN32
+  if (mode == Create)
+  {
+    myDescriptor = _open(filename, _O_RDWR | _O_CREAT | _O_TRUNC | _O_BINARY,
+                         _S_IREAD | _S_IWRITE);
+  }
+  else
+  {
+    myDescriptor = _open(filename, _O_RDONLY | _O_BINARY);
+  }
+#else
+  if (mode == Create)
+  {
+    myDescriptor = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  }
+  else
+  {
+    myDescriptor = open(filename, O_RDONLY);
+  }
+#endif
+}
+
+File::~File()
+{
+#ifdef _WIN32
+  if (myDescriptor != -1) _close(myDescriptor);
+#else
+  if (myDescriptor != -1) close(myDescriptor);
+#endif
+}
+
+bool File::IsValid() const
+{
+  return myDescriptor != -1;
+}
+
+uint64_t File::Size() const
+{
+  if (!IsValid()) return 0;
+
+#ifdef _WIN32
+  const __int64 size = _filelengthi64(myDescriptor);
+  return size < 0 ? 0 : static_cast<uint64_t>(size);
+#else
+  struct stat status;
+  if (fstat(myDescriptor, &status) != 0) return 0;
+  return static_cast<uint64_t>(status.st_size);
+#endif
+}
+
+bool File::ReadAt(uint64_t offset, void* buffer, size_t size) const
+{
+  if (!IsValid()) return false;
+
+  uint8_t* destination = static_cast<uint8_t*>(buffer);
+  while (size > 0)
+  {
+#ifdef _WIN32
+    // The offset is given with each read so that the position of the file,
+    // which is shared, isn't used. This makes it safe to read from a File on
+    // many threads at once as it is elsewhere.
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    const DWORD chunk =
+        size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+    DWORD count = 0;
+    if (!ReadFile(reinterpret_cast<HANDLE>(_get_osfhandle(myDescriptor)),
+                  destination, chunk, &count, &overlapped))
+    {
+      // Reading from the end of the file fails rather than reading nothing.
+      if (GetLastError() != ERROR_HANDLE_EOF) return false;
+      count = 0;
+    }
+#else
+    const ssize_t count =
+        pread(myDescriptor, destination, size, static_cast<off_t>(offset));
+    if (count < 0)
+    {
+      if (errno == EINTR) continue;
+      return false;
+    }
+#endif
+
+    // The end of the file was reached before all the data was read.
+    if (count == 0) return false;
+
+    destination += count;
+    offset += static_cast<uint64_t>(count);
+    size -= static_cast<size_t>(count);
+  }
+
+  return true;
+}
+
+bool File::WriteAt(uint64_t offset, const void* buffer, size_t size)
+{
+  if (!IsValid()) return false;
+
+  const uint8_t* source = static_cast<const uint8_t*>(buffer);
+  while (size > 0)
+  {
+#ifdef _WIN32
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    const DWORD chunk =
+        size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+    DWORD count = 0;
+    if (!WriteFile(reinterpret_cast<HANDLE>(_get_osfhandle(myDescriptor)),
+                   source, chunk, &count, &overlapped))
+    {
+      return false;
+    }
+#else
+    const ssize_t count =
+        pwrite(myDescriptor, source, size, static_cast<off_t>(offset));
+    if (count < 0)
+    {
+      if (errno == EINTR) continue;
+      return false;
+    }
+#endif
+
+    // Nothing could be written (for example the disk is full), trying again
+    // would never finish.
+    if (count == 0) return false;
+
+    source += count;
+    offset += static_cast<uint64_t>(count);
+    size -= static_cast<size_t>(count);
+  }
+
+  return true;
+}
+
+bool File::CopyFrom(const File& source, uint64_t sourceOffset,
+                    uint64_t offset, uint64_t size)
+{
+  if (!IsValid() || !source.IsValid()) return false;
+
+#if defined(__linux__)
+  while (size > 0)
+  {
+    off_t in = static_cast<off_t>(sourceOffset);
+    off_t out = static_cast<off_t>(offset);
+    const ssize_t count = copy_file_range(source.myDescriptor, &in,
+                                          myDescriptor, &out, size, 0);
+    if (count < 0 && errno == EINTR) continue;
+
+    // Not supported between these two files (for example they are on
+    // different file systems on older kernels) so copy the rest by hand.
+    if (count <= 0) break;
+
+    sourceOffset += static_cast<uint64_t>(count);
+    offset += static_cast<uint64_t>(count);
+    size -= static_cast<uint64_t>(count);
+  }
+#endif
+
+  // Fallback to reading it in and writing it out in large blocks.
+  const size_t blockSize = 1 << 20;
+  std::vector<uint8_t> block(size < blockSize ? size : blockSize);
+  while (size > 0)
+  {
+    const size_t count = size < block.size() ? size : block.size();
+    if (!source.ReadAt(sourceOffset, block.data(), count)) return false;
+    if (!WriteAt(offset, block.data(), count)) return false;
+
+    sourceOffset += count;
+    offset += count;
+    size -= count;
+  }
+
+  return true;
+}
+
+void File::Sequential() const
+{
+#if defined(POSIX_FADV_SEQUENTIAL)
+  if (IsValid()) posix_fadvise(myDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+void File::WillNeed(uint64_t offset, uint64_t size) const
+{
+#if defined(POSIX_FADV_WILLNEED)
+  if (!IsValid() || size == 0) return;
+  posix_fadvise(myDescriptor, static_cast<off_t>(offset),
+                static_cast<off_t>(size), POSIX_FADV_WILLNEED);
+#else
+  (void)offset;
+  (void)size;
+#endif
+}
+
+void File::DontNeed() const
+{
+#if defined(POSIX_FADV_DONTNEED)
+  if (IsValid()) posix_fadvise(myDescriptor, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
+int File::Descriptor() const
+{
+  return myDescriptor;
+}
+
+MappedFile::MappedFile(const char* filename) : myData(nullptr), mySize(0)
+{
+  const File file(filename);
+  const uint64_t size = file.Size();
+  if (size == 0 || size != static_cast<size_t>(size)) return;
+
+#ifdef _WIN32
+  const HANDLE handle =
+    reinterpret_cast<HANDLE>(_get_osfhandle(file.Descriptor()));
+  if (handle == INVALID_HANDLE_VALUE) return;
+
+  const HANDLE mapping =
+    CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) return;
+
+  // The view keeps the mapping open so the handle isn't needed anymore.
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!data) return;
+#else
+  // The mapping stays valid after the file is closed.
+  void* data = mmap(nullptr, static_cast<size_t>(size), PROT_READ,
+                    MAP_SHARED, file.Descriptor(), 0);
+  if (data == MAP_FAILED) return;
+#endif
+
+  myData = static_cast<const uint8_t*>(data);
+  mySize = size;
+}
+
+MappedFile::~MappedFile()
+{
+  if (!myData) return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(myData);
+#else
+  munmap(const_cast<uint8_t*>(myData), static_cast<size_t>(mySize));
+#endif
+}
+
+bool MappedFile::IsValid() const
+{
+  return myData != nullptr;
+}
+
+const uint8_t* MappedFile::Data() const
+{
+  return myData;
+}
+
+uint64_t MappedFile::Size() const
+{
+  return mySize;
+}
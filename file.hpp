@@ -0,0 +1,109 @@
+#ifndef FILE_HPP_GUARD
+#define FILE_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : File
+// PURPOSE      : Providing positional (offset based) access to files on disk.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A thin wrapper over the platform's file descriptors which
+//                uses 64-bit offsets throughout and reads from an explicit
+//                offset rather than relying on a shared cursor.
+//
+//                This means archives larger than 2 GB work on platforms where
+//                long is 32-bits and multiple readers can share the one file.
+//
+//                A MappedFile is for files which are read from in place, such
+//                as indices, rather than copied out of.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+class File
+{
+public:
+  enum Mode
+  {
+    ReadOnly,
+    Create // Creates the file or truncates it if it already exists.
+  };
+
+  File(const char* filename, Mode mode = ReadOnly);
+  ~File();
+
+  bool IsValid() const;
+  // Returns true if the file was succesfully opened.
+
+  uint64_t Size() const;
+  // Returns the size of the file in bytes.
+
+  bool ReadAt(uint64_t offset, void* buffer, size_t size) const;
+  // Reads exactly size bytes starting at offset into the buffer.
+  //
+  // Returns false if the read failed or there were fewer than size bytes.
+
+  bool WriteAt(uint64_t offset, const void* buffer, size_t size);
+  // Writes exactly size bytes from the buffer starting at offset.
+
+  bool CopyFrom(const File& source, uint64_t sourceOffset, uint64_t offset,
+                uint64_t size);
+  // Copies size bytes starting at sourceOffset in the source file to offset
+  // in this file.
+  //
+  // Where possible the copy is done by the kernel (copy_file_range) so the
+  // data does not pass through user space and may be reflinked by the file
+  // system.
+
+  void Sequential() const;
+  // Hints to the operating system that the file will be read from the start
+  // to the end so it can read ahead more aggressively.
+
+  void WillNeed(uint64_t offset, uint64_t size) const;
+  // Hints to the operating system that the given range will be read soon so
+  // it can start reading it in the background.
+
+  void DontNeed() const;
+  // Hints to the operating system that the data of the file which it has
+  // cached can be dropped, this is used to time reading from the disk.
+
+  int Descriptor() const;
+  // Returns the platform's file descriptor, for interfaces which this class
+  // doesn't wrap.
+
+private:
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  int myDescriptor;
+};
+
+class MappedFile
+{
+public:
+  MappedFile(const char* filename);
+  // Maps the whole of the file into memory so that it can be read from
+  // without copying it. The file is only read from the disk as the pages
+  // of it are used.
+
+  ~MappedFile();
+
+  bool IsValid() const;
+  // Returns true if the file was opened and mapped. An empty file can't be
+  // mapped.
+
+  const uint8_t* Data() const;
+  uint64_t Size() const;
+
+private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* myData;
+  uint64_t mySize;
+};
+
+#endif
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Geometry
+// PURPOSE      : Providing the shape of the cubes in a level.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Works out the planes and bounds of the cubes in a level.
+//
+//===----------------------------------------------------------------------===//
+
+#include "geometry.hpp"
+
+#include "cube.hpp"
+#include "rdl.hpp"
+
+#include <math.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GEOMETRY_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Vertices:
+// 0 - left, front, top
+// 1 - left, front, bottom
+// 2 - right, front, bottom
+// 3 - right, front, top
+// 4 - left, back, top
+// 5 - left, back, bottom
+// 6 - right, back, bottom
+// 7 - right, back, top
+const uint8_t sideVertices[6][4] = {
+  { 7, 6, 2, 3 }, // Right
+  { 0, 4, 7, 3 }, // Top
+  { 0, 1, 5, 4 }, // Left
+  { 2, 6, 5, 1 }, // Bottom
+  { 4, 5, 6, 7 }, // Back
+  { 3, 2, 1, 0 }, // Front
+};
+
+// Sets the plane at the given index to the one through a, b and c with the
+// normal facing towards the centre.
+static void setPlane(CubePlanes* planes, int index, const Vertex& a,
+                     const Vertex& b, const Vertex& c, const double centre[3])
+{
+  const double u[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+  const double v[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+  double n[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+                  u[0] * v[1] - u[1] * v[0] };
+
+  const double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+  if (length > 0.0)
+  {
+    n[0] /= length;
+    n[1] /= length;
+    n[2] /= length;
+  }
+
+  double d = -(n[0] * a.x + n[1] * a.y + n[2] * a.z);
+  if (n[0] * centre[0] + n[1] * centre[1] + n[2] * centre[2] + d < 0.0)
+  {
+    n[0] = -n[0];
+    n[1] = -n[1];
+    n[2] = -n[2];
+    d = -d;
+  }
+
+  planes->nx[index] = static_cast<float>(n[0]);
+  planes->ny[index] = static_cast<float>(n[1]);
+  planes->nz[index] = static_cast<float>(n[2]);
+  planes->d[index] = static_cast<float>(d);
+}
+
+CubePlanes Planes(const Cube& cube, const std::vector<Vertex>& vertices)
+{
+  double centre[3] = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < 8; ++i)
+  {
+    const Vertex& vertex = vertices[cube.vertices[i]];
+    centre[0] += vertex.x / 8;
+    centre[1] += vertex.y / 8;
+    centre[2] += vertex.z / 8;
+  }
+
+  CubePlanes planes;
+  planes.convexSides = 0;
+  for (int side = 0; side < 6; ++side)
+  {
+    const Vertex& a = vertices[cube.vertices[sideVertices[side][0]]];
+    const Vertex& b = vertices[cube.vertices[sideVertices[side][1]]];
+    const Vertex& c = vertices[cube.vertices[sideVertices[side][2]]];
+    const Vertex& d = vertices[cube.vertices[sideVertices[side][3]]];
+    setPlane(&planes, side * 2, a, b, c, centre);
+    setPlane(&planes, side * 2 + 1, a, c, d, centre);
+
+    // The side bends outwards if the corner of the second triangle that isn't
+    // on the diagonal is on the inside of the first triangle.
+    const int first = side * 2;
+    const double distance = planes.nx[first] * d.x + planes.ny[first] * d.y +
+                            planes.nz[first] * d.z + planes.d[first];
+    if (distance >= -1e-6) planes.convexSides |= 1 << side;
+  }
+  return planes;
+}
+
+Bounds CubeBounds(const Cube& cube, const std::vector<Vertex>& vertices)
+{
+  Bounds bounds;
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    bounds.min[axis] = HUGE_VALF;
+    bounds.max[axis] = -HUGE_VALF;
+  }
+
+  for (int i = 0; i < 8; ++i)
+  {
+    const Vertex& vertex = vertices[cube.vertices[i]];
+    const float position[3] = { static_cast<float>(vertex.x),
+                                static_cast<float>(vertex.y),
+                                static_cast<float>(vertex.z) };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      if (position[axis] < bounds.min[axis]) bounds.min[axis] = position[axis];
+      if (position[axis] > bounds.max[axis]) bounds.max[axis] = position[axis];
+    }
+  }
+  return bounds;
+}
+
+bool Contains(const CubePlanes& planes, float x, float y, float z,
+              float tolerance)
+{
+  // Test against every plane first, as described in geometry.hpp, giving a
+  // bit per plane which is set if the point is on the inside of it.
+  unsigned int inside = 0;
+#ifdef GEOMETRY_HAS_SSE2
+  const __m128 px = _mm_set1_ps(x);
+  const __m128 py = _mm_set1_ps(y);
+  const __m128 pz = _mm_set1_ps(z);
+  const __m128 limit = _mm_set1_ps(-tolerance);
+  for (int i = 0; i < 12; i += 4)
+  {
+    const __m128 distance = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(planes.nx + i), px),
+                              _mm_mul_ps(_mm_loadu_ps(planes.ny + i), py)),
+                   _mm_mul_ps(_mm_loadu_ps(planes.nz + i), pz)),
+        _mm_loadu_ps(planes.d + i));
+    inside |= static_cast<unsigned int>(
+                  _mm_movemask_ps(_mm_cmpge_ps(distance, limit)))
+              << i;
+  }
+#else
+  for (int i = 0; i < 12; ++i)
+  {
+    const float distance = planes.nx[i] * x + planes.ny[i] * y +
+                           planes.nz[i] * z + planes.d[i];
+    if (distance >= -tolerance) inside |= 1u << i;
+  }
+#endif
+
+  // Then combine the results for each side.
+  for (int side = 0; side < 6; ++side)
+  {
+    const bool first = (inside >> (side * 2)) & 1;
+    const bool second = (inside >> (side * 2 + 1)) & 1;
+    const bool isInside = ((planes.convexSides >> side) & 1) ?
+                              (first && second) :
+                              (first || second);
+    if (!isInside) return false;
+  }
+  return true;
+}
+
+void LeavePlanes(const CubePlanes& planes, const float from[3],
+                 const float to[3], const float offset[12], float entry,
+                 float leave[12])
+{
+#ifdef GEOMETRY_HAS_SSE2
+  const __m128 fromX = _mm_set1_ps(from[0]);
+  const __m128 fromY = _mm_set1_ps(from[1]);
+  const __m128 fromZ = _mm_set1_ps(from[2]);
+  const __m128 toX = _mm_set1_ps(to[0]);
+  const __m128 toY = _mm_set1_ps(to[1]);
+  const __m128 toZ = _mm_set1_ps(to[2]);
+  const __m128 earliest = _mm_set1_ps(entry);
+  const __m128 never = _mm_set1_ps(HUGE_VALF);
+  for (int i = 0; i < 12; i += 4)
+  {
+    const __m128 nx = _mm_loadu_ps(planes.nx + i);
+    const __m128 ny = _mm_loadu_ps(planes.ny + i);
+    const __m128 nz = _mm_loadu_ps(planes.nz + i);
+    const __m128 d =
+        _mm_add_ps(_mm_loadu_ps(planes.d + i), _mm_loadu_ps(offset + i));
+    const __m128 start = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, fromX), _mm_mul_ps(ny, fromY)),
+                   _mm_mul_ps(nz, fromZ)),
+        d);
+    const __m128 end = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, toX), _mm_mul_ps(ny, toY)),
+                   _mm_mul_ps(nz, toZ)),
+        d);
+    const __m128 change = _mm_sub_ps(start, end);
+
+    // The planes the segment doesn't leave divide by zero or a negative
+    // number here, those lanes are replaced by the blend below. The maximum
+    // gives the second operand when the first isn't a number, like the
+    // comparison in the loop below does.
+    const __m128 fraction = _mm_max_ps(_mm_div_ps(start, change), earliest);
+    const __m128 isLeaving = _mm_cmpgt_ps(change, _mm_setzero_ps());
+    _mm_storeu_ps(leave + i, _mm_or_ps(_mm_and_ps(isLeaving, fraction),
+                                       _mm_andnot_ps(isLeaving, never)));
+  }
+#else
+  for (int i = 0; i < 12; ++i)
+  {
+    const float d = planes.d[i] + offset[i];
+    const float start = planes.nx[i] * from[0] + planes.ny[i] * from[1] +
+                        planes.nz[i] * from[2] + d;
+    const float end = planes.nx[i] * to[0] + planes.ny[i] * to[1] +
+                      planes.nz[i] * to[2] + d;
+    const float change = start - end;
+    const float fraction = start / change;
+    leave[i] = change > 0.0f ?
+                 (fraction > entry ? fraction : entry) : HUGE_VALF;
+  }
+#endif
+}
@@ -0,0 +1,81 @@
+#ifndef GEOMETRY_HPP_GUARD
+#define GEOMETRY_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Geometry
+// PURPOSE      : Providing the shape of the cubes in a level.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The sides of a cube are quadrilaterals which are not always
+//                flat, so like the game each side is treated as two triangles
+//                which share the diagonal from its first to its third vertex.
+//
+//                The planes of those triangles are stored as a structure of
+//                arrays so that four planes at a time can be loaded into SSE2
+//                registers. Contains and LeavePlanes test a point or segment
+//                against all twelve planes as three groups of four, using
+//                compares and masks rather than branches, and only then
+//                combine the results for each side. Where SSE2 isn't
+//                available they do the same a plane at a time.
+//
+//                The compiler doesn't do this for the plain loops by itself,
+//                as the choice of result for each plane is a branch to it
+//                unless it may ignore floating point exceptions.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include <stdint.h>
+
+struct Cube;
+struct Vertex;
+
+// The indices into Cube::vertices for the corners of each side, the sides are
+// in the same order as Cube::neighbors.
+extern const uint8_t sideVertices[6][4];
+
+struct Bounds
+{
+  float min[3];
+  float max[3];
+};
+
+struct CubePlanes
+{
+  // The planes of the two triangles of each side, the triangles of side n are
+  // at 2n and 2n + 1. The normals face into the cube so a point is on the
+  // inside when nx * x + ny * y + nz * z + d >= 0.
+  float nx[12];
+  float ny[12];
+  float nz[12];
+  float d[12];
+
+  // A bit per side which is set if the side bends outwards (or is flat), in
+  // which case a point must be inside both triangles. Otherwise the side bends
+  // inwards and being inside either triangle is enough.
+  uint8_t convexSides;
+};
+
+CubePlanes Planes(const Cube& cube, const std::vector<Vertex>& vertices);
+// Returns the planes of the sides of the cube.
+
+Bounds CubeBounds(const Cube& cube, const std::vector<Vertex>& vertices);
+// Returns the axis aligned box around the cube.
+
+bool Contains(const CubePlanes& planes, float x, float y, float z,
+              float tolerance = 0.0f);
+// Returns true if the point is inside the cube. The tolerance is how far
+// outside of a side a point may be and still count as inside.
+
+void LeavePlanes(const CubePlanes& planes, const float from[3],
+                 const float to[3], const float offset[12], float entry,
+                 float leave[12]);
+// Works out how far along the segment from one point to the other (from 0
+// to 1) it leaves the inside of each plane, after the offset has been added
+// to the plane's d. This is never less than entry, and is HUGE_VALF for the
+// planes the segment doesn't leave.
+
+#endif
@@ -0,0 +1,309 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : CubeGraph
+// PURPOSE      : Providing path finding through the cubes of a level.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Builds the graph of cubes in compressed sparse row form and
+//                answers batches of path queries over it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "graph.hpp"
+
+#include "cube.hpp"
+#include "object.hpp"
+#include "objects.hpp"
+#include "parallel.hpp"
+#include "rdl.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include <math.h>
+
+CubeGraph::CubeGraph(const std::vector<Cube>& cubes,
+                     const std::vector<Vertex>& vertices,
+                     const std::vector<Wall>& walls, WallPolicy policy)
+: myOffsets(cubes.size() + 1), myCentres(cubes.size() * 3)
+{
+  const size_t cubeCount = cubes.size();
+  myNeighbours.reserve(cubeCount * 6);
+
+  for (size_t i = 0; i < cubeCount; ++i)
+  {
+    const Cube& cube = cubes[i];
+
+    double centre[3] = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < 8; ++j)
+    {
+      if (cube.vertices[j] >= vertices.size()) continue;
+      const Vertex& vertex = vertices[cube.vertices[j]];
+      centre[0] += vertex.x;
+      centre[1] += vertex.y;
+      centre[2] += vertex.z;
+    }
+    myCentres[i * 3 + 0] = static_cast<float>(centre[0] / 8);
+    myCentres[i * 3 + 1] = static_cast<float>(centre[1] / 8);
+    myCentres[i * 3 + 2] = static_cast<float>(centre[2] / 8);
+
+    myOffsets[i] = static_cast<uint32_t>(myNeighbours.size());
+    for (int j = 0; j < 6; ++j)
+    {
+      const int16_t neighbour = cube.neighbors[j];
+      if (neighbour < 0 || static_cast<size_t>(neighbour) >= cubeCount)
+      {
+        continue;
+      }
+
+      const uint8_t wall = cube.walls[j];
+      if (policy == BlockWalls && wall != 255 &&
+          (wall >= walls.size() || !CanFlyThrough(walls[wall])))
+      {
+        continue;
+      }
+
+      myNeighbours.push_back(static_cast<uint32_t>(neighbour));
+    }
+  }
+  myOffsets[cubeCount] = static_cast<uint32_t>(myNeighbours.size());
+
+  // The centres are needed for the weights so they are worked out after.
+  myWeights.resize(myNeighbours.size());
+  for (uint32_t i = 0; i < cubeCount; ++i)
+  {
+    for (uint32_t j = myOffsets[i]; j < myOffsets[i + 1]; ++j)
+    {
+      myWeights[j] = Distance(i, myNeighbours[j]);
+    }
+  }
+}
+
+size_t CubeGraph::CubeCount() const
+{
+  return myOffsets.size() - 1;
+}
+
+const uint32_t* CubeGraph::NeighboursBegin(uint32_t cube) const
+{
+  return myNeighbours.data() + myOffsets[cube];
+}
+
+const uint32_t* CubeGraph::NeighboursEnd(uint32_t cube) const
+{
+  return myNeighbours.data() + myOffsets[cube + 1];
+}
+
+const float* CubeGraph::WeightsBegin(uint32_t cube) const
+{
+  return myWeights.data() + myOffsets[cube];
+}
+
+float CubeGraph::Distance(uint32_t from, uint32_t to) const
+{
+  const float* const a = &myCentres[from * 3];
+  const float* const b = &myCentres[to * 3];
+  const float x = a[0] - b[0];
+  const float y = a[1] - b[1];
+  const float z = a[2] - b[2];
+  return sqrtf(x * x + y * y + z * z);
+}
+
+namespace
+{
+  // The working space of a search. Rather than clearing the arrays between
+  // searches each entry is stamped with the search it was written by.
+  struct SearchState
+  {
+    std::vector<uint32_t> visited;
+    std::vector<uint32_t> wanted;
+    std::vector<uint32_t> parent;
+    std::vector<float> cost;
+    std::vector<uint32_t> queue;
+    uint32_t generation;
+
+    SearchState() : generation(0)
+    {
+    }
+
+    void Begin(size_t cubeCount)
+    {
+      if (visited.size() != cubeCount)
+      {
+        visited.assign(cubeCount, 0);
+        wanted.assign(cubeCount, 0);
+        parent.resize(cubeCount);
+        cost.resize(cubeCount);
+        generation = 0;
+      }
+
+      if (++generation == 0)
+      {
+        std::fill(visited.begin(), visited.end(), 0);
+        std::fill(wanted.begin(), wanted.end(), 0);
+        generation = 1;
+      }
+    }
+  };
+}
+
+std::vector<uint32_t> BreadthFirst(const CubeGraph& graph,
+                                   const std::vector<PathQuery>& queries)
+{
+  std::vector<uint32_t> hops(queries.size(), unreachableHops);
+  const size_t cubeCount = graph.CubeCount();
+
+  // Group the queries by their source so each group needs one search.
+  std::vector<uint32_t> order(queries.size());
+  for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&queries](uint32_t a, uint32_t b)
+  { return queries[a].source < queries[b].source; });
+
+  std::vector<size_t> groups;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    if (i == 0 || queries[order[i]].source != queries[order[i - 1]].source)
+    {
+      groups.push_back(i);
+    }
+  }
+  groups.push_back(order.size());
+
+  std::vector<SearchState> states(ThreadCount());
+  ParallelFor(groups.size() - 1, [&](size_t group, size_t thread)
+  {
+    const uint32_t source = queries[order[groups[group]]].source;
+    if (source >= cubeCount) return;
+
+    SearchState& state = states[thread];
+    state.Begin(cubeCount);
+    const uint32_t generation = state.generation;
+
+    // Mark the targets so the search can stop once they are all found.
+    size_t remaining = 0;
+    for (size_t i = groups[group]; i < groups[group + 1]; ++i)
+    {
+      const uint32_t target = queries[order[i]].target;
+      if (target < cubeCount && state.wanted[target] != generation)
+      {
+        state.wanted[target] = generation;
+        ++remaining;
+      }
+    }
+
+    // The cost holds the number of hops for the breadth first search.
+    state.queue.clear();
+    state.queue.push_back(source);
+    state.visited[source] = generation;
+    state.cost[source] = 0;
+    for (size_t head = 0; head < state.queue.size() && remaining > 0; ++head)
+    {
+      const uint32_t cube = state.queue[head];
+      if (state.wanted[cube] == generation) --remaining;
+
+      for (const uint32_t* neighbour = graph.NeighboursBegin(cube),
+                         * end = graph.NeighboursEnd(cube);
+           neighbour != end; ++neighbour)
+      {
+        if (state.visited[*neighbour] == generation) continue;
+        state.visited[*neighbour] = generation;
+        state.cost[*neighbour] = state.cost[cube] + 1;
+        state.queue.push_back(*neighbour);
+      }
+    }
+
+    for (size_t i = groups[group]; i < groups[group + 1]; ++i)
+    {
+      const uint32_t target = queries[order[i]].target;
+      if (target < cubeCount && state.visited[target] == generation)
+      {
+        hops[order[i]] = static_cast<uint32_t>(state.cost[target]);
+      }
+    }
+  });
+
+  return hops;
+}
+
+std::vector<float> AStar(const CubeGraph& graph,
+                         const std::vector<PathQuery>& queries,
+                         std::vector<std::vector<uint32_t>>* paths)
+{
+  std::vector<float> distances(queries.size(), unreachableDistance);
+  if (paths) paths->assign(queries.size(), std::vector<uint32_t>());
+  const size_t cubeCount = graph.CubeCount();
+
+  typedef std::pair<float, uint32_t> Node; // The estimate and the cube.
+  typedef std::priority_queue<Node, std::vector<Node>, std::greater<Node>>
+      OpenSet;
+
+  std::vector<SearchState> states(ThreadCount());
+  ParallelFor(queries.size(), [&](size_t index, size_t thread)
+  {
+    const PathQuery& query = queries[index];
+    if (query.source >= cubeCount || query.target >= cubeCount) return;
+
+    SearchState& state = states[thread];
+    state.Begin(cubeCount);
+    const uint32_t generation = state.generation;
+
+    // The visited stamp means the cost of the cube is known and the wanted
+    // stamp means it is final (the cube is closed).
+    OpenSet open;
+    state.visited[query.source] = generation;
+    state.cost[query.source] = 0.0f;
+    state.parent[query.source] = query.source;
+    open.push(Node(graph.Distance(query.source, query.target), query.source));
+
+    while (!open.empty())
+    {
+      const uint32_t cube = open.top().second;
+      open.pop();
+
+      if (state.wanted[cube] == generation) continue; // Already closed.
+      state.wanted[cube] = generation;
+
+      if (cube == query.target) break;
+
+      const float* weight = graph.WeightsBegin(cube);
+      for (const uint32_t* neighbour = graph.NeighboursBegin(cube),
+                         * end = graph.NeighboursEnd(cube);
+           neighbour != end; ++neighbour, ++weight)
+      {
+        const float cost = state.cost[cube] + *weight;
+        if (state.visited[*neighbour] == generation &&
+            state.cost[*neighbour] <= cost)
+        {
+          continue;
+        }
+
+        state.visited[*neighbour] = generation;
+        state.cost[*neighbour] = cost;
+        state.parent[*neighbour] = cube;
+        open.push(
+            Node(cost + graph.Distance(*neighbour, query.target), *neighbour));
+      }
+    }
+
+    if (state.wanted[query.target] != generation) return;
+    distances[index] = state.cost[query.target];
+
+    if (paths)
+    {
+      std::vector<uint32_t>& path = (*paths)[index];
+      for (uint32_t cube = query.target; cube != query.source;
+           cube = state.parent[cube])
+      {
+        path.push_back(cube);
+      }
+      path.push_back(query.source);
+      std::reverse(path.begin(), path.end());
+    }
+  });
+
+  return distances;
+}
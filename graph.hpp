@@ -0,0 +1,96 @@
+#ifndef GRAPH_HPP_GUARD
+#define GRAPH_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : CubeGraph
+// PURPOSE      : Providing path finding through the cubes of a level.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The cubes of a level and the sides they share form a graph.
+//                This stores that graph in compressed sparse row form, where
+//                the neighbours of every cube are stored one after the other
+//                in a single array and each cube has the offset to where its
+//                neighbours start.
+//
+//                Each edge is weighted by the distance between the centres of
+//                the two cubes, so the A* search can use the straight line
+//                distance between the centres as its heuristic.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+struct Vertex;
+struct Wall;
+
+class CubeGraph
+{
+public:
+  enum WallPolicy
+  {
+    IgnoreWalls, // Any side that is shared with another cube can be passed.
+    BlockWalls // Sides with a wall that can't be flown through can't be
+               // passed, see CanFlyThrough().
+  };
+
+  CubeGraph(const std::vector<Cube>& cubes,
+            const std::vector<Vertex>& vertices,
+            const std::vector<Wall>& walls, WallPolicy policy = BlockWalls);
+  // The walls are those of the level, which Cube::walls are the indices of.
+  // A side whose wall isn't one of them is treated as blocked.
+
+  size_t CubeCount() const;
+
+  const uint32_t* NeighboursBegin(uint32_t cube) const;
+  const uint32_t* NeighboursEnd(uint32_t cube) const;
+  // The cubes which can be reached from the given cube.
+
+  const float* WeightsBegin(uint32_t cube) const;
+  // The distance to each neighbour, in the same order as the neighbours.
+
+  float Distance(uint32_t from, uint32_t to) const;
+  // Returns the straight line distance between the centres of two cubes.
+
+private:
+  std::vector<uint32_t> myOffsets; // The first neighbour of each cube.
+  std::vector<uint32_t> myNeighbours;
+  std::vector<float> myWeights;
+  std::vector<float> myCentres; // The x, y and z of the centre of each cube.
+};
+
+struct PathQuery
+{
+  uint32_t source;
+  uint32_t target;
+};
+
+// The result of a query when there is no way to get from the source to the
+// target.
+const uint32_t unreachableHops = UINT32_MAX;
+const float unreachableDistance = -1.0f;
+
+std::vector<uint32_t> BreadthFirst(const CubeGraph& graph,
+                                   const std::vector<PathQuery>& queries);
+// Returns the fewest number of sides which need to be passed through to get
+// from the source to the target of each query.
+//
+// Queries which share the same source are answered by the same search and the
+// searches are run in parallel.
+
+std::vector<float> AStar(const CubeGraph& graph,
+                         const std::vector<PathQuery>& queries,
+                         std::vector<std::vector<uint32_t>>* paths = nullptr);
+// Returns the length of the shortest path (going between the centres of the
+// cubes) from the source to the target of each query.
+//
+// If paths is given then it is filled with the cubes on each path starting
+// with the source and ending with the target. The queries are run in
+// parallel.
+
+#endif
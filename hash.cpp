@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Hash
+// PURPOSE      : Providing a fast non-cryptographic hash of file contents.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : An implementation of the 64-bit xxHash algorithm (XXH64).
+//
+//                The input is consumed in 32-byte stripes by four independent
+//                accumulators, which keeps several multiplies in flight at
+//                once, then the remaining tail is mixed in and the result is
+//                avalanched.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hash.hpp"
+
+#include <string.h>
+
+static const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t prime3 = 0x165667B19E3779F9ULL;
+static const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotateLeft(uint64_t value, int bits)
+{
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// The format is little endian, like the rest of the Descent file formats this
+// assumes the host is as well.
+static inline uint64_t read64(const uint8_t* data)
+{
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static inline uint32_t read32(const uint8_t* data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static inline uint64_t round(uint64_t accumulator, uint64_t input)
+{
+  accumulator += input * prime2;
+  accumulator = rotateLeft(accumulator, 31);
+  return accumulator * prime1;
+}
+
+static inline uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+{
+  accumulator ^= round(0, value);
+  return accumulator * prime1 + prime4;
+}
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed)
+{
+  const uint8_t* input = static_cast<const uint8_t*>(data);
+  const uint8_t* const end = input + size;
+  uint64_t hash;
+
+  if (size >= 32)
+  {
+    const uint8_t* const limit = end - 32;
+    uint64_t v1 = seed + prime1 + prime2;
+    uint64_t v2 = seed + prime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - prime1;
+
+    do
+    {
+      v1 = round(v1, read64(input));
+      v2 = round(v2, read64(input + 8));
+      v3 = round(v3, read64(input + 16));
+      v4 = round(v4, read64(input + 24));
+      input += 32;
+    } while (input <= limit);
+
+    hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) +
+           rotateLeft(v4, 18);
+    hash = mergeRound(hash, v1);
+    hash = mergeRound(hash, v2);
+    hash = mergeRound(hash, v3);
+    hash = mergeRound(hash, v4);
+  }
+  else
+  {
+    hash = seed + prime5;
+  }
+
+  hash += static_cast<uint64_t>(size);
+
+  for (; input + 8 <= end; input += 8)
+  {
+    hash ^= round(0, read64(input));
+    hash = rotateLeft(hash, 27) * prime1 + prime4;
+  }
+
+  if (input + 4 <= end)
+  {
+    hash ^= static_cast<uint64_t>(read32(input)) * prime1;
+    hash = rotateLeft(hash, 23) * prime2 + prime3;
+    input += 4;
+  }
+
+  for (; input < end; ++input)
+  {
+    hash ^= (*input) * prime5;
+    hash = rotateLeft(hash, 11) * prime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= prime2;
+  hash ^= hash >> 29;
+  hash *= prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
@@ -0,0 +1,24 @@
+#ifndef HASH_HPP_GUARD
+#define HASH_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Hash
+// PURPOSE      : Providing a fast non-cryptographic hash of file contents.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : An implementation of the 64-bit xxHash algorithm (XXH64) by
+//                Yann Collet. This is used to detect whether the contents of a
+//                file in an archive have changed, it is not suitable for
+//                anything security related.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+// Returns the XXH64 hash of size bytes of data.
+
+#endif
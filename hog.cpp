@@ -35,36 +35,85 @@
 //
 /////
 
+#include "bbm.hpp"
+#include "benchmark.hpp"
 #include "cube.hpp"
+#include "hash.hpp"
 #include "hogiterator.hpp"
 #include "hogreader.hpp"
+#include "hogwriter.hpp"
+#include "image.hpp"
+#include "levelcache.hpp"
+#include "levelcheck.hpp"
+#include "leveldiff.hpp"
+#include "levelpack.hpp"
+#include "lightbake.hpp"
+#include "manifest.hpp"
+#include "object.hpp"
+#include "objects.hpp"
+#include "parallel.hpp"
+#include "pcx.hpp"
+#include "ply.hpp"
+#include "png.hpp"
+#include "prefetch.hpp"
+#include "pvs.hpp"
+#include "quads.hpp"
+#include "render.hpp"
 #include "rdl.hpp"
+#include "server.hpp"
+#include "tarwriter.hpp"
+#include "textindex.hpp"
+#include "texturetable.hpp"
 #include "txbiterator.hpp"
 #include "txbreader.hpp"
+#include "verify.hpp"
 
+#include <chrono>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <iterator>
+#include <sstream>
 #include <utility>
 #include <vector>
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 #include <assert.h>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#ifdef _MSC_VER
-static_assert(sizeof(uint8_t) == 1,
-              "The size of uint8_t is incorrect it must be 1-byte");
-static_assert(sizeof(uint32_t) == 4,
-              "The size of uint32_t is incorrect it must be 4-bytes");
-static_assert(sizeof(uint8_t) == sizeof(char),
-              "The size of a char must be 1-byte");
-#endif
+// The name of the manifest written next to the exported files when exporting
+// incrementally.
+static const char* const manifestFilename = "hog.manifest";
+
+// The version of each exporter, these should be changed when the output of
+// the exporter changes so the files will be exported again.
+static const char* const plyExporter = "ply-2";
+static const char* const textExporter = "txt-1";
+static const char* const rawExporter = "raw-1";
+static const char* const pvsExporter = "pvs-1";
+static const char* const fastPvsExporter = "pvs-fast-1";
+static const char* const pngExporter = "png-1";
+static const char* const thumbnailExporter = "thumbnail-1";
+
+// The width and height of the thumbnails of the levels.
+static const uint32_t thumbnailSize = 256;
+
+// The number of files which are read ahead of the file being decoded.
+static const size_t prefetchDepth = 16;
 
-// The 3-byte MAGIC number at the start of the file format used to identifiy the
-// file as being a Descent HOG file.
-static uint8_t magic[3] = { 'D', 'H', 'F' };
+// The number of bytes of decoded levels which are kept in memory.
+static const size_t levelCacheSize = 256 * 1024 * 1024;
+
+// The number of bytes of exported levels which the server keeps.
+static const size_t exportCacheSize = 64 * 1024 * 1024;
 
 void ExtractTxb(const TxbReader& Reader,
                 const std::string& Name,
@@ -73,327 +122,1041 @@ void ExtractTxb(const TxbReader& Reader,
   std::copy(Reader.begin(), Reader.end(), std::ostream_iterator<char>(Output));
 }
 
-HogReader::iterator HogReader::begin()
+// Returns the extension of the name in lower case, including the dot.
+static std::string LowerExtension(const std::string& Name)
 {
-  // Sync back up to the start just after the magic number.
-  if (IsValid())
+  const size_t dot = Name.rfind('.');
+  if (dot == std::string::npos) return std::string();
+
+  std::string extension = Name.substr(dot);
+  for (auto c = extension.begin(); c != extension.end(); ++c)
   {
-    fseek(myFile, sizeof(magic), SEEK_SET);
-    if (fread(&myChildFile.name, 13, 1, myFile) != 1) HogReaderIterator();
-    if (fread(&myChildFile.size, 4, 1, myFile) != 1) HogReaderIterator();
+    *c = static_cast<char>(tolower(*c));
   }
-
-  return HogReaderIterator(*this);
+  return extension;
 }
 
-HogReader::iterator HogReader::end()
+static bool IsImageName(const std::string& Name)
 {
-  return HogReaderIterator();
+  const std::string extension = LowerExtension(Name);
+  return extension == ".pcx" || extension == ".bbm" || extension == ".lbm" ||
+         extension == ".256";
 }
 
-HogReader::HogReader(const char* filename) : myFile(nullptr), hasReadFile(false)
+// Decodes a PCX or BBM image, or a palette which becomes an image with a
+// pixel for each colour.
+static bool DecodeImage(const std::string& Name,
+                        const std::vector<uint8_t>& Data,
+                        Image* Output)
 {
-  myFile = fopen(filename, "rb");
-  myChildFile.name[0] = '\0';
-  myChildFile.size = 0;
-  if (!myFile) return;
-
-  const size_t count = 1;
-  if (fread(myHeader, sizeof(myHeader), count, myFile) != count)
+  const std::string extension = LowerExtension(Name);
+  if (extension == ".pcx")
   {
-    myHeader[0] = '\0'; // Failed to load.
-    return;
+    return PcxReader(Data.data(), Data.size()).Decode(Output);
   }
-
-  // Read in the header for the first file.
-  if (IsValid())
+  else if (extension == ".bbm" || extension == ".lbm")
+  {
+    return BbmReader(Data.data(), Data.size()).Decode(Output);
+  }
+  else if (extension == ".256")
   {
-    if (fread(&myChildFile.name, 13, 1, myFile) != 1) return;
-    if (fread(&myChildFile.size, 4, 1, myFile) != 1) return;
+    Palette palette;
+    if (!ReadPalette(Data.data(), Data.size(), &palette)) return false;
+    *Output = PaletteImage(palette);
+    return true;
   }
+  return false;
 }
 
-HogReader::~HogReader()
-{
-  if (myFile) fclose(myFile);
-}
+#include <algorithm>
+#include <iostream>
+#include <string>
 
-bool HogReader::IsValid() const
+int main(int argc, char* argv[])
 {
-  if (!myFile) return false;
-  return memcmp(myHeader, magic, 3) == 0;
-}
+  if (argc < 2)
+  {
+    printf("usage: %s [-d -l -p -a -t -x] [-i | -o output.tar] filename\n",
+           argv[0]);
+    printf("       %s -g filename\n", argv[0]);
+    printf("       %s -m [-i | -o output.tar] filename\n", argv[0]);
+    printf("       %s -n [-i | -o output.tar] filename\n", argv[0]);
+    printf("       %s -s [-f] [-i | -o output.tar] filename\n", argv[0]);
+    printf("       %s -c output.hog file...\n", argv[0]);
+    printf("       %s -r input.hog output.hog [alignment]\n", argv[0]);
+    printf("       %s -z input.hog output.hog\n", argv[0]);
+    printf("       %s -h pack filename\n", argv[0]);
+    printf("       %s -v filename [checksums.txt]\n", argv[0]);
+    printf("       %s -b collision|decode|locate|path|prefetch|sight "
+           "filename\n", argv[0]);
+    printf("       %s -b server filename socket\n", argv[0]);
+    printf("       %s -b pack filename pack\n", argv[0]);
+    printf("       %s -u socket filename...\n", argv[0]);
+    printf("       %s -k index filename...\n", argv[0]);
+    printf("       %s -q index word...\n", argv[0]);
+    printf("       %s -e table filename...\n", argv[0]);
+    printf("       %s -j table histogram|unused [count]|uses texture\n",
+           argv[0]);
+    printf("       %s -w before.hog after.hog\n", argv[0]);
+    printf("       %s -w before.rdl after.rdl\n", argv[0]);
+    printf("       %s -y filename...\n", argv[0]);
+    return 1;
+  }
 
-bool HogReader::NextFile()
-{
-  // Skip the current file.
-  if (feof(myFile)) return false;
+  enum Mode
+  {
+    ListAllFiles,
+    ExportToPly,
+    ExportAllToPly,
+    ExportAllText,
+    ExtractAll, // This extracts it as-is no decoding.
+    ListObjects, // Lists the objects in each cube of each level.
+    ExportAllImages, // Converts the images and palettes to PNG.
+    ExportAllThumbnails, // Draws pictures of each level.
+    ExportAllVisibility, // Works out which cubes can be seen from each cube.
+    Create, // Creates a new archive from files on disk.
+    Repack, // Copies the files to a new archive, optionally aligning them.
+    Compress, // Copies the files to a new archive, compressing each of them.
+    BuildLevelPack, // Decodes the levels into a pack which is used in place.
+    Verify, // Checks the layout and the checksums of the files.
+    Benchmark, // Times queries on the levels.
+    Serve, // Answers requests about the archives over a socket.
+    BuildTextIndex, // Indexes the words of the briefings of the archives.
+    SearchText, // Finds where words are in the briefings using the index.
+    BuildTextureTable, // Tabulates the textures of the levels of archives.
+    QueryTextures, // Answers questions about the textures using the table.
+    DiffArchives, // Lists the changes to the levels between two archives,
+                  // or between two levels.
+    CheckLevels, // Checks the parts of each level agree with each other.
+    Debug // Performs some other task during development.
+  };
 
-  if (!hasReadFile)
+  Mode mode = ExportToPly;
+  bool incremental = false; // Skip files which haven't changed since last time.
+  const char* tarFilename = nullptr; // Write the files into a tar archive.
+  const char* benchmark = nullptr; // The name of the benchmark to run.
+  const char* socketPath = nullptr; // Where the server listens.
+  const char* indexFilename = nullptr; // The index of the briefings.
+  const char* tableFilename = nullptr; // The table of the textures.
+  const char* packFilename = nullptr; // The pack of decoded levels.
+  bool fastVisibility = false; // Use the conservative fast mode for the PVS.
+  std::vector<const char*> arguments;
+
+  // Command line option parsing
+  for (int i = 1; i < argc; ++i)
   {
-    // The data for the current file has not been read so skip over the data
-    // section
-    // for the file.
+    if (argv[i][0] != '-')
+    {
+      arguments.push_back(argv[i]);
+      continue;
+    }
 
-    if (fseek(myFile, static_cast<long>(myChildFile.size), SEEK_CUR) != 0)
+    const char option = argv[i][1];
+    switch (option)
     {
-      return false;
+    default:
+      fprintf(stderr, "error unsupported option provided (%c)", option);
+      return 1;
+    case '\0':
+      fprintf(stderr, "error option specifier - provided but no option");
+      return 1;
+    case 'd':
+      mode = Debug;
+      break;
+    case 'l':
+      mode = ListAllFiles;
+      break;
+    case 'p':
+      mode = ExportToPly;
+      break;
+    case 'a':
+      mode = ExportAllToPly;
+      break;
+    case 't':
+      mode = ExportAllText;
+      break;
+    case 'x':
+      mode = ExtractAll;
+      break;
+    case 'g':
+      mode = ListObjects;
+      break;
+    case 'm':
+      mode = ExportAllImages;
+      break;
+    case 'n':
+      mode = ExportAllThumbnails;
+      break;
+    case 's':
+      mode = ExportAllVisibility;
+      break;
+    case 'f':
+      fastVisibility = true;
+      break;
+    case 'c':
+      mode = Create;
+      break;
+    case 'r':
+      mode = Repack;
+      break;
+    case 'v':
+      mode = Verify;
+      break;
+    case 'z':
+      mode = Compress;
+      break;
+    case 'h':
+      if (i + 1 == argc)
+      {
+        fprintf(stderr, "error no filename provided for the level pack");
+        return 1;
+      }
+      mode = BuildLevelPack;
+      packFilename = argv[++i];
+      break;
+    case 'b':
+      if (i + 1 == argc)
+      {
+        fprintf(stderr, "error no benchmark provided");
+        return 1;
+      }
+      mode = Benchmark;
+      benchmark = argv[++i];
+      break;
+    case 'u':
+      if (i + 1 == argc)
+      {
+        fprintf(stderr, "error no path provided for the socket");
+        return 1;
+      }
+      mode = Serve;
+      socketPath = argv[++i];
+      break;
+    case 'k':
+    case 'q':
+      if (i + 1 == argc)
+      {
+        fprintf(stderr, "error no filename provided for the index");
+        return 1;
+      }
+      mode = option == 'k' ? BuildTextIndex : SearchText;
+      indexFilename = argv[++i];
+      break;
+    case 'e':
+    case 'j':
+      if (i + 1 == argc)
+      {
+        fprintf(stderr, "error no filename provided for the texture table");
+        return 1;
+      }
+      mode = option == 'e' ? BuildTextureTable : QueryTextures;
+      tableFilename = argv[++i];
+      break;
+    case 'w':
+      mode = DiffArchives;
+      break;
+    case 'y':
+      mode = CheckLevels;
+      break;
+    case 'i':
+      incremental = true;
+      break;
+    case 'o':
+      if (i + 1 == argc)
+      {
+        fprintf(stderr, "error no filename provided for the tar archive");
+        return 1;
+      }
+      tarFilename = argv[++i];
+      break;
     }
   }
 
-  // Read in the header for the next file.
-  if (fread(&myChildFile.name, 13, 1, myFile) != 1) return false;
-  if (fread(&myChildFile.size, 4, 1, myFile) != 1) return false;
+  if (arguments.empty())
+  {
+    fprintf(stderr, "option provided but no filename");
+    return 1;
+  }
 
-  hasReadFile = false; // We haven't read the next file yet.
-  return true;
-}
+  if (mode == Create)
+  {
+    HogWriter writer(arguments.front());
+    if (!writer.IsValid())
+    {
+      fprintf(stderr, "error unable to create the hog file");
+      return 1;
+    }
 
-const char* HogReader::CurrentFileName() const
-{
-  return myChildFile.name;
-}
+    for (auto path = arguments.begin() + 1; path != arguments.end(); ++path)
+    {
+      // The name of the file in the archive is the name without the path.
+      const char* name = *path;
+      for (const char* c = *path; *c; ++c)
+      {
+        if (*c == '/' || *c == '\\') name = c + 1;
+      }
+
+      std::cout << "Adding " << name << std::endl;
+      if (!writer.AddFileFromDisk(name, *path))
+      {
+        fprintf(stderr, "error unable to add %s", *path);
+        return 1;
+      }
+    }
+    return 0;
+  }
 
-unsigned int HogReader::CurrentFileSize() const
-{
-  return myChildFile.size;
-}
+  if (mode == Serve)
+  {
+    // The server is asked for the same levels again and again, so it keeps
+    // the ones it has decoded.
+    LevelCache levels(levelCacheSize);
+    HogServer server(levels, exportCacheSize);
+    for (auto path = arguments.begin(); path != arguments.end(); ++path)
+    {
+      if (!server.AddArchive(*path))
+      {
+        fprintf(stderr, "error unable to open %s", *path);
+        return 1;
+      }
+    }
 
-std::vector<uint8_t> HogReader::CurrentFile()
-{
-  std::vector<uint8_t> fileData;
+    if (!server.Serve(socketPath))
+    {
+      fprintf(stderr, "error unable to listen on %s", socketPath);
+      return 1;
+    }
+    return 0;
+  }
 
-  // TODO: Allow this to seek-back and read it again.
-  //
-  // For now ensure the current file hasn't been read yet.
-  assert(!hasReadFile);
+  if (mode == BuildTextIndex)
+  {
+    struct Briefing
+    {
+      const char* archive;
+      std::string name;
+      std::vector<uint8_t> data;
+      std::string text;
+    };
+
+    std::vector<Briefing> briefings;
+    for (auto path = arguments.begin(); path != arguments.end(); ++path)
+    {
+      HogReader reader(*path);
+      if (!reader.IsValid())
+      {
+        fprintf(stderr, "error unable to open %s", *path);
+        return 1;
+      }
+
+      for (auto file = reader.begin(), end = reader.end(); file != end;
+           ++file)
+      {
+        if (LowerExtension(file->name) != ".txb") continue;
+
+        Briefing briefing;
+        briefing.archive = *path;
+        briefing.name = file->name;
+        briefing.data = file.FileContents();
+        briefings.push_back(briefing);
+      }
+    }
 
-  // Skip the current file.
-  if (feof(myFile)) return fileData;
+    ParallelFor(briefings.size(), [&briefings](size_t i, size_t)
+    {
+      const TxbReader txbReader(briefings[i].data);
+      briefings[i].text.assign(txbReader.begin(), txbReader.end());
+    });
 
-  const unsigned int size = CurrentFileSize(); // Size in bytes
-  fileData.resize(size);
+    TextIndexBuilder builder;
+    for (auto briefing = briefings.begin(); briefing != briefings.end();
+         ++briefing)
+    {
+      builder.Add(briefing->archive, briefing->name, briefing->text);
+    }
 
-  if (fread(fileData.data(), size, 1, myFile) != 1)
-  {
-    fileData.clear();
+    if (!builder.Write(indexFilename))
+    {
+      fprintf(stderr, "error unable to write the index");
+      return 1;
+    }
+    printf("Indexed %zd briefings\n", briefings.size());
+    return 0;
   }
-  else
+
+  if (mode == SearchText)
   {
-    hasReadFile = true;
+    const TextIndex index(indexFilename);
+    if (!index.IsValid())
+    {
+      fprintf(stderr, "error unable to read the index");
+      return 1;
+    }
+
+    std::string query;
+    for (auto word = arguments.begin(); word != arguments.end(); ++word)
+    {
+      query += *word;
+      query += ' ';
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto matches = index.Search(query);
+    const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+    for (auto match = matches.begin(); match != matches.end(); ++match)
+    {
+      printf("%s %s %u\n", match->archive.c_str(), match->entry.c_str(),
+             match->offset);
+    }
+    fprintf(stderr, "%zd matches in %.3f ms\n", matches.size(),
+            elapsed.count());
+    return 0;
   }
 
-  return fileData;
-}
+  if (mode == BuildTextureTable)
+  {
+    struct Level
+    {
+      const char* archive;
+      std::string name;
+      std::vector<uint8_t> data;
+    };
 
-#include <algorithm>
-#include <iostream>
-#include <string>
+    std::vector<Level> levelFiles;
+    for (auto path = arguments.begin(); path != arguments.end(); ++path)
+    {
+      HogReader reader(*path);
+      if (!reader.IsValid())
+      {
+        fprintf(stderr, "error unable to open %s", *path);
+        return 1;
+      }
+
+      for (auto file = reader.begin(), end = reader.end(); file != end;
+           ++file)
+      {
+        if (!IsLevelName(file->name)) continue;
+
+        Level level;
+        level.archive = *path;
+        level.name = file->name;
+        level.data = file.FileContents();
+        levelFiles.push_back(level);
+      }
+    }
 
-struct Quad
-{
-  size_t a;
-  size_t b;
-  size_t c;
-  size_t d;
-};
+    // Each level is put in a table of its own, then they are put together in
+    // the order of the levels so the table doesn't depend on the timing.
+    std::vector<TextureTable> tables(levelFiles.size());
+    ParallelFor(levelFiles.size(), [&levelFiles, &tables](size_t i, size_t)
+    {
+      const Level& level = levelFiles[i];
+      const uint32_t index = tables[i].AddLevel(level.archive, level.name);
+      const RdlReader rdlReader(level.data);
+      if (rdlReader.IsValid()) tables[i].AddCubes(index, rdlReader.Cubes());
+    });
 
-void Quads(const Cube& cube, std::vector<Quad>* quads)
-{
-  const uint16_t* const vertices = cube.vertices;
-
-  // Vertices:
-  // 0 - left, front, top
-  // 1 - left, front, bottom
-  // 2 - right, front, bottom
-  // 3 - right, front, top
-  // 4 - left, back, top
-  // 5 - left, back, bottom
-  // 6 - right, back, bottom
-  // 7 - right, back, top
-
-  // Neighbours:
-  enum Neighbour
-  {
-    Right,
-    Top,
-    Left,
-    Bottom,
-    Back,
-    Front
-  };
+    TextureTable table;
+    for (auto levelTable = tables.begin(); levelTable != tables.end();
+         ++levelTable)
+    {
+      table.Append(*levelTable);
+    }
 
-  if (cube.neighbors[Right] == -1)
-  {
-    const Quad quad = { vertices[2], vertices[3], vertices[7], vertices[6] };
-    quads->push_back(quad);
+    std::ofstream output(tableFilename, std::ios::binary);
+    if (!table.Write(output))
+    {
+      fprintf(stderr, "error unable to write the texture table");
+      return 1;
+    }
+    printf("Tabulated %zd sides of %zd levels\n", table.RowCount(),
+           levelFiles.size());
+    return 0;
   }
 
-  if (cube.neighbors[Top] == -1)
+  if (mode == QueryTextures)
   {
-    const Quad quad = { vertices[0], vertices[3], vertices[7], vertices[4] };
-    quads->push_back(quad);
-  }
+    TextureTable table;
+    std::ifstream input(tableFilename, std::ios::binary);
+    if (!table.Read(input))
+    {
+      fprintf(stderr, "error unable to read the texture table");
+      return 1;
+    }
 
-  if (cube.neighbors[Left] == -1)
-  {
-    const Quad quad = { vertices[0], vertices[1], vertices[5], vertices[4] };
-    quads->push_back(quad);
+    const std::string query = arguments.front();
+    if (query == "histogram")
+    {
+      const auto usages = table.Histogram();
+      for (auto usage = usages.begin(); usage != usages.end(); ++usage)
+      {
+        printf("%u %u %u %u\n", usage->texture, usage->primaryCount,
+               usage->secondaryCount, usage->levelCount);
+      }
+    }
+    else if (query == "unused")
+    {
+      // Without a count of the textures, the textures up to the highest one
+      // which is used are checked.
+      const auto usages = table.Histogram();
+      unsigned long textureCount = usages.empty() ? 0 :
+        usages.back().texture + 1;
+      if (arguments.size() > 1)
+      {
+        textureCount = strtoul(arguments[1], nullptr, 10);
+      }
+      if (textureCount > textureLimit)
+      {
+        fprintf(stderr, "error too many textures, there are at most %zu",
+                textureLimit);
+        return 1;
+      }
+
+      const auto unused = table.Unused(static_cast<uint16_t>(textureCount));
+      for (auto texture = unused.begin(); texture != unused.end(); ++texture)
+      {
+        printf("%u\n", *texture);
+      }
+    }
+    else if (query == "uses" && arguments.size() > 1)
+    {
+      const unsigned long texture = strtoul(arguments[1], nullptr, 10);
+      if (texture > UINT16_MAX)
+      {
+        fprintf(stderr, "error there is no texture %s", arguments[1]);
+        return 1;
+      }
+
+      const auto usages = table.LevelsUsing(static_cast<uint16_t>(texture));
+      for (auto usage = usages.begin(); usage != usages.end(); ++usage)
+      {
+        printf("%s %s %u %u\n", usage->archive.c_str(), usage->level.c_str(),
+               usage->primaryCount, usage->secondaryCount);
+      }
+    }
+    else
+    {
+      fprintf(stderr, "error unsupported query provided (%s)", query.c_str());
+      return 1;
+    }
+    return 0;
   }
 
-  if (cube.neighbors[Bottom] == -1)
+  if (mode == DiffArchives)
   {
-    const Quad quad = { vertices[1], vertices[2], vertices[6], vertices[5] };
-    quads->push_back(quad);
-  }
+    if (arguments.size() != 2)
+    {
+      fprintf(stderr, "error two archives or two levels are needed to compare");
+      return 1;
+    }
 
-  if (cube.neighbors[Front] == -1)
-  {
-    const Quad quad = { vertices[0], vertices[1], vertices[2], vertices[3] };
-    quads->push_back(quad);
+    // The levels of both archives by their name in lower case, the first of
+    // the pair is from the first archive.
+    typedef std::pair<std::vector<uint8_t>, std::vector<uint8_t>> LevelPair;
+    std::map<std::string, LevelPair> pairs;
+    std::map<std::string, bool> isPresent[2];
+
+    // Two levels are compared as if they were the only level in a pair of
+    // archives, under the name of the first one.
+    const bool isLevels =
+      IsLevelName(arguments[0]) && IsLevelName(arguments[1]);
+    for (int i = 0; i < 2 && isLevels; ++i)
+    {
+      const char* name = arguments[0];
+      for (const char* c = arguments[0]; *c; ++c)
+      {
+        if (*c == '/' || *c == '\\') name = c + 1;
+      }
+      std::string key = name;
+      std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+
+      const File level(arguments[i]);
+      LevelPair& pair = pairs[key];
+      std::vector<uint8_t>& data = i == 0 ? pair.first : pair.second;
+      data.resize(level.IsValid() ? level.Size() : 0);
+      if (!level.IsValid() || !level.ReadAt(0, data.data(), data.size()))
+      {
+        fprintf(stderr, "error unable to read %s", arguments[i]);
+        return 1;
+      }
+      isPresent[i][key] = true;
+    }
+
+    for (int i = 0; i < 2 && !isLevels; ++i)
+    {
+      HogReader reader(arguments[i]);
+      if (!reader.IsValid())
+      {
+        fprintf(stderr, "error unable to open %s", arguments[i]);
+        return 1;
+      }
+
+      for (auto file = reader.begin(), end = reader.end(); file != end;
+           ++file)
+      {
+        if (!IsLevelName(file->name)) continue;
+
+        std::string name = file->name;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        LevelPair& pair = pairs[name];
+        (i == 0 ? pair.first : pair.second) = file.FileContents();
+        isPresent[i][name] = true;
+      }
+    }
+
+    std::vector<std::string> names;
+    for (auto pair = pairs.begin(); pair != pairs.end(); ++pair)
+    {
+      names.push_back(pair->first);
+    }
+
+    // Each pair is compared on its own thread and the reports are written out
+    // afterwards in the order of the names.
+    std::vector<std::string> reports(names.size());
+    ParallelFor(names.size(), [&](size_t i, size_t)
+    {
+      const std::string& name = names[i];
+      std::ostringstream report;
+      if (!isPresent[1].count(name))
+      {
+        report << name << ": removed" << std::endl;
+        reports[i] = report.str();
+        return;
+      }
+      if (!isPresent[0].count(name))
+      {
+        report << name << ": added" << std::endl;
+        reports[i] = report.str();
+        return;
+      }
+
+      const LevelPair& pair = pairs.find(name)->second;
+      const RdlReader before(pair.first);
+      const RdlReader after(pair.second);
+      if (!before.IsValid() || !after.IsValid())
+      {
+        report << name << ": unable to decode" << std::endl;
+        reports[i] = report.str();
+        return;
+      }
+
+      const LevelDiff diff = DiffLevels(before, after);
+      report << name << ": " << diff.unchangedCount << " unchanged, "
+             << diff.cubes.size() << " changed cubes, "
+             << diff.vertices.size() << " moved vertices" << std::endl;
+
+      const char* const partNames[] = {
+        "vertices", "neighbors", "walls", "textures", "lighting", "special"
+      };
+      for (auto change = diff.cubes.begin(); change != diff.cubes.end();
+           ++change)
+      {
+        switch (change->kind)
+        {
+        case CubeAdded:
+          report << "  added cube " << change->after;
+          break;
+        case CubeRemoved:
+          report << "  removed cube " << change->before;
+          break;
+        case CubeModified:
+          report << "  modified cube " << change->before << " -> "
+                 << change->after << " (";
+          const char* separator = "";
+          for (int part = 0; part < 6; ++part)
+          {
+            if (!(change->parts & (1 << part))) continue;
+            report << separator << partNames[part];
+            separator = ", ";
+          }
+          report << ")";
+          break;
+        }
+        report << std::endl;
+      }
+
+      for (auto move = diff.vertices.begin(); move != diff.vertices.end();
+           ++move)
+      {
+        report << "  moved vertex " << move->before << " -> " << move->after
+               << " (" << move->from.x << ", " << move->from.y << ", "
+               << move->from.z << ") -> (" << move->to.x << ", "
+               << move->to.y << ", " << move->to.z << ")" << std::endl;
+      }
+      reports[i] = report.str();
+    });
+
+    for (auto report = reports.begin(); report != reports.end(); ++report)
+    {
+      std::cout << *report;
+    }
+    return 0;
   }
 
-  if (cube.neighbors[Back] == -1)
+  if (mode == CheckLevels)
   {
-    const Quad quad = { vertices[4], vertices[5], vertices[6], vertices[7] };
-    quads->push_back(quad);
+    struct Level
+    {
+      const char* archive;
+      std::string name;
+      std::vector<uint8_t> data;
+      std::unique_ptr<LevelChecker> checker;
+    };
+
+    std::vector<Level> levelFiles;
+    for (auto path = arguments.begin(); path != arguments.end(); ++path)
+    {
+      HogReader reader(*path);
+      if (!reader.IsValid())
+      {
+        fprintf(stderr, "error unable to open %s", *path);
+        return 1;
+      }
+
+      for (auto file = reader.begin(), end = reader.end(); file != end;
+           ++file)
+      {
+        if (!IsLevelName(file->name)) continue;
+
+        levelFiles.push_back(Level());
+        levelFiles.back().archive = *path;
+        levelFiles.back().name = file->name;
+        levelFiles.back().data = file.FileContents();
+      }
+    }
+
+    ParallelFor(levelFiles.size(), [&levelFiles](size_t i, size_t)
+    {
+      const RdlReader rdlReader(levelFiles[i].data);
+      levelFiles[i].checker.reset(new LevelChecker(rdlReader));
+    });
+
+    // The blocks of all the levels are checked together so a large level
+    // doesn't hold up the others.
+    std::vector<std::pair<size_t, size_t>> blocks;
+    for (size_t i = 0; i < levelFiles.size(); ++i)
+    {
+      for (size_t j = 0; j < levelFiles[i].checker->BlockCount(); ++j)
+      {
+        blocks.push_back(std::make_pair(i, j));
+      }
+    }
+
+    std::vector<std::vector<LevelDiagnostic>> diagnostics(blocks.size());
+    ParallelFor(blocks.size(), [&](size_t i, size_t)
+    {
+      levelFiles[blocks[i].first].checker->CheckBlock(blocks[i].second,
+                                                      &diagnostics[i]);
+    });
+
+    size_t problemCount = 0;
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+      const Level& level = levelFiles[blocks[i].first];
+      for (auto diagnostic = diagnostics[i].begin();
+           diagnostic != diagnostics[i].end(); ++diagnostic)
+      {
+        WriteDiagnostic(level.archive, level.name, *diagnostic, std::cout);
+      }
+      problemCount += diagnostics[i].size();
+    }
+    fprintf(stderr, "%zd problems in %zd levels\n", problemCount,
+            levelFiles.size());
+    return problemCount == 0 ? 0 : 1;
   }
-}
 
-std::vector<Quad> Quads(const std::vector<Cube>& Cubes)
-{
-  // Generate quads from the sides of the cubes.
-  std::vector<Quad> quads;
-  for (auto cube = Cubes.cbegin(), cubeEnd = Cubes.cend(); cube != cubeEnd;
-       ++cube)
+  if (mode == Verify)
   {
-    Quads(*cube, &quads);
-  }
-  return quads;
-}
+    const File archive(arguments.front());
+    if (!archive.IsValid())
+    {
+      fprintf(stderr, "error to open the hog file");
+      return 1;
+    }
 
-void ExportToPly(const RdlReader& Reader, const std::string& Name,
-                 std::ostream& Output)
-{
-  const auto vertices = Reader.Vertices();
-  const auto cubes = Reader.Cubes();
-  const auto quads = Quads(cubes);
+    std::vector<HogEntry> entries;
+    std::string error;
+    if (!VerifyLayout(archive, &entries, &error))
+    {
+      fprintf(stderr, "error %s\n", error.c_str());
+      return 1;
+    }
+
+    std::vector<std::string> errors;
+    const auto checksums = Checksums(archive, entries, &errors);
+    if (!errors.empty())
+    {
+      for (auto message = errors.begin(); message != errors.end(); ++message)
+      {
+        fprintf(stderr, "error %s\n", message->c_str());
+      }
+      return 1;
+    }
+
+    if (arguments.size() < 2)
+    {
+      WriteChecksums(checksums, std::cout);
+      return 0;
+    }
 
-  const bool verticesOnly = false;
+    std::vector<HogChecksum> expected;
+    if (!ReadChecksums(arguments[1], &expected))
+    {
+      fprintf(stderr, "error unable to read the checksums");
+      return 1;
+    }
 
-  Output << "ply" << std::endl;
-  Output << "format ascii 1.0" << std::endl;
-  Output << "comment An exported Descent 1 level (" << Name << ")" << std::endl;
+    const auto differences = CompareChecksums(expected, checksums);
+    for (auto difference = differences.begin(); difference != differences.end();
+         ++difference)
+    {
+      fprintf(stderr, "error %s\n", difference->c_str());
+    }
+    return differences.empty() ? 0 : 1;
+  }
 
-  Output << "element vertex " << vertices.size() << std::endl;
-  Output << "property float x" << std::endl;
-  Output << "property float y" << std::endl;
-  Output << "property float z" << std::endl;
-  if (!verticesOnly)
+  HogReader reader(arguments.front());
+  if (!reader.IsValid())
   {
-    Output << "element face " << quads.size() << std::endl;
-    Output << "property list uchar int vertex_index" << std::endl;
+    fprintf(stderr, "error to open the hog file");
+    return 1;
   }
-  Output << "end_header" << std::endl;
 
-  std::for_each(vertices.begin(), vertices.end(), [&Output](Vertex v)
-  { Output << v.x << " " << v.y << " " << v.z << std::endl; });
+  // The record of what was exported last time, when exporting incrementally.
+  ExportManifest manifest(incremental ? manifestFilename : "");
 
-  if (!verticesOnly)
+  // When a tar archive is given the files are written into it instead of the
+  // current directory, a filename of - means standard output.
+  std::unique_ptr<TarWriter> tar;
+  FILE* tarFile = nullptr;
+  if (tarFilename)
   {
-    std::for_each(quads.begin(), quads.end(), [&Output](const Quad& quad)
+    if (incremental)
     {
-      Output << "4 " << quad.a << " " << quad.b << " " << quad.c << " "
-             << quad.d << std::endl;
-    });
-  }
-}
+      fprintf(stderr, "error incremental exports can't be written to a tar");
+      return 1;
+    }
 
-int main(int argc, char* argv[])
-{
-  if (argc != 2 && argc != 3)
-  {
-    printf("usage: %s [-d -l -p -a] filename\n", argv[0]);
-    return 1;
+    if (strcmp(tarFilename, "-") == 0)
+    {
+#ifdef _WIN32
+      _setmode(_fileno(stdout), _O_BINARY);
+#endif
+      tarFile = stdout;
+    }
+    else
+    {
+      tarFile = fopen(tarFilename, "wb");
+    }
+
+    if (!tarFile)
+    {
+      fprintf(stderr, "error unable to create the tar archive");
+      return 1;
+    }
+    tar.reset(new TarWriter(tarFile));
   }
 
-  enum Mode
+  // Progress is reported on standard error if the tar is on standard output.
+  std::ostream& log = (tarFile == stdout) ? std::cerr : std::cout;
+
+  if (mode == Repack)
   {
-    ListAllFiles,
-    ExportToPly,
-    ExportAllToPly,
-    ExportAllText,
-    ExtractAll, // This extracts it as-is no decoding.
-    Debug // Performs some other task during development.
-  };
+    if (arguments.size() < 2)
+    {
+      fprintf(stderr, "error no output filename provided");
+      return 1;
+    }
 
-  Mode mode = ExportToPly;
-  bool filenameIsFirst = true;
+    const uint32_t alignment =
+        arguments.size() > 2 ? strtoul(arguments[2], nullptr, 0) : 0;
+    HogWriter writer(arguments[1], alignment);
+    if (!writer.IsValid())
+    {
+      fprintf(stderr, "error unable to create the hog file");
+      return 1;
+    }
 
-  // Command line option parsing
-  if ((argv[1] && argv[1][0] == '-') ||
-      (argc == 3 && argv[2] && argv[2][0] == '-'))
+    for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+    {
+      if (!writer.AddCurrentFile(reader))
+      {
+        fprintf(stderr, "error unable to copy %s", file->name);
+        return 1;
+      }
+    }
+  }
+  else if (mode == Compress)
   {
-    filenameIsFirst = (argv[1][0] != '-');
-    const char option = filenameIsFirst ? argv[2][1] : argv[1][1];
-    switch (option)
+    if (arguments.size() < 2)
     {
-    default:
-      fprintf(stderr, "error unsupported option provided (%c)", option);
+      fprintf(stderr, "error no output filename provided");
       return 1;
-    case '\0':
-      fprintf(stderr, "error option specifier - provided but no option");
+    }
+
+    CompressedHogWriter writer(arguments[1]);
+    if (!writer.IsValid())
+    {
+      fprintf(stderr, "error unable to create the hog file");
       return 1;
-    case 'd':
-      mode = Debug;
-      break;
-    case 'l':
-      mode = ListAllFiles;
-      break;
-    case 'p':
-      mode = ExportToPly;
-      break;
-    case 'a':
-      mode = ExportAllToPly;
-      break;
-    case 't':
-      mode = ExportAllText;
-      break;
-    case 'x':
-      mode = ExtractAll;
-      break;
     }
 
-    if (argc == 2)
+    // The files are compressed a batch at a time, on many threads, and then
+    // added in the order they were in.
+    const size_t batchSize = 64;
+    const std::vector<HogEntry> entries = reader.Entries();
+    std::vector<std::vector<uint8_t>> stored(batchSize);
+    std::vector<uint8_t> compressions(batchSize);
+    std::vector<char> isRead(batchSize);
+    uint64_t size = 0;
+    uint64_t storedSize = 0;
+    for (size_t first = 0; first < entries.size(); first += batchSize)
+    {
+      const size_t count = std::min(batchSize, entries.size() - first);
+      ParallelFor(count, [&](size_t i, size_t)
+      {
+        std::vector<uint8_t> data;
+        const HogEntry& entry = entries[first + i];
+        isRead[i] = ReadEntry(reader.Archive(), entry, &data);
+        if (!isRead[i]) return;
+
+        compressions[i] =
+          CompressedHogWriter::Compress(data.data(), entry.size, &stored[i]);
+      });
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        const HogEntry& entry = entries[first + i];
+        if (!isRead[i] ||
+            !writer.AddStoredFile(entry.name, entry.size, compressions[i],
+                                  stored[i]))
+        {
+          fprintf(stderr, "error unable to compress %s", entry.name);
+          return 1;
+        }
+        size += entry.size;
+        storedSize += stored[i].size();
+      }
+    }
+
+    if (!writer.Finish())
     {
-      fprintf(stderr, "option provided but no filename");
+      fprintf(stderr, "error unable to write the hog file");
       return 1;
     }
+    log << "Compressed " << size << " bytes to " << storedSize << " bytes"
+        << std::endl;
   }
+  else if (mode == BuildLevelPack)
+  {
+    LevelPackBuilder builder;
+    for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+    {
+      if (!IsLevelName(file->name)) continue;
+
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
+      if (!builder.Add(file->name, RdlReader(data)))
+      {
+        fprintf(stderr, "warning %s is not a valid level\n", file->name);
+      }
+    }
 
-  HogReader reader(filenameIsFirst ? argv[1] : argv[2]);
-  if (!reader.IsValid())
+    if (!builder.Write(packFilename))
+    {
+      fprintf(stderr, "error unable to write the level pack");
+      return 1;
+    }
+    log << "Packed " << builder.LevelCount() << " levels" << std::endl;
+  }
+  else if (mode == Benchmark)
   {
-    fprintf(stderr, "error to open the hog file");
-    return 1;
+    if (strcmp(benchmark, "locate") == 0)
+    {
+      BenchmarkLocate(reader, std::cout);
+    }
+    else if (strcmp(benchmark, "decode") == 0)
+    {
+      BenchmarkDecode(reader, std::cout);
+    }
+    else if (strcmp(benchmark, "collision") == 0)
+    {
+      BenchmarkCollision(reader, std::cout);
+    }
+    else if (strcmp(benchmark, "path") == 0)
+    {
+      BenchmarkPath(reader, std::cout);
+    }
+    else if (strcmp(benchmark, "sight") == 0)
+    {
+      BenchmarkSight(reader, std::cout);
+    }
+    else if (strcmp(benchmark, "prefetch") == 0)
+    {
+      BenchmarkPrefetch(reader, std::cout);
+    }
+    else if (strcmp(benchmark, "server") == 0)
+    {
+      if (arguments.size() < 2)
+      {
+        fprintf(stderr, "error no socket provided");
+        return 1;
+      }
+      BenchmarkServer(reader, arguments[0], arguments[1], std::cout);
+    }
+    else if (strcmp(benchmark, "pack") == 0)
+    {
+      if (arguments.size() < 2)
+      {
+        fprintf(stderr, "error no level pack provided");
+        return 1;
+      }
+      BenchmarkPack(reader, arguments[1], std::cout);
+    }
+    else
+    {
+      fprintf(stderr, "error unknown benchmark (%s)", benchmark);
+      return 1;
+    }
   }
-
-  if (mode == ListAllFiles)
+  else if (mode == ListAllFiles)
   {
     printf("%-13s Size\n", "Name");
     printf("=====================\n");
     std::for_each(reader.begin(), reader.end(),
                   [](HogReader::iterator::value_type item)
-    { printf("%-13s %d\n", item.name, item.size); });
+    { printf("%-13s %u\n", item.name, item.size); });
   }
   else if (mode == ExportToPly)
   {
     auto file = std::find_if(reader.begin(), reader.end(),
                              [](const HogReader::iterator::value_type & v)->bool
     { return strcmp(v.name, "level02.rdl") == 0; });
+    if (file == reader.end())
+    {
+      fprintf(stderr, "error the archive doesn't have level02.rdl");
+      return 1;
+    }
+
+    std::vector<uint8_t> data;
+    if (!file.FileContents(&data))
+    {
+      fprintf(stderr, "error unable to read %s\n", file->name);
+      return 1;
+    }
 
-    const auto data = file.FileContents();
     RdlReader rdlReader(data);
+    if (!rdlReader.IsValid())
+    {
+      fprintf(stderr, "error level02.rdl is not a valid level");
+      return 1;
+    }
     ::ExportToPly(rdlReader, std::string(file->name), std::cout);
   }
   else if (mode == ExportAllToPly)
@@ -401,16 +1164,42 @@ int main(int argc, char* argv[])
     for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
     {
       const std::string name(file->name);
-      if (name.length() < 4) continue;
-      if (name.substr(name.length() - 4) != ".rdl") continue;
-
-      const auto data = file.FileContents();
+      if (!IsLevelName(name.c_str())) continue;
+
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
       RdlReader rdlReader(data);
 
       const std::string ply = name.substr(0, name.length() - 4) + ".ply";
-      std::cout << "Writing out " << ply << std::endl;
-      std::ofstream output(ply.c_str());
-      ::ExportToPly(rdlReader, name, output);
+      const uint64_t hash = incremental ? Hash64(data.data(), data.size()) : 0;
+      if (incremental && manifest.IsUpToDate(ply, hash, plyExporter))
+      {
+        log << "Skipping " << ply << std::endl;
+        continue;
+      }
+
+      log << "Writing out " << ply << std::endl;
+      if (tar)
+      {
+        std::ostringstream output;
+        ::ExportToPly(rdlReader, name, output);
+        if (!tar->AddFile(ply, output.str()))
+        {
+          fprintf(stderr, "error unable to add %s to the tar file",
+                  ply.c_str());
+          return 1;
+        }
+      }
+      else
+      {
+        std::ofstream output(ply.c_str());
+        ::ExportToPly(rdlReader, name, output);
+      }
+      if (incremental) manifest.Update(ply, hash, plyExporter);
     }
   }
   else if (mode == ExportAllText)
@@ -421,43 +1210,331 @@ int main(int argc, char* argv[])
       if (name.length() < 4) continue;
       if (name.substr(name.length() - 4) != ".txb") continue;
 
-      const auto data = file.FileContents();
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
 
       TxbReader txbReader(data);
 
       const std::string txt = name.substr(0, name.length() - 4) + ".txt";
-      std::cout << "Writing out " << txt << std::endl;
-      std::ofstream output(txt.c_str());
-      ::ExtractTxb(txbReader, name, output);
+      const uint64_t hash = incremental ? Hash64(data.data(), data.size()) : 0;
+      if (incremental && manifest.IsUpToDate(txt, hash, textExporter))
+      {
+        log << "Skipping " << txt << std::endl;
+        continue;
+      }
+
+      log << "Writing out " << txt << std::endl;
+      if (tar)
+      {
+        std::ostringstream output;
+        ::ExtractTxb(txbReader, name, output);
+        if (!tar->AddFile(txt, output.str()))
+        {
+          fprintf(stderr, "error unable to add %s to the tar file",
+                  txt.c_str());
+          return 1;
+        }
+      }
+      else
+      {
+        std::ofstream output(txt.c_str());
+        ::ExtractTxb(txbReader, name, output);
+      }
+      if (incremental) manifest.Update(txt, hash, textExporter);
     }
   }
-  else if (mode == ExtractAll)
+  else if (mode == ListObjects)
+  {
+    for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+    {
+      const std::string name(file->name);
+      if (!IsLevelName(name.c_str())) continue;
+
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
+      RdlReader rdlReader(data);
+      if (!rdlReader.IsValid()) continue;
+
+      const auto objects = rdlReader.Objects();
+      const ObjectIndex index(objects, rdlReader.CubeCount());
+      printf("File: %s Objects: %zd Walls: %zd Triggers: %zd\n", file->name,
+             objects.size(), rdlReader.Walls().size(),
+             rdlReader.Triggers().size());
+      printf("%5s %-9s %3s %9s %9s %9s %6s\n", "Cube", "Type", "Id", "x",
+             "y", "z", "Index");
+      for (uint32_t cube = 0; cube < index.CubeCount(); ++cube)
+      {
+        for (auto i = index.ObjectsBegin(cube); i != index.ObjectsEnd(cube);
+             ++i)
+        {
+          const Object& object = objects[*i];
+          printf("%5u %-9s %3u %9.2f %9.2f %9.2f %6u\n", cube,
+                 ObjectTypeName(object.type), object.id, object.position.x,
+                 object.position.y, object.position.z, *i);
+        }
+      }
+    }
+  }
+  else if (mode == ExportAllImages)
+  {
+    struct ImageFile
+    {
+      std::string name;
+      std::string png;
+      uint64_t hash;
+      bool isUpToDate;
+      std::string encoded; // Empty if it couldn't be decoded.
+    };
+
+    std::vector<HogEntry> entries = reader.Entries();
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [](const HogEntry& entry)
+                                 { return !IsImageName(entry.name); }),
+                  entries.end());
+
+    // The reads are queued ahead of time and each thread decodes and encodes
+    // whichever file was read next, then they are written out in the order
+    // they are in the archive.
+    std::vector<ImageFile> images(entries.size());
+    Prefetcher prefetcher(reader.Archive(), entries, prefetchDepth);
+    std::mutex prefetcherMutex;
+    ParallelFor(images.size(), [&](size_t, size_t)
+    {
+      PrefetchedEntry entry;
+      {
+        std::lock_guard<std::mutex> lock(prefetcherMutex);
+        if (!prefetcher.Next(&entry)) return;
+      }
+
+      ImageFile& image = images[entry.index];
+      image.name = entries[entry.index].name;
+      image.png = image.name.substr(0, image.name.rfind('.')) + ".png";
+      image.hash =
+        incremental ? Hash64(entry.data.data(), entry.data.size()) : 0;
+      image.isUpToDate =
+        incremental && manifest.IsUpToDate(image.png, image.hash,
+                                           pngExporter);
+      if (image.isUpToDate || !entry.succeeded) return;
+
+      Image decoded;
+      if (!DecodeImage(image.name, entry.data, &decoded)) return;
+
+      std::ostringstream output;
+      WritePng(decoded, output);
+      image.encoded = output.str();
+    });
+
+    for (auto image = images.begin(); image != images.end(); ++image)
+    {
+      if (image->isUpToDate)
+      {
+        log << "Skipping " << image->png << std::endl;
+        continue;
+      }
+
+      if (image->encoded.empty())
+      {
+        log << "Unable to decode " << image->name << std::endl;
+        continue;
+      }
+
+      log << "Writing out " << image->png << std::endl;
+      if (tar)
+      {
+        if (!tar->AddFile(image->png, image->encoded))
+        {
+          fprintf(stderr, "error unable to add %s to the tar file",
+                  image->png.c_str());
+          return 1;
+        }
+      }
+      else
+      {
+        std::ofstream output(image->png.c_str(), std::ios::binary);
+        output << image->encoded;
+      }
+      if (incremental) manifest.Update(image->png, image->hash, pngExporter);
+    }
+  }
+  else if (mode == ExportAllThumbnails)
   {
+    const struct
+    {
+      RenderView view;
+      const char* suffix;
+    } views[] = { { TopDown, "-top.png" }, { Isometric, "-iso.png" } };
+
     for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
     {
-      const auto data = file.FileContents();
+      const std::string name(file->name);
+      if (!IsLevelName(name.c_str())) continue;
+
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
+      RdlReader rdlReader(data);
+      if (!rdlReader.IsValid()) continue;
 
-      std::cout << "Writing out " << file->name << std::endl;
-      std::ofstream output(file->name);
-      std::copy(data.begin(), data.end(),
-                std::ostream_iterator<uint8_t>(output));
+      const uint64_t hash = incremental ? Hash64(data.data(), data.size()) : 0;
+      const std::string base = name.substr(0, name.length() - 4);
+      const auto vertices = rdlReader.Vertices();
+      const auto cubes = rdlReader.Cubes();
+      const auto quads = Quads(cubes);
+      for (auto view = std::begin(views); view != std::end(views); ++view)
+      {
+        const std::string png = base + view->suffix;
+        if (incremental && manifest.IsUpToDate(png, hash, thumbnailExporter))
+        {
+          log << "Skipping " << png << std::endl;
+          continue;
+        }
+
+        log << "Writing out " << png << std::endl;
+        const Image image = Render(vertices, cubes, quads, view->view,
+                                   thumbnailSize, thumbnailSize);
+        if (tar)
+        {
+          std::ostringstream output;
+          WritePng(image, output);
+          if (!tar->AddFile(png, output.str()))
+          {
+            fprintf(stderr, "error unable to add %s to the tar file",
+                    png.c_str());
+            return 1;
+          }
+        }
+        else
+        {
+          std::ofstream output(png.c_str(), std::ios::binary);
+          WritePng(image, output);
+        }
+        if (incremental) manifest.Update(png, hash, thumbnailExporter);
+      }
+    }
+  }
+  else if (mode == ExportAllVisibility)
+  {
+    const PotentiallyVisibleSet::Mode pvsMode = fastVisibility ?
+      PotentiallyVisibleSet::Fast : PotentiallyVisibleSet::Accurate;
+    const char* const exporter = fastVisibility ? fastPvsExporter : pvsExporter;
+
+    for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+    {
+      const std::string name(file->name);
+      if (!IsLevelName(name.c_str())) continue;
+
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
+      RdlReader rdlReader(data);
+      if (!rdlReader.IsValid()) continue;
+
+      const std::string pvsName = name.substr(0, name.length() - 4) + ".pvs";
+      const uint64_t hash = incremental ? Hash64(data.data(), data.size()) : 0;
+      if (incremental && manifest.IsUpToDate(pvsName, hash, exporter))
+      {
+        log << "Skipping " << pvsName << std::endl;
+        continue;
+      }
+
+      const PotentiallyVisibleSet pvs(rdlReader.Cubes(), rdlReader.Vertices(),
+                                      pvsMode);
+      size_t visible = 0;
+      for (uint32_t cube = 0; cube < pvs.CubeCount(); ++cube)
+      {
+        visible += pvs.VisibleCount(cube);
+      }
+
+      log << "Writing out " << pvsName << " (" << pvs.CubeCount()
+          << " cubes, " << (pvs.CubeCount() ? visible / pvs.CubeCount() : 0)
+          << " visible on average)" << std::endl;
+      if (tar)
+      {
+        std::ostringstream output;
+        pvs.Write(output);
+        if (!tar->AddFile(pvsName, output.str()))
+        {
+          fprintf(stderr, "error unable to add %s to the tar file",
+                  pvsName.c_str());
+          return 1;
+        }
+      }
+      else
+      {
+        std::ofstream output(pvsName.c_str(), std::ios::binary);
+        pvs.Write(output);
+      }
+      if (incremental) manifest.Update(pvsName, hash, exporter);
+    }
+  }
+  else if (mode == ExtractAll)
+  {
+    for (auto file = reader.begin(), end = reader.end(); file != end; ++file)
+    {
+      std::vector<uint8_t> data;
+      if (!file.FileContents(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", file->name);
+        return 1;
+      }
+
+      const uint64_t hash = incremental ? Hash64(data.data(), data.size()) : 0;
+      if (incremental && manifest.IsUpToDate(file->name, hash, rawExporter))
+      {
+        log << "Skipping " << file->name << std::endl;
+        continue;
+      }
+
+      log << "Writing out " << file->name << std::endl;
+      if (tar)
+      {
+        if (!tar->AddFile(file->name, data.data(), data.size()))
+        {
+          fprintf(stderr, "error unable to add %s to the tar file",
+                  file->name);
+          return 1;
+        }
+      }
+      else
+      {
+        std::ofstream output(file->name);
+        std::copy(data.begin(), data.end(),
+                  std::ostream_iterator<uint8_t>(output));
+      }
+      if (incremental) manifest.Update(file->name, hash, rawExporter);
     }
   }
   else
   {
-    // Iterate over the file list and list all the files which do not
-    // end in the 'rdl' file extension.
-    const std::string extentionRdl(".rdl");
+    // Iterate over the file list and list all the files which are levels.
+    bool isReadFailed = false;
     std::for_each(reader.begin(), reader.end(),
-                  [&reader, &extentionRdl](HogReader::iterator::value_type n)
+                  [&reader, &isReadFailed](HogReader::iterator::value_type n)
     {
-      const std::string filename(n.name);
-      if (!std::equal(extentionRdl.rbegin(), extentionRdl.rend(),
-                      filename.rbegin()))
+      if (!IsLevelName(n.name)) return;
+
+      printf("File: %s Size: %u\n", n.name, reader.CurrentFileSize());
+      std::vector<uint8_t> data;
+      if (!reader.CurrentFile(&data))
+      {
+        fprintf(stderr, "error unable to read %s\n", n.name);
+        isReadFailed = true;
         return;
-
-      printf("File: %s Size: %d\n", n.name, reader.CurrentFileSize());
-      const auto data = reader.CurrentFile();
+      }
       RdlReader rdlReader(data);
 
       if (!rdlReader.IsValid()) return;
@@ -469,6 +1546,24 @@ int main(int argc, char* argv[])
                     [](Vertex v)
                     { printf("%16f %16f %16f\n", v.x, v.y, v.z); });
     });
+    if (isReadFailed) return 1;
+  }
+
+  if (incremental && !manifest.Save())
+  {
+    fprintf(stderr, "error unable to write the manifest");
+    return 1;
+  }
+
+  if (tar)
+  {
+    const bool written = tar->Finish();
+    if (tarFile != stdout) fclose(tarFile);
+    if (!written)
+    {
+      fprintf(stderr, "error unable to write the tar archive");
+      return 1;
+    }
   }
   return 0;
 }
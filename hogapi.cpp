@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : HogApi
+// PURPOSE      : Providing a C interface to the readers for embedding them in
+//                programs written in other languages.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Each function wraps the C++ reader which does the work, the
+//                layouts of the structures are checked to match at compile time
+//                so the readers can write straight into the caller's arrays.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hogapi.h"
+
+#include "cube.hpp"
+#include "hogreader.hpp"
+#include "lz4.hpp"
+#include "rdl.hpp"
+#include "txbiterator.hpp"
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+#include <ctype.h>
+#include <stddef.h>
+#include <string.h>
+
+static_assert(sizeof(hog_entry) == sizeof(HogEntry) &&
+              offsetof(hog_entry, size) == offsetof(HogEntry, size) &&
+              offsetof(hog_entry, offset) == offsetof(HogEntry, offset) &&
+              offsetof(hog_entry, stored_size) ==
+                offsetof(HogEntry, storedSize) &&
+              offsetof(hog_entry, compression) ==
+                offsetof(HogEntry, compression),
+              "The layout of hog_entry must match HogEntry");
+static_assert(sizeof(hog_vertex) == sizeof(Vertex),
+              "The layout of hog_vertex must match Vertex");
+static_assert(sizeof(hog_cube) == sizeof(Cube) &&
+              offsetof(hog_cube, neighbors) == offsetof(Cube, neighbors) &&
+              offsetof(hog_cube, walls) == offsetof(Cube, walls) &&
+              offsetof(hog_cube, special) == offsetof(Cube, special) &&
+              offsetof(hog_cube, value) == offsetof(Cube, value) &&
+              offsetof(hog_cube, lighting) == offsetof(Cube, lighting) &&
+              offsetof(hog_cube, textures) == offsetof(Cube, textures),
+              "The layout of hog_cube must match Cube");
+
+struct hog_archive
+{
+  hog_archive(const char* filename) : reader(filename) {}
+
+  HogReader reader;
+  std::vector<HogEntry> entries;
+
+  // The indices of the entries sorted by their names.
+  std::vector<size_t> byName;
+};
+
+namespace
+{
+  // Compares the names ignoring case, like the game does.
+  int compareNames(const char* a, const char* b)
+  {
+    for (size_t i = 0; i < sizeof(HogEntry::name); ++i)
+    {
+      const int difference = tolower(static_cast<unsigned char>(a[i])) -
+                             tolower(static_cast<unsigned char>(b[i]));
+      if (difference != 0 || a[i] == '\0') return difference;
+    }
+    return 0;
+  }
+}
+
+uint32_t hog_api_version(void)
+{
+  return HOG_API_VERSION;
+}
+
+hog_archive* hog_open(const char* filename)
+{
+  // Nothing may be thrown out to a C caller.
+  try
+  {
+    hog_archive* archive = new hog_archive(filename);
+    if (!archive->reader.IsValid())
+    {
+      delete archive;
+      return nullptr;
+    }
+
+    archive->entries = archive->reader.Entries();
+    archive->byName.resize(archive->entries.size());
+    for (size_t i = 0; i < archive->byName.size(); ++i)
+    {
+      archive->byName[i] = i;
+    }
+
+    // If names are repeated the first of them is found.
+    const std::vector<HogEntry>& entries = archive->entries;
+    std::stable_sort(archive->byName.begin(), archive->byName.end(),
+                     [&entries](size_t a, size_t b)
+    { return compareNames(entries[a].name, entries[b].name) < 0; });
+    return archive;
+  }
+  catch (const std::bad_alloc&)
+  {
+    return nullptr;
+  }
+}
+
+void hog_close(hog_archive* archive)
+{
+  delete archive;
+}
+
+size_t hog_entry_count(const hog_archive* archive)
+{
+  return archive->entries.size();
+}
+
+int hog_get_entry(const hog_archive* archive, size_t index, hog_entry* entry)
+{
+  if (index >= archive->entries.size()) return HOG_INVALID;
+
+  memcpy(entry, &archive->entries[index], sizeof(*entry));
+  return HOG_OK;
+}
+
+int hog_find_entry(const hog_archive* archive, const char* name,
+                   size_t* index)
+{
+  const std::vector<HogEntry>& entries = archive->entries;
+  const auto found = std::lower_bound(
+    archive->byName.begin(), archive->byName.end(), name,
+    [&entries](size_t a, const char* b)
+    { return compareNames(entries[a].name, b) < 0; });
+  if (found == archive->byName.end() ||
+      compareNames(entries[*found].name, name) != 0)
+  {
+    return HOG_NOT_FOUND;
+  }
+
+  *index = *found;
+  return HOG_OK;
+}
+
+int hog_read_entry(const hog_archive* archive, size_t index, void* buffer,
+                   size_t capacity)
+{
+  if (index >= archive->entries.size()) return HOG_INVALID;
+
+  const HogEntry& entry = archive->entries[index];
+  if (entry.compression == HogStored)
+  {
+    if (entry.size > capacity) return HOG_TOO_SMALL;
+    if (!archive->reader.Archive().ReadAt(entry.offset, buffer, entry.size))
+    {
+      return HOG_READ_FAILED;
+    }
+    return HOG_OK;
+  }
+
+  // The stored data goes after where the data will be, so that nothing is
+  // overwritten before it is decompressed.
+  if (entry.size > capacity || entry.storedSize > capacity - entry.size)
+  {
+    return HOG_TOO_SMALL;
+  }
+
+  uint8_t* const data = static_cast<uint8_t*>(buffer);
+  uint8_t* const stored = data + entry.size;
+  if (!archive->reader.Archive().ReadAt(entry.offset, stored,
+                                        entry.storedSize))
+  {
+    return HOG_READ_FAILED;
+  }
+  if (entry.compression != HogLz4 ||
+      !Lz4Decompress(stored, entry.storedSize, data, entry.size))
+  {
+    return HOG_INVALID;
+  }
+  return HOG_OK;
+}
+
+int hog_level_counts(const void* data, size_t size, size_t* vertex_count,
+                     size_t* cube_count)
+{
+  const RdlReader reader(static_cast<const uint8_t*>(data), size);
+  if (!reader.IsValid()) return HOG_INVALID;
+
+  *vertex_count = reader.VertexCount();
+  *cube_count = reader.CubeCount();
+  return HOG_OK;
+}
+
+int hog_level_vertices(const void* data, size_t size, hog_vertex* vertices,
+                       size_t capacity)
+{
+  const RdlReader reader(static_cast<const uint8_t*>(data), size);
+  if (!reader.IsValid()) return HOG_INVALID;
+  if (reader.VertexCount() > capacity) return HOG_TOO_SMALL;
+
+  reader.ReadVertices(reinterpret_cast<Vertex*>(vertices));
+  return HOG_OK;
+}
+
+int hog_level_cubes(const void* data, size_t size, hog_cube* cubes,
+                    size_t capacity)
+{
+  const RdlReader reader(static_cast<const uint8_t*>(data), size);
+  if (!reader.IsValid()) return HOG_INVALID;
+  if (reader.CubeCount() > capacity) return HOG_TOO_SMALL;
+
+  if (!reader.ReadCubes(reinterpret_cast<Cube*>(cubes))) return HOG_INVALID;
+  return HOG_OK;
+}
+
+void hog_decode_txb(const void* data, size_t size, char* text)
+{
+  DecodeTxb(static_cast<const uint8_t*>(data), size, text);
+}
+
+int hog_read_txb_entries(const hog_archive* archive, const size_t* indices,
+                         size_t count, char* text, size_t capacity,
+                         size_t* offsets)
+{
+  // Each entry is read into the text where its own text goes and decoded in
+  // place, as the decoded text is the same size as the data.
+  size_t offset = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    offsets[i] = offset;
+    if (indices[i] >= archive->entries.size()) return HOG_INVALID;
+
+    const HogEntry& entry = archive->entries[indices[i]];
+    const int status =
+      hog_read_entry(archive, indices[i], text + offset, capacity - offset);
+    if (status != HOG_OK) return status;
+
+    DecodeTxb(reinterpret_cast<const uint8_t*>(text + offset), entry.size,
+              text + offset);
+    offset += entry.size;
+  }
+  offsets[count] = offset;
+  return HOG_OK;
+}
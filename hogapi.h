@@ -0,0 +1,161 @@
+#ifndef HOG_API_H_GUARD
+#define HOG_API_H_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : HogApi
+// PURPOSE      : Providing a C interface to the readers for embedding them in
+//                programs written in other languages.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The caller owns all of the memory that is read or decoded
+//                into, the functions only fill in the buffers and arrays they
+//                are given. The one allocation is the archive itself, which
+//                keeps the list of its entries so looking them up doesn't need
+//                to read the archive.
+//
+//                The functions which take an archive may be called from many
+//                threads at once, as the entries are read at their offsets.
+//
+//                The structures have the same layout as the ones used by the
+//                C++ readers so they are filled in directly.
+//
+//                The version is raised whenever anything here changes in a way
+//                that isn't compatible with programs built against an earlier
+//                version.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(HOG_API_SHARED)
+#  if defined(HOG_API_BUILD)
+#    define HOG_API __declspec(dllexport)
+#  else
+#    define HOG_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define HOG_API __attribute__((visibility("default")))
+#else
+#  define HOG_API
+#endif
+
+#define HOG_API_VERSION 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hog_archive hog_archive;
+
+enum hog_status
+{
+  HOG_OK = 0,
+  HOG_INVALID = 1, // The archive, level or index given isn't valid.
+  HOG_NOT_FOUND = 2, // There is no entry with the name.
+  HOG_TOO_SMALL = 3, // The buffer or array doesn't have enough room.
+  HOG_READ_FAILED = 4 // The data couldn't be read from the archive.
+};
+
+enum hog_compression
+{
+  HOG_STORED = 0, // The data is stored as it is.
+  HOG_LZ4 = 1 // The data is stored as an LZ4 block.
+};
+
+typedef struct hog_entry
+{
+  char name[13]; // Padded to 13 bytes with \0.
+  uint32_t size;
+  uint64_t offset; // The offset of the data from the start of the archive.
+  uint32_t stored_size; // The number of bytes the data takes in the archive.
+  uint8_t compression; // A hog_compression.
+} hog_entry;
+
+typedef struct hog_vertex
+{
+  double x;
+  double y;
+  double z;
+} hog_vertex;
+
+typedef struct hog_texture
+{
+  uint16_t primary; // The high bit is set if there is a secondary texture.
+  uint16_t secondary; // 0 if there isn't one.
+} hog_texture;
+
+typedef struct hog_cube
+{
+  uint16_t vertices[8];
+  int16_t neighbors[6]; // -1 where there is no cube on that side.
+  uint8_t walls[6]; // 255 where there is no wall.
+  uint8_t special;
+  int8_t matcen;
+  int16_t value;
+  double lighting;
+  hog_texture textures[6];
+} hog_cube;
+
+HOG_API uint32_t hog_api_version(void);
+// Returns the HOG_API_VERSION the library was built with.
+
+HOG_API hog_archive* hog_open(const char* filename);
+// Opens the archive and reads the list of its entries, returns NULL if it
+// couldn't be opened or isn't an archive.
+
+HOG_API void hog_close(hog_archive* archive);
+
+HOG_API size_t hog_entry_count(const hog_archive* archive);
+
+HOG_API int hog_get_entry(const hog_archive* archive, size_t index,
+                          hog_entry* entry);
+
+HOG_API int hog_find_entry(const hog_archive* archive, const char* name,
+                           size_t* index);
+// Finds the entry with the name, ignoring the case of the letters.
+
+HOG_API int hog_read_entry(const hog_archive* archive, size_t index,
+                           void* buffer, size_t capacity);
+// Reads the data of the entry, the buffer must have room for its size. When
+// the entry is compressed the buffer must have room for its size and its
+// stored size, as the stored data is read into the end of it before being
+// decompressed into the start.
+
+HOG_API int hog_level_counts(const void* data, size_t size,
+                             size_t* vertex_count, size_t* cube_count);
+// Returns the number of vertices and cubes in the level. The level is checked
+// as far as its header and its vertices, the cubes are checked when they are
+// decoded.
+
+HOG_API int hog_level_vertices(const void* data, size_t size,
+                               hog_vertex* vertices, size_t capacity);
+HOG_API int hog_level_cubes(const void* data, size_t size, hog_cube* cubes,
+                            size_t capacity);
+// Decodes the vertices or the cubes of the level into the array, which must
+// have room for the counts given by hog_level_counts(). hog_level_cubes()
+// returns HOG_INVALID if the level ends before the last cube or a cube has a
+// vertex which isn't in the level, in which case the cubes may be only partly
+// written.
+
+HOG_API void hog_decode_txb(const void* data, size_t size, char* text);
+// Decodes the TXB data into the text, which must have room for size
+// characters. The text may be the same memory as the data.
+
+HOG_API int hog_read_txb_entries(const hog_archive* archive,
+                                 const size_t* indices, size_t count,
+                                 char* text, size_t capacity,
+                                 size_t* offsets);
+// Reads and decodes the given TXB entries one after the other into the text.
+// The text of entry i starts at offsets[i] and offsets[count] is where the
+// last one ends, so offsets must have room for count + 1 numbers.
+// Each entry is read as if by hog_read_entry() into the rest of the text, so
+// compressed entries need room for their stored data after their text.
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
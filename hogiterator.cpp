@@ -70,3 +70,8 @@ std::vector<uint8_t> HogReaderIterator::FileContents()
 {
   return myReader->CurrentFile();
 }
+
+bool HogReaderIterator::FileContents(std::vector<uint8_t>* data)
+{
+  return myReader->CurrentFile(data);
+}
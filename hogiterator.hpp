@@ -46,8 +46,10 @@ public:
   bool operator==(const HogReaderIterator& o) const;
   bool operator!=(const HogReaderIterator& o) const;
 
-  // Returns the contents of the file.
+  // Returns the contents of the file, the second returns false if it can't be
+  // read rather than returning it empty.
   std::vector<uint8_t> FileContents();
+  bool FileContents(std::vector<uint8_t>* data);
 
 private:
   value_type myData;
@@ -0,0 +1,284 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : HogReader
+// PURPOSE      : Providing a decoder and wrapper for the Descent .HOG format.
+// COPYRIGHT    : (c) 2011 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A decoder for the HOG file format that is used by Parallax
+//                Software in the computer game, Descent.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hogreader.hpp"
+
+#include "hogiterator.hpp"
+#include "lz4.hpp"
+
+#include <string.h>
+
+#ifdef _MSC_VER
+static_assert(sizeof(uint8_t) == 1,
+              "The size of uint8_t is incorrect it must be 1-byte");
+static_assert(sizeof(uint32_t) == 4,
+              "The size of uint32_t is incorrect it must be 4-bytes");
+static_assert(sizeof(uint8_t) == sizeof(char),
+              "The size of a char must be 1-byte");
+#endif
+
+// The 3-byte MAGIC number at the start of the file format used to identifiy the
+// file as being a Descent HOG file.
+static uint8_t magic[3] = { 'D', 'H', 'F' };
+
+// The size of the header which precedes the data of each file in the archive.
+static const uint64_t fileHeaderSize = 13 + 4;
+
+// The MAGIC number and version of the compressed variant of the format.
+static uint8_t compressedMagic[3] = { 'D', 'H', 'Z' };
+static const uint8_t compressedVersion = 1;
+
+// The sizes of the header of a compressed archive and of each entry in its
+// table.
+static const uint64_t compressedHeaderSize = 3 + 1 + 4 + 8;
+static const uint64_t tableEntrySize = 13 + 1 + 4 + 4 + 8;
+
+HogReader::iterator HogReader::begin()
+{
+  // Sync back up to the start just after the magic number. Whether the data
+  // of the files is read is worked out again for each walk of the archive.
+  if (!IsValid()) return HogReaderIterator();
+  myIsReadingData = false;
+  if (IsCompressed() ? !SelectEntry(0) : !ReadHeader(sizeof(magic)))
+  {
+    return HogReaderIterator();
+  }
+
+  return HogReaderIterator(*this);
+}
+
+HogReader::iterator HogReader::end()
+{
+  return HogReaderIterator();
+}
+
+HogReader::HogReader(const char* filename)
+: myFile(filename), myFileSize(myFile.Size()), myTableIndex(0),
+  myIsReadingData(false)
+{
+  memset(&myChild, 0, sizeof(myChild));
+  if (!myFile.IsValid()) return;
+
+  if (!myFile.ReadAt(0, myHeader, sizeof(myHeader)))
+  {
+    myHeader[0] = '\0'; // Failed to load.
+    return;
+  }
+
+  if (IsCompressed())
+  {
+    if (!ReadTable())
+    {
+      myHeader[0] = '\0';
+      return;
+    }
+    SelectEntry(0);
+    return;
+  }
+
+  // The headers are visited from the start to the end of the archive.
+  myFile.Sequential();
+
+  // Read in the header for the first file.
+  if (IsValid()) ReadHeader(sizeof(magic));
+}
+
+HogReader::~HogReader()
+{
+}
+
+bool HogReader::IsValid() const
+{
+  if (!myFile.IsValid()) return false;
+  return memcmp(myHeader, magic, 3) == 0 || IsCompressed();
+}
+
+bool HogReader::IsCompressed() const
+{
+  return myFile.IsValid() && memcmp(myHeader, compressedMagic, 3) == 0;
+}
+
+bool HogReader::ReadTable()
+{
+  return ReadCompressedTable(myFile, &myTable);
+}
+
+bool HogReader::SelectEntry(size_t index)
+{
+  // Skip over any entries without a name as if they were padding.
+  while (index < myTable.size() && myTable[index].name[0] == '\0') ++index;
+  if (index >= myTable.size()) return false;
+
+  myTableIndex = index;
+  myChild = myTable[index];
+  if (myIsReadingData) myFile.WillNeed(myChild.offset, myChild.storedSize);
+  return true;
+}
+
+bool HogReader::ReadHeader(uint64_t offset)
+{
+  do
+  {
+    if (offset + fileHeaderSize > myFileSize) return false;
+
+    uint8_t header[fileHeaderSize];
+    if (!myFile.ReadAt(offset, header, sizeof(header))) return false;
+
+    memcpy(myChild.name, header, 13);
+    memcpy(&myChild.size, header + 13, 4);
+    myChild.offset = offset + fileHeaderSize;
+    myChild.storedSize = myChild.size;
+    myChild.compression = HogStored;
+    offset = myChild.offset + myChild.size;
+  } while (myChild.name[0] == '\0');
+
+  // Start reading the data for the file in the background if the caller has
+  // been reading the data of the files, as it will most likely want it next.
+  if (myIsReadingData) myFile.WillNeed(myChild.offset, myChild.size);
+  return true;
+}
+
+bool HogReader::NextFile()
+{
+  // Skip over the data section of the current file to the next header.
+  if (!IsValid()) return false;
+  if (IsCompressed()) return SelectEntry(myTableIndex + 1);
+  return ReadHeader(myChild.offset + myChild.size);
+}
+
+const char* HogReader::CurrentFileName() const
+{
+  return myChild.name;
+}
+
+unsigned int HogReader::CurrentFileSize() const
+{
+  return myChild.size;
+}
+
+uint64_t HogReader::CurrentFileOffset() const
+{
+  return myChild.offset;
+}
+
+const HogEntry& HogReader::CurrentEntry() const
+{
+  return myChild;
+}
+
+std::vector<HogEntry> HogReader::Entries()
+{
+  std::vector<HogEntry> entries;
+  for (auto file = begin(), last = end(); file != last; ++file)
+  {
+    entries.push_back(myChild);
+  }
+  return entries;
+}
+
+const File& HogReader::Archive() const
+{
+  return myFile;
+}
+
+std::vector<uint8_t> HogReader::CurrentFile() const
+{
+  std::vector<uint8_t> fileData;
+  if (!CurrentFile(&fileData)) fileData.clear();
+  return fileData;
+}
+
+bool HogReader::CurrentFile(std::vector<uint8_t>* data) const
+{
+  myIsReadingData = true;
+  return ReadEntry(myFile, myChild, data);
+}
+
+bool ReadEntry(const File& archive, const HogEntry& entry,
+               std::vector<uint8_t>* data)
+{
+  data->resize(entry.storedSize);
+  if (!archive.ReadAt(entry.offset, data->data(), entry.storedSize))
+  {
+    return false;
+  }
+  return DecodeEntry(entry, data);
+}
+
+bool DecodeEntry(const HogEntry& entry, std::vector<uint8_t>* data)
+{
+  if (entry.compression == HogStored) return data->size() == entry.size;
+  if (entry.compression != HogLz4) return false;
+
+  std::vector<uint8_t> decoded(entry.size);
+  if (!Lz4Decompress(data->data(), data->size(), decoded.data(),
+                     decoded.size()))
+  {
+    return false;
+  }
+  data->swap(decoded);
+  return true;
+}
+
+bool ReadCompressedTable(const File& archive, std::vector<HogEntry>* entries)
+{
+  const uint64_t archiveSize = archive.Size();
+
+  uint8_t header[compressedHeaderSize];
+  if (!archive.ReadAt(0, header, sizeof(header))) return false;
+  if (header[3] != compressedVersion) return false;
+
+  uint32_t count;
+  uint64_t tableOffset;
+  memcpy(&count, header + 4, 4);
+  memcpy(&tableOffset, header + 8, 8);
+
+  // The table is the last thing in the archive.
+  if (tableOffset < compressedHeaderSize || tableOffset > archiveSize ||
+      (archiveSize - tableOffset) / tableEntrySize != count ||
+      (archiveSize - tableOffset) % tableEntrySize != 0)
+  {
+    return false;
+  }
+
+  std::vector<uint8_t> table(count * tableEntrySize);
+  if (!archive.ReadAt(tableOffset, table.data(), table.size())) return false;
+
+  entries->resize(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const uint8_t* source = table.data() + i * tableEntrySize;
+    HogEntry& entry = (*entries)[i];
+    memcpy(entry.name, source, 13);
+    entry.name[12] = '\0';
+    entry.compression = source[13];
+    memcpy(&entry.size, source + 14, 4);
+    memcpy(&entry.storedSize, source + 18, 4);
+    memcpy(&entry.offset, source + 22, 8);
+
+    if (entry.compression != HogStored && entry.compression != HogLz4)
+    {
+      return false;
+    }
+    if (entry.compression == HogStored && entry.storedSize != entry.size)
+    {
+      return false;
+    }
+    if (entry.offset < compressedHeaderSize || entry.offset > tableOffset ||
+        entry.storedSize > tableOffset - entry.offset)
+    {
+      return false;
+    }
+  }
+  return true;
+}
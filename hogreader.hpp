@@ -29,8 +29,38 @@
 //                 | size - 4 bytes
 //                 | data - the size of this part is by the size before it.
 //
+//                Files with an empty name are padding (see HogWriter) and are
+//                skipped over. They are written by HogWriter when it aligns
+//                the data of the files, as the format has no other way to put
+//                space between the files. Such a padding file comes before
+//                each file whose data wouldn't otherwise be aligned, so an
+//                aligned archive has up to twice as many headers as it has
+//                files. None of the files listed by the reader (or by -l) are
+//                padding.
+//
+//                The reader also reads the compressed variant of the format
+//                which is written by CompressedHogWriter. Each file in it is
+//                compressed on its own and there is a table of the files at the
+//                end, so any one file can be read without reading the others.
+//
+//                 | "DHZ" - 3 bytes
+//                 | version - 1 byte
+//                 | file count - 4 bytes
+//                 | offset of the table - 8 bytes
+//                 |---------------- The stored data of each file
+//                 |---------------- The table, which has for each file:
+//                 | filename - 13 bytes
+//                 | compression - 1 byte, see HogCompression
+//                 | size - 4 bytes
+//                 | stored size - 4 bytes
+//                 | offset of the stored data - 8 bytes
+//
+//                The numbers are little endian in both formats.
+//
 //===----------------------------------------------------------------------===//
 
+#include "file.hpp"
+
 #include <memory>
 #include <vector>
 
@@ -46,6 +76,22 @@ struct HogFileHeader
 // Warning: The above structure is padded on x86 so you can not just read in the
 // whole thing.
 
+// How the data of a file is stored in the archive.
+enum HogCompression
+{
+  HogStored = 0, // As it is, which is how every file in a DHF archive is.
+  HogLz4 = 1 // As an LZ4 block.
+};
+
+struct HogEntry
+{
+  char name[13];
+  uint32_t size;
+  uint64_t offset; // The offset of the data from the start of the archive.
+  uint32_t storedSize; // The number of bytes the data takes in the archive.
+  uint8_t compression; // A HogCompression.
+};
+
 class HogReader
 {
 public:
@@ -58,22 +104,79 @@ public:
   // Returns true if the file was succesfully opened and the magic header is
   // correct.
 
+  bool IsCompressed() const;
+  // Returns true if the archive is the compressed variant of the format.
+
   bool NextFile();
 
-  std::vector<uint8_t> CurrentFile();
-  // Returns a copy of the data for the current file after reading it.
+  std::vector<uint8_t> CurrentFile() const;
+  bool CurrentFile(std::vector<uint8_t>* data) const;
+  // Returns a copy of the data for the current file after reading it, and
+  // decompressing it if it is compressed. The first is empty if that failed
+  // and the second returns false, so it can be told apart from an empty file.
+  //
+  // The data is read from its offset in the archive, so this may be called
+  // more than once for the same file.
 
   const char* CurrentFileName() const;
   unsigned int CurrentFileSize() const;
 
+  uint64_t CurrentFileOffset() const;
+  // Returns the offset from the start of the archive to the data of the
+  // current file.
+
+  const HogEntry& CurrentEntry() const;
+
+  std::vector<HogEntry> Entries();
+  // Returns the name, size and offset of every file in the archive. This
+  // leaves the current file at the end of the archive.
+
+  const File& Archive() const;
+  // Returns the underlying archive file, this is intended for copying the
+  // data of files without reading it in.
+
   iterator begin();
   iterator end();
 
 private:
-  FILE* myFile;
+  bool ReadHeader(uint64_t offset);
+  // Reads the header of the file which starts at the given offset and makes
+  // it the current file, skipping over any padding.
+
+  bool ReadTable();
+  // Reads the table of the files in a compressed archive, returns false if
+  // it isn't valid.
+
+  bool SelectEntry(size_t index);
+  // Makes the entry in the table of a compressed archive the current file.
+
+  File myFile;
+  uint64_t myFileSize;
   uint8_t myHeader[3];
-  bool hasReadFile;
-  HogFileHeader myChildFile;
+  HogEntry myChild;
+
+  // The table of the files of a compressed archive and the index in it of
+  // the current file.
+  std::vector<HogEntry> myTable;
+  size_t myTableIndex;
+
+  // Set once the data of a file has been read, from then on the data of each
+  // file is hinted to the system as its header is reached. This stops the
+  // walks which only need the names, such as listing the files or looking
+  // for one of them, from reading in the whole archive.
+  mutable bool myIsReadingData;
 };
 
+bool ReadEntry(const File& archive, const HogEntry& entry,
+               std::vector<uint8_t>* data);
+// Reads the data of the entry from the archive and decompresses it.
+
+bool DecodeEntry(const HogEntry& entry, std::vector<uint8_t>* data);
+// Replaces the stored data of the entry, as it was read from the archive,
+// with the data of the file. Returns false if it couldn't be decompressed.
+
+bool ReadCompressedTable(const File& archive, std::vector<HogEntry>* entries);
+// Reads the table of the files of a compressed archive, returns false if it
+// isn't valid.
+
 #endif
\ No newline at end of file
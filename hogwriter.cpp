@@ -0,0 +1,223 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : HogWriter
+// PURPOSE      : Providing an encoder for the Descent .HOG format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Builds a HOG file from files in memory, on disk or from
+//                another HOG file.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hogwriter.hpp"
+
+#include "hogreader.hpp"
+#include "lz4.hpp"
+
+#include <string.h>
+
+// The 3-byte MAGIC number at the start of the file format used to identifiy the
+// file as being a Descent HOG file.
+static const uint8_t magic[3] = { 'D', 'H', 'F' };
+
+// The size of the header which precedes the data of each file in the archive.
+static const uint32_t fileHeaderSize = 13 + 4;
+
+// The MAGIC number and version of the compressed variant of the format.
+static const uint8_t compressedMagic[3] = { 'D', 'H', 'Z' };
+static const uint8_t compressedVersion = 1;
+
+// The sizes of the header of a compressed archive and of each entry in its
+// table.
+static const uint64_t compressedHeaderSize = 3 + 1 + 4 + 8;
+static const size_t tableEntrySize = 13 + 1 + 4 + 4 + 8;
+
+HogWriter::HogWriter(const char* filename, uint32_t alignment)
+: myFile(filename, File::Create), myOffset(0),
+  myAlignment(alignment > 1 ? alignment : 0)
+{
+  if (myFile.WriteAt(0, magic, sizeof(magic))) myOffset = sizeof(magic);
+}
+
+bool HogWriter::IsValid() const
+{
+  return myFile.IsValid() && myOffset > 0;
+}
+
+bool HogWriter::IsValidName(const char* name)
+{
+  return name[0] != '\0' && strlen(name) < 13;
+}
+
+bool HogWriter::BeginFile(const char* name, uint32_t size)
+{
+  if (!IsValid() || !IsValidName(name)) return false;
+
+  if (myAlignment)
+  {
+    // Insert a padding file so that the data following the header for this
+    // file starts on the boundary. The padding file itself needs a header so
+    // it is either nothing or at least the size of a header.
+    const uint64_t dataOffset = myOffset + fileHeaderSize;
+    uint64_t padding = (myAlignment - dataOffset % myAlignment) % myAlignment;
+    while (padding > 0 && padding < fileHeaderSize) padding += myAlignment;
+
+    if (padding > 0)
+    {
+      uint8_t header[fileHeaderSize] = {};
+      const uint32_t paddingSize =
+          static_cast<uint32_t>(padding - fileHeaderSize);
+      memcpy(header + 13, &paddingSize, 4);
+      if (!myFile.WriteAt(myOffset, header, sizeof(header))) return false;
+
+      // Write the last byte of the padding rather than all of it, the rest is
+      // left as a hole which reads back as zeros.
+      if (paddingSize > 0)
+      {
+        const uint8_t zero = 0;
+        if (!myFile.WriteAt(myOffset + padding - 1, &zero, 1)) return false;
+      }
+      myOffset += padding;
+    }
+  }
+
+  uint8_t header[fileHeaderSize] = {};
+  memcpy(header, name, strlen(name));
+  memcpy(header + 13, &size, 4);
+  if (!myFile.WriteAt(myOffset, header, sizeof(header))) return false;
+  myOffset += fileHeaderSize;
+  return true;
+}
+
+bool HogWriter::AddFile(const char* name, const uint8_t* data, uint32_t size)
+{
+  if (!BeginFile(name, size)) return false;
+  if (!myFile.WriteAt(myOffset, data, size)) return false;
+  myOffset += size;
+  return true;
+}
+
+bool HogWriter::AddFile(const char* name, const std::vector<uint8_t>& data)
+{
+  if (data.size() > UINT32_MAX) return false;
+  return AddFile(name, data.data(), static_cast<uint32_t>(data.size()));
+}
+
+bool HogWriter::AddFile(const char* name, const File& source, uint64_t offset,
+                        uint32_t size)
+{
+  if (!BeginFile(name, size)) return false;
+  if (!myFile.CopyFrom(source, offset, myOffset, size)) return false;
+  myOffset += size;
+  return true;
+}
+
+bool HogWriter::AddFileFromDisk(const char* name, const char* path)
+{
+  const File source(path);
+  if (!source.IsValid()) return false;
+
+  const uint64_t size = source.Size();
+  if (size > UINT32_MAX) return false;
+  return AddFile(name, source, 0, static_cast<uint32_t>(size));
+}
+
+bool HogWriter::AddCurrentFile(const HogReader& reader)
+{
+  if (reader.CurrentEntry().compression != HogStored)
+  {
+    std::vector<uint8_t> data;
+    if (!reader.CurrentFile(&data)) return false;
+    return AddFile(reader.CurrentFileName(), data);
+  }
+
+  return AddFile(reader.CurrentFileName(), reader.Archive(),
+                 reader.CurrentFileOffset(), reader.CurrentFileSize());
+}
+
+CompressedHogWriter::CompressedHogWriter(const char* filename)
+: myFile(filename, File::Create), myOffset(0), myCount(0),
+  myIsFinished(false)
+{
+  // The header is written again by Finish() once the table is written.
+  uint8_t header[compressedHeaderSize] = {};
+  memcpy(header, compressedMagic, sizeof(compressedMagic));
+  header[3] = compressedVersion;
+  if (myFile.WriteAt(0, header, sizeof(header)))
+  {
+    myOffset = compressedHeaderSize;
+  }
+}
+
+CompressedHogWriter::~CompressedHogWriter()
+{
+  if (!myIsFinished) Finish();
+}
+
+bool CompressedHogWriter::IsValid() const
+{
+  return myFile.IsValid() && myOffset > 0 && !myIsFinished;
+}
+
+uint8_t CompressedHogWriter::Compress(const uint8_t* data, uint32_t size,
+                                      std::vector<uint8_t>* stored)
+{
+  stored->resize(Lz4CompressBound(size));
+  const size_t compressedSize = Lz4Compress(data, size, stored->data());
+  if (compressedSize < size)
+  {
+    stored->resize(compressedSize);
+    return HogLz4;
+  }
+
+  stored->assign(data, data + size);
+  return HogStored;
+}
+
+bool CompressedHogWriter::AddStoredFile(const char* name, uint32_t size,
+                                        uint8_t compression,
+                                        const std::vector<uint8_t>& stored)
+{
+  if (!IsValid() || !HogWriter::IsValidName(name)) return false;
+  if (stored.size() > UINT32_MAX) return false;
+  if (!myFile.WriteAt(myOffset, stored.data(), stored.size())) return false;
+
+  const uint32_t storedSize = static_cast<uint32_t>(stored.size());
+  uint8_t entry[tableEntrySize] = {};
+  memcpy(entry, name, strlen(name));
+  entry[13] = compression;
+  memcpy(entry + 14, &size, 4);
+  memcpy(entry + 18, &storedSize, 4);
+  memcpy(entry + 22, &myOffset, 8);
+  myTable.insert(myTable.end(), entry, entry + sizeof(entry));
+
+  myOffset += storedSize;
+  ++myCount;
+  return true;
+}
+
+bool CompressedHogWriter::AddFile(const char* name,
+                                  const std::vector<uint8_t>& data)
+{
+  if (data.size() > UINT32_MAX) return false;
+
+  const uint32_t size = static_cast<uint32_t>(data.size());
+  std::vector<uint8_t> stored;
+  const uint8_t compression = Compress(data.data(), size, &stored);
+  return AddStoredFile(name, size, compression, stored);
+}
+
+bool CompressedHogWriter::Finish()
+{
+  if (!IsValid()) return false;
+  myIsFinished = true;
+
+  if (!myFile.WriteAt(myOffset, myTable.data(), myTable.size())) return false;
+
+  uint8_t header[compressedHeaderSize - sizeof(compressedMagic) - 1];
+  memcpy(header, &myCount, 4);
+  memcpy(header + 4, &myOffset, 8);
+  return myFile.WriteAt(sizeof(compressedMagic) + 1, header, sizeof(header));
+}
@@ -0,0 +1,112 @@
+#ifndef HOG_WRITER_HPP_GUARD
+#define HOG_WRITER_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : HogWriter
+// PURPOSE      : Providing an encoder for the Descent .HOG format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Builds a HOG file from files in memory, on disk or from
+//                another HOG file. See hogreader.hpp for the file format.
+//
+//                The data of each file can optionally be aligned to a given
+//                boundary (such as a cache line or page) so memory mapped
+//                readers can use the data in-place. This is done by inserting
+//                padding files which have an empty name between them, these
+//                are skipped over by the HogReader. Each padding file takes
+//                up a header of its own, so readers which expect a header per
+//                file (such as the game, which only has room for a limited
+//                number of them) see more files than were added.
+//
+//                CompressedHogWriter builds the compressed variant instead,
+//                which the HogReader reads the same way. Compressing is kept
+//                apart from adding so the files can be compressed on many
+//                threads and then added in order.
+//
+//===----------------------------------------------------------------------===//
+
+#include "file.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+class HogReader;
+
+class HogWriter
+{
+public:
+  HogWriter(const char* filename, uint32_t alignment = 0);
+  // The alignment is the boundary in bytes which the data of each file should
+  // start on, a value of 0 or 1 means the data is not aligned.
+
+  bool IsValid() const;
+  // Returns true if the file was succesfully created.
+
+  bool AddFile(const char* name, const uint8_t* data, uint32_t size);
+  bool AddFile(const char* name, const std::vector<uint8_t>& data);
+  // Adds a file with the given name and data from memory.
+
+  bool AddFile(const char* name, const File& source, uint64_t offset,
+               uint32_t size);
+  // Adds a file with the given name where the data is size bytes starting at
+  // offset in the source file.
+
+  bool AddFileFromDisk(const char* name, const char* path);
+  // Adds the file at the given path with the given name.
+
+  bool AddCurrentFile(const HogReader& reader);
+  // Adds the current file of the given reader. The data is copied directly
+  // from one archive to the other, unless it is compressed in which case it
+  // is decompressed first.
+
+  static bool IsValidName(const char* name);
+  // Returns true if the name fits into a header (at most 12 characters).
+
+private:
+  bool BeginFile(const char* name, uint32_t size);
+  // Writes the header for a file (and any padding before it).
+
+  File myFile;
+  uint64_t myOffset;
+  uint32_t myAlignment;
+};
+
+class CompressedHogWriter
+{
+public:
+  CompressedHogWriter(const char* filename);
+
+  ~CompressedHogWriter();
+  // Finishes the archive if Finish() hasn't been called.
+
+  bool IsValid() const;
+  // Returns true if the file was succesfully created.
+
+  static uint8_t Compress(const uint8_t* data, uint32_t size,
+                          std::vector<uint8_t>* stored);
+  // Compresses the data into stored and returns the HogCompression it used.
+  // Data which doesn't get any smaller is stored as it is.
+
+  bool AddStoredFile(const char* name, uint32_t size, uint8_t compression,
+                     const std::vector<uint8_t>& stored);
+  // Adds a file which was compressed by Compress(), where size is the size
+  // of the data before it was compressed.
+
+  bool AddFile(const char* name, const std::vector<uint8_t>& data);
+  // Compresses and adds a file with the given name and data from memory.
+
+  bool Finish();
+  // Writes the table of the files, no more can be added after this.
+
+private:
+  File myFile;
+  uint64_t myOffset;
+  std::vector<uint8_t> myTable;
+  uint32_t myCount;
+  bool myIsFinished;
+};
+
+#endif
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Image
+// PURPOSE      : Providing the decoded form of the images and palettes.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Reads palettes and expands indices into colours.
+//
+//===----------------------------------------------------------------------===//
+
+#include "image.hpp"
+
+#include <string.h>
+
+bool ReadPalette(const uint8_t* data, size_t size, Palette* palette)
+{
+  if (size < sizeof(palette->colours)) return false;
+
+  // Expand from 6 bits to 8 bits so that 63 becomes 255.
+  for (int i = 0; i < 256; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      const uint8_t value = data[i * 3 + j] & 0x3F;
+      palette->colours[i][j] = static_cast<uint8_t>(value << 2 | value >> 4);
+    }
+  }
+  return true;
+}
+
+Image PaletteImage(const Palette& palette)
+{
+  uint8_t indices[256];
+  for (int i = 0; i < 256; ++i) indices[i] = static_cast<uint8_t>(i);
+
+  Image image;
+  image.width = 16;
+  image.height = 16;
+  image.pixels.resize(256 * 4);
+  ExpandPalette(indices, 256, palette, image.pixels.data());
+  return image;
+}
+
+void ExpandPalette(const uint8_t* indices, size_t count,
+                   const Palette& palette, uint8_t* pixels, int transparent)
+{
+  // Look up a whole pixel at a time from a table of the colours packed in the
+  // order they are in memory, the loop is then just a load and a store.
+  uint32_t colours[256];
+  for (int i = 0; i < 256; ++i)
+  {
+    const uint8_t colour[4] = { palette.colours[i][0], palette.colours[i][1],
+                                palette.colours[i][2],
+                                static_cast<uint8_t>(i == transparent ? 0 :
+                                                                        255) };
+    memcpy(&colours[i], colour, sizeof(colour));
+  }
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    memcpy(pixels + i * 4, &colours[indices[i]], 4);
+  }
+}
@@ -0,0 +1,57 @@
+#ifndef IMAGE_HPP_GUARD
+#define IMAGE_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Image
+// PURPOSE      : Providing the decoded form of the images and palettes.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The images in the game are made up of indices into a palette
+//                of 256 colours, which are expanded to red, green, blue and
+//                alpha for each pixel when they are decoded.
+//
+//                The palettes (with the extension 256) have 3 bytes for each
+//                colour where each is from 0 to 63 as that is what the VGA
+//                hardware used, which may be followed by the tables used for
+//                fading colours.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Image
+{
+  uint32_t width;
+  uint32_t height;
+
+  // The red, green, blue and alpha of each pixel, a row at a time from the
+  // top of the image.
+  std::vector<uint8_t> pixels;
+};
+
+struct Palette
+{
+  // The red, green and blue of each colour, from 0 to 255.
+  uint8_t colours[256][3];
+};
+
+bool ReadPalette(const uint8_t* data, size_t size, Palette* palette);
+// Reads a palette from a .256 file. Returns false if it is too small to be
+// one.
+
+Image PaletteImage(const Palette& palette);
+// Returns a 16 by 16 image with a pixel for each colour of the palette.
+
+void ExpandPalette(const uint8_t* indices, size_t count,
+                   const Palette& palette, uint8_t* pixels,
+                   int transparent = -1);
+// Sets the red, green, blue and alpha of count pixels from the colours of the
+// palette at the given indices. The colour at the transparent index (if it
+// isn't -1) has an alpha of 0.
+
+#endif
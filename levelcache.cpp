@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelCache
+// PURPOSE      : Providing the geometry of levels without decoding them again
+//                each time they are needed.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Decodes the levels which aren't in the cache.
+//
+//===----------------------------------------------------------------------===//
+
+#include "levelcache.hpp"
+
+#include <ctype.h>
+
+size_t LevelBytes(const DecodedLevel& level)
+{
+  return sizeof(level) + level.vertices.capacity() * sizeof(Vertex) +
+         level.cubes.capacity() * sizeof(Cube) +
+         level.quads.capacity() * sizeof(Quad) +
+         level.lights.capacity() * sizeof(CubeLights);
+}
+
+std::shared_ptr<const DecodedLevel> CachedLevel(
+  LevelCache& cache, const std::string& archive, const std::string& entry,
+  const LevelReader& read)
+{
+  std::string name(entry);
+  for (auto c = name.begin(); c != name.end(); ++c)
+  {
+    *c = static_cast<char>(tolower(*c));
+  }
+
+  const auto cached = cache.Find(archive, name);
+  if (cached) return cached;
+
+  std::vector<uint8_t> data;
+  if (!read(&data)) return nullptr;
+
+  const RdlReader reader(data);
+  if (!reader.IsValid()) return nullptr;
+
+  std::shared_ptr<DecodedLevel> level(new DecodedLevel);
+  level->vertices = reader.Vertices();
+  level->cubes.resize(reader.CubeCount());
+  level->lights.resize(level->cubes.size());
+  reader.ReadCubes(level->cubes.data(), level->lights.data());
+  level->quads = Quads(level->cubes);
+  return cache.Insert(archive, name, level, LevelBytes(*level));
+}
@@ -0,0 +1,57 @@
+#ifndef LEVEL_CACHE_HPP_GUARD
+#define LEVEL_CACHE_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelCache
+// PURPOSE      : Providing the geometry of levels without decoding them again
+//                each time they are needed.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A decoded level is the vertices, cubes and quads of a level,
+//                which is what most of the exporters and queries start from,
+//                and the light at the corners of the sides of its cubes.
+//
+//===----------------------------------------------------------------------===//
+
+#include "cube.hpp"
+#include "entrycache.hpp"
+#include "quads.hpp"
+#include "rdl.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct DecodedLevel
+{
+  std::vector<Vertex> vertices;
+  std::vector<Cube> cubes;
+  std::vector<Quad> quads;
+  std::vector<CubeLights> lights;
+};
+
+typedef EntryCache<DecodedLevel> LevelCache;
+
+size_t LevelBytes(const DecodedLevel& level);
+// Returns the number of bytes the level takes up in memory.
+
+typedef std::function<bool(std::vector<uint8_t>* data)> LevelReader;
+// Reads the data of a level, returning false if it can't be read.
+
+std::shared_ptr<const DecodedLevel> CachedLevel(
+  LevelCache& cache, const std::string& archive, const std::string& entry,
+  const LevelReader& read);
+// Returns the level from the cache, otherwise reads the data of the entry
+// with read, decodes it and adds it to the cache. Returns nullptr if the data
+// can't be read or isn't a valid level.
+//
+// The names of files in an archive aren't case sensitive, so the entry is
+// looked up by its name in lower case.
+
+#endif
@@ -0,0 +1,270 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelCheck
+// PURPOSE      : Providing checks that the parts of a level agree with each
+//                other.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The shape of a cube is checked by splitting each side into
+//                the same two triangles as the game and measuring the volume
+//                between each triangle and the centre of the cube. The corners
+//                of every side go around it in the same direction, which is
+//                clockwise when seen from outside of the cube, so the normal
+//                of each triangle points into the cube and every volume is
+//                positive for a cube which is the right way out.
+//
+//===----------------------------------------------------------------------===//
+
+#include "levelcheck.hpp"
+
+#include "cube.hpp"
+#include "geometry.hpp"
+#include "object.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#include <stdio.h>
+
+// The number of cubes in a block, which is small enough that the cubes of
+// even a small level are split between the threads.
+static const size_t blockSize = 256;
+
+// A cube with less volume than this is treated as flat. A standard cube is 20
+// units across so has a volume of 8000.
+static const double minimumVolume = 1e-3;
+
+// A neighbour of -2 is where the exit of the level is.
+static const int16_t exitSide = -2;
+
+namespace
+{
+  // Returns six times the volume of the tetrahedron between the triangle and
+  // the point, which is positive if the normal of the triangle, (b - a) x
+  // (c - a), faces towards the point.
+  double volume(const Vertex& a, const Vertex& b, const Vertex& c,
+                const Vertex& point)
+  {
+    const double u[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+    const double v[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+    const double w[3] = { point.x - a.x, point.y - a.y, point.z - a.z };
+    return (u[1] * v[2] - u[2] * v[1]) * w[0] +
+           (u[2] * v[0] - u[0] * v[2]) * w[1] +
+           (u[0] * v[1] - u[1] * v[0]) * w[2];
+  }
+
+  void writeString(const std::string& text, std::ostream& output)
+  {
+    output << '"';
+    for (auto c = text.begin(); c != text.end(); ++c)
+    {
+      const unsigned char character = static_cast<unsigned char>(*c);
+      if (character == '"' || character == '\\')
+      {
+        output << '\\' << *c;
+      }
+      else if (character < 0x20)
+      {
+        char escaped[8];
+        snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+        output << escaped;
+      }
+      else
+      {
+        output << *c;
+      }
+    }
+    output << '"';
+  }
+}
+
+LevelChecker::LevelChecker(const RdlReader& level)
+: myIsValid(level.IsValid())
+{
+  if (!myIsValid) return;
+
+  myVertices = level.Vertices();
+  myCubes = level.Cubes();
+  myWalls = level.Walls();
+}
+
+size_t LevelChecker::BlockCount() const
+{
+  // A level which isn't valid has a single block for reporting that.
+  if (!myIsValid) return 1;
+  return (myCubes.size() + blockSize - 1) / blockSize;
+}
+
+void LevelChecker::CheckBlock(size_t block,
+                              std::vector<LevelDiagnostic>* diagnostics) const
+{
+  if (!myIsValid)
+  {
+    const LevelDiagnostic diagnostic = { InvalidLevel, -1, -1, -1 };
+    diagnostics->push_back(diagnostic);
+    return;
+  }
+
+  const size_t end = std::min(myCubes.size(), (block + 1) * blockSize);
+  for (size_t i = block * blockSize; i < end; ++i)
+  {
+    CheckCube(static_cast<int32_t>(i), diagnostics);
+  }
+}
+
+void LevelChecker::CheckCube(int32_t index,
+                             std::vector<LevelDiagnostic>* diagnostics) const
+{
+  const Cube& cube = myCubes[index];
+  const auto report = [=](LevelCheck check, int32_t side, int32_t value)
+  {
+    const LevelDiagnostic diagnostic = { check, index, side, value };
+    diagnostics->push_back(diagnostic);
+  };
+
+  // The neighbours.
+  const int32_t cubeCount = static_cast<int32_t>(myCubes.size());
+  for (int side = 0; side < 6; ++side)
+  {
+    const int16_t neighbor = cube.neighbors[side];
+    if (neighbor == -1 || neighbor == exitSide) continue;
+    if (neighbor < 0 || neighbor >= cubeCount)
+    {
+      report(NeighborOutOfRange, side, neighbor);
+      continue;
+    }
+
+    bool isJoinedBack = false;
+    for (int otherSide = 0; otherSide < 6; ++otherSide)
+    {
+      if (myCubes[neighbor].neighbors[otherSide] == index) isJoinedBack = true;
+    }
+    if (!isJoinedBack) report(NeighborNotSymmetric, side, neighbor);
+  }
+
+  // The walls.
+  for (int side = 0; side < 6; ++side)
+  {
+    const uint8_t wall = cube.walls[side];
+    if (wall == 255) continue;
+    if (wall >= myWalls.size())
+    {
+      report(WallOutOfRange, side, wall);
+      continue;
+    }
+
+    if (myWalls[wall].cube != index || myWalls[wall].side != side)
+    {
+      report(WallMismatch, side, wall);
+    }
+  }
+
+  // The shape, which can only be measured if the vertices are valid.
+  bool isMeasurable = true;
+  for (int i = 0; i < 8; ++i)
+  {
+    if (cube.vertices[i] >= myVertices.size())
+    {
+      report(VertexOutOfRange, -1, cube.vertices[i]);
+      isMeasurable = false;
+    }
+
+    for (int j = 0; j < i && isMeasurable; ++j)
+    {
+      if (cube.vertices[i] != cube.vertices[j]) continue;
+      report(DegenerateCube, -1, cube.vertices[i]);
+      isMeasurable = false;
+    }
+  }
+  if (!isMeasurable) return;
+
+  Vertex centre = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < 8; ++i)
+  {
+    const Vertex& vertex = myVertices[cube.vertices[i]];
+    centre.x += vertex.x / 8;
+    centre.y += vertex.y / 8;
+    centre.z += vertex.z / 8;
+  }
+
+  double sideVolumes[6];
+  double total = 0.0;
+  for (int side = 0; side < 6; ++side)
+  {
+    const Vertex& a = myVertices[cube.vertices[sideVertices[side][0]]];
+    const Vertex& b = myVertices[cube.vertices[sideVertices[side][1]]];
+    const Vertex& c = myVertices[cube.vertices[sideVertices[side][2]]];
+    const Vertex& d = myVertices[cube.vertices[sideVertices[side][3]]];
+    const double first = volume(a, b, c, centre);
+    const double second = volume(a, c, d, centre);
+    sideVolumes[side] = first < second ? first : second;
+    total += first + second;
+  }
+
+  total /= 6;
+  if (total < -minimumVolume)
+  {
+    report(InvertedCube, -1, -1);
+  }
+  else if (total <= minimumVolume)
+  {
+    report(DegenerateCube, -1, -1);
+  }
+  else
+  {
+    for (int side = 0; side < 6; ++side)
+    {
+      if (sideVolumes[side] < 0.0) report(InvertedSide, side, -1);
+    }
+  }
+}
+
+std::vector<LevelDiagnostic> CheckLevel(const RdlReader& level)
+{
+  const LevelChecker checker(level);
+  std::vector<std::vector<LevelDiagnostic>> blocks(checker.BlockCount());
+  ParallelFor(blocks.size(), [&checker, &blocks](size_t i, size_t)
+  {
+    checker.CheckBlock(i, &blocks[i]);
+  });
+
+  std::vector<LevelDiagnostic> diagnostics;
+  for (auto block = blocks.begin(); block != blocks.end(); ++block)
+  {
+    diagnostics.insert(diagnostics.end(), block->begin(), block->end());
+  }
+  return diagnostics;
+}
+
+const char* CheckName(LevelCheck check)
+{
+  switch (check)
+  {
+  case InvalidLevel: return "invalid-level";
+  case VertexOutOfRange: return "vertex-out-of-range";
+  case DegenerateCube: return "degenerate-cube";
+  case InvertedCube: return "inverted-cube";
+  case InvertedSide: return "inverted-side";
+  case NeighborOutOfRange: return "neighbor-out-of-range";
+  case NeighborNotSymmetric: return "neighbor-not-symmetric";
+  case WallOutOfRange: return "wall-out-of-range";
+  case WallMismatch: return "wall-mismatch";
+  }
+  return "unknown";
+}
+
+void WriteDiagnostic(const std::string& archive, const std::string& level,
+                     const LevelDiagnostic& diagnostic, std::ostream& output)
+{
+  output << "{\"archive\":";
+  writeString(archive, output);
+  output << ",\"level\":";
+  writeString(level, output);
+  output << ",\"check\":\"" << CheckName(diagnostic.check) << "\""
+         << ",\"cube\":" << diagnostic.cube
+         << ",\"side\":" << diagnostic.side
+         << ",\"value\":" << diagnostic.value << "}\n";
+}
@@ -0,0 +1,94 @@
+#ifndef LEVEL_CHECK_HPP_GUARD
+#define LEVEL_CHECK_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelCheck
+// PURPOSE      : Providing checks that the parts of a level agree with each
+//                other.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The checks are of each cube on its own against the rest of
+//                the level, so the cubes are split into blocks which can be
+//                checked at the same time, including blocks from different
+//                levels.
+//
+//                The problems are written out as JSON, one object per line:
+//
+//                  {"archive":"a.hog","level":"b.rdl","check":"wall-mismatch",
+//                   "cube":3,"side":2,"value":7}
+//
+//                where the side and the value are -1 if they don't apply. The
+//                value is the vertex, the neighbouring cube or the wall that is
+//                involved.
+//
+//===----------------------------------------------------------------------===//
+
+#include "rdl.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+struct Wall;
+
+enum LevelCheck
+{
+  InvalidLevel, // The level couldn't be decoded at all.
+  VertexOutOfRange, // A cube uses a vertex that doesn't exist.
+  DegenerateCube, // A cube uses a vertex twice or has no volume.
+  InvertedCube, // A cube is inside out.
+  InvertedSide, // A side of a cube faces into it.
+  NeighborOutOfRange, // A side is joined to a cube that doesn't exist.
+  NeighborNotSymmetric, // A side is joined to a cube which isn't joined back.
+  WallOutOfRange, // A side has a wall that isn't in the table of walls.
+  WallMismatch // A side has a wall which is for a different side.
+};
+
+struct LevelDiagnostic
+{
+  LevelCheck check;
+  int32_t cube; // The cube with the problem, or -1 for the whole level.
+  int32_t side;
+  int32_t value;
+};
+
+class LevelChecker
+{
+public:
+  LevelChecker(const RdlReader& level);
+  // Decodes the parts of the level that are checked.
+
+  size_t BlockCount() const;
+
+  void CheckBlock(size_t block,
+                  std::vector<LevelDiagnostic>* diagnostics) const;
+  // Adds the problems with the cubes in the block to the diagnostics. It is
+  // safe to check different blocks at the same time.
+
+private:
+  void CheckCube(int32_t index,
+                 std::vector<LevelDiagnostic>* diagnostics) const;
+
+  bool myIsValid;
+  std::vector<Vertex> myVertices;
+  std::vector<Cube> myCubes;
+  std::vector<Wall> myWalls;
+};
+
+std::vector<LevelDiagnostic> CheckLevel(const RdlReader& level);
+// Returns the problems with the level, the blocks are checked in parallel.
+
+const char* CheckName(LevelCheck check);
+// Returns the name that the check is written out as.
+
+void WriteDiagnostic(const std::string& archive, const std::string& level,
+                     const LevelDiagnostic& diagnostic, std::ostream& output);
+// Writes the diagnostic out as a line of JSON.
+
+#endif
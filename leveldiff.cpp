@@ -0,0 +1,337 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelDiff
+// PURPOSE      : Providing what has changed between two versions of a level.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The contents of a cube are copied into a fixed layout which is
+//                hashed, and compared part by part for the modified cubes.
+//
+//===----------------------------------------------------------------------===//
+
+#include "leveldiff.hpp"
+
+#include "cube.hpp"
+#include "hash.hpp"
+#include "object.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <math.h>
+#include <string.h>
+
+// How far apart the centres of two cubes may be for one to be a modified
+// version of the other. A standard cube is 20 units across.
+static const double matchDistance = 10.0;
+
+namespace
+{
+  // The parts of a wall which aren't the numbers of other things.
+  struct WallContent
+  {
+    double hitPoints;
+    uint8_t isPresent;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t state;
+    uint8_t hasTrigger;
+    int8_t clip;
+    uint8_t keys;
+  };
+
+  // What a cube is made of, this is filled with zeros first so the padding
+  // doesn't change the hash.
+  struct CubeContent
+  {
+    Vertex positions[8];
+    uint8_t neighbors; // A bit for each side which has a neighbour.
+    uint8_t special;
+    int8_t matcen;
+    int16_t value;
+    double lighting;
+    WallContent walls[6];
+    Texture textures[6];
+  };
+
+  struct Level
+  {
+    Level(const RdlReader& reader)
+    : vertices(reader.Vertices()), cubes(reader.Cubes()),
+      walls(reader.Walls())
+    {
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<Cube> cubes;
+    std::vector<Wall> walls;
+  };
+
+  Vertex position(const Level& level, uint16_t vertex)
+  {
+    const Vertex origin = { 0.0, 0.0, 0.0 };
+    return vertex < level.vertices.size() ? level.vertices[vertex] : origin;
+  }
+
+  void describe(const Level& level, size_t index, CubeContent* content)
+  {
+    memset(content, 0, sizeof(*content));
+
+    const Cube& cube = level.cubes[index];
+    for (int i = 0; i < 8; ++i)
+    {
+      content->positions[i] = position(level, cube.vertices[i]);
+    }
+
+    for (int side = 0; side < 6; ++side)
+    {
+      if (cube.neighbors[side] != -1) content->neighbors |= 1 << side;
+
+      // A wall which isn't in the table of walls (if it couldn't be read) is
+      // only known to be there.
+      WallContent& wall = content->walls[side];
+      if (cube.walls[side] == 255) continue;
+      wall.isPresent = 1;
+      if (cube.walls[side] >= level.walls.size()) continue;
+
+      const Wall& source = level.walls[cube.walls[side]];
+      wall.hitPoints = source.hitPoints;
+      wall.type = source.type;
+      wall.flags = source.flags;
+      wall.state = source.state;
+      wall.hasTrigger = source.trigger != -1;
+      wall.clip = source.clip;
+      wall.keys = source.keys;
+    }
+
+    for (int side = 0; side < 6; ++side)
+    {
+      const Texture& texture = cube.textures[side];
+      content->textures[side].primaryTextureNumber =
+        texture.primaryTextureNumber;
+      if (texture.primaryTextureNumber & 0x8000)
+      {
+        content->textures[side].secondaryTextureNumber =
+          texture.secondaryTextureNumber;
+      }
+    }
+
+    content->special = cube.special;
+    content->matcen = cube.matcen;
+    content->value = cube.value;
+    content->lighting = cube.lighting;
+  }
+
+  uint8_t changedParts(const CubeContent& a, const CubeContent& b)
+  {
+    uint8_t parts = 0;
+    if (memcmp(a.positions, b.positions, sizeof(a.positions)) != 0)
+    {
+      parts |= CubeVerticesChanged;
+    }
+    if (a.neighbors != b.neighbors) parts |= CubeNeighborsChanged;
+    if (memcmp(a.walls, b.walls, sizeof(a.walls)) != 0)
+    {
+      parts |= CubeWallsChanged;
+    }
+    if (memcmp(a.textures, b.textures, sizeof(a.textures)) != 0)
+    {
+      parts |= CubeTexturesChanged;
+    }
+    if (a.lighting != b.lighting) parts |= CubeLightingChanged;
+    if (a.special != b.special || a.matcen != b.matcen || a.value != b.value)
+    {
+      parts |= CubeSpecialChanged;
+    }
+    return parts;
+  }
+
+  Vertex centre(const CubeContent& content)
+  {
+    Vertex sum = { 0.0, 0.0, 0.0 };
+    for (int i = 0; i < 8; ++i)
+    {
+      sum.x += content.positions[i].x;
+      sum.y += content.positions[i].y;
+      sum.z += content.positions[i].z;
+    }
+    const Vertex middle = { sum.x / 8, sum.y / 8, sum.z / 8 };
+    return middle;
+  }
+
+  // Returns the key of the cell of the grid that the point is in, the cells
+  // are as wide as the match distance so a match is in one of the 27 cells
+  // around the one the centre is in.
+  uint64_t cellKey(int64_t x, int64_t y, int64_t z)
+  {
+    const uint64_t mask = (uint64_t(1) << 21) - 1;
+    return ((uint64_t(x) & mask) << 42) | ((uint64_t(y) & mask) << 21) |
+           (uint64_t(z) & mask);
+  }
+
+  int64_t cell(double coordinate)
+  {
+    return static_cast<int64_t>(floor(coordinate / matchDistance));
+  }
+}
+
+LevelDiff DiffLevels(const RdlReader& before, const RdlReader& after)
+{
+  const Level levels[2] = { Level(before), Level(after) };
+
+  std::vector<CubeContent> contents[2];
+  std::vector<uint64_t> hashes[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    contents[i].resize(levels[i].cubes.size());
+    hashes[i].resize(levels[i].cubes.size());
+    for (size_t cube = 0; cube < levels[i].cubes.size(); ++cube)
+    {
+      describe(levels[i], cube, &contents[i][cube]);
+      hashes[i][cube] = Hash64(&contents[i][cube], sizeof(CubeContent));
+    }
+  }
+
+  // The cube in the other level which each cube is matched with.
+  const int32_t none = -1;
+  std::vector<int32_t> matches[2] = {
+    std::vector<int32_t>(levels[0].cubes.size(), none),
+    std::vector<int32_t>(levels[1].cubes.size(), none)
+  };
+
+  // Cubes with the same hash are unchanged, the hashes are checked for
+  // collisions by comparing the contents.
+  std::unordered_multimap<uint64_t, int32_t> byHash;
+  byHash.reserve(hashes[1].size());
+  for (size_t cube = 0; cube < hashes[1].size(); ++cube)
+  {
+    byHash.insert(std::make_pair(hashes[1][cube], int32_t(cube)));
+  }
+
+  LevelDiff diff;
+  diff.unchangedCount = 0;
+  for (size_t cube = 0; cube < hashes[0].size(); ++cube)
+  {
+    const auto range = byHash.equal_range(hashes[0][cube]);
+    for (auto candidate = range.first; candidate != range.second;
+         ++candidate)
+    {
+      if (memcmp(&contents[0][cube], &contents[1][candidate->second],
+                 sizeof(CubeContent)) != 0)
+      {
+        continue;
+      }
+
+      matches[0][cube] = candidate->second;
+      matches[1][candidate->second] = int32_t(cube);
+      byHash.erase(candidate);
+      ++diff.unchangedCount;
+      break;
+    }
+  }
+
+  // The cubes which are left are matched with the nearest one left in the
+  // other level, if it is close enough.
+  std::unordered_multimap<uint64_t, int32_t> byCell;
+  std::vector<Vertex> centres(levels[1].cubes.size());
+  for (size_t cube = 0; cube < levels[1].cubes.size(); ++cube)
+  {
+    if (matches[1][cube] != none) continue;
+
+    centres[cube] = centre(contents[1][cube]);
+    byCell.insert(std::make_pair(
+      cellKey(cell(centres[cube].x), cell(centres[cube].y),
+              cell(centres[cube].z)), int32_t(cube)));
+  }
+
+  std::vector<CubeChange> removed;
+  std::vector<CubeChange> modified;
+  for (size_t cube = 0; cube < levels[0].cubes.size(); ++cube)
+  {
+    if (matches[0][cube] != none) continue;
+
+    const Vertex middle = centre(contents[0][cube]);
+    const int64_t x = cell(middle.x), y = cell(middle.y), z = cell(middle.z);
+
+    int32_t nearest = none;
+    double nearestDistance = matchDistance * matchDistance;
+    for (int i = 0; i < 27; ++i)
+    {
+      const auto range = byCell.equal_range(
+        cellKey(x + i % 3 - 1, y + i / 3 % 3 - 1, z + i / 9 - 1));
+      for (auto candidate = range.first; candidate != range.second;
+           ++candidate)
+      {
+        const int32_t other = candidate->second;
+        if (matches[1][other] != none) continue;
+
+        const Vertex& otherMiddle = centres[other];
+        const double dx = otherMiddle.x - middle.x;
+        const double dy = otherMiddle.y - middle.y;
+        const double dz = otherMiddle.z - middle.z;
+        const double distance = dx * dx + dy * dy + dz * dz;
+        if (distance <= nearestDistance)
+        {
+          nearest = other;
+          nearestDistance = distance;
+        }
+      }
+    }
+
+    if (nearest == none)
+    {
+      const CubeChange change = { CubeRemoved, int32_t(cube), none, 0 };
+      removed.push_back(change);
+      continue;
+    }
+
+    matches[0][cube] = nearest;
+    matches[1][nearest] = int32_t(cube);
+    const CubeChange change = {
+      CubeModified, int32_t(cube), nearest,
+      changedParts(contents[0][cube], contents[1][nearest])
+    };
+    modified.push_back(change);
+  }
+
+  diff.cubes.swap(removed);
+  diff.cubes.insert(diff.cubes.end(), modified.begin(), modified.end());
+  for (size_t cube = 0; cube < levels[1].cubes.size(); ++cube)
+  {
+    if (matches[1][cube] != none) continue;
+
+    const CubeChange change = { CubeAdded, none, int32_t(cube), 0 };
+    diff.cubes.push_back(change);
+  }
+
+  // A vertex is shared by several cubes so it is only reported the first
+  // time it is seen.
+  std::vector<uint8_t> isReported(levels[0].vertices.size());
+  for (auto change = modified.begin(); change != modified.end(); ++change)
+  {
+    if (!(change->parts & CubeVerticesChanged)) continue;
+
+    const Cube& from = levels[0].cubes[change->before];
+    const Cube& to = levels[1].cubes[change->after];
+    for (int i = 0; i < 8; ++i)
+    {
+      const uint16_t vertex = from.vertices[i];
+      if (vertex >= isReported.size() || isReported[vertex]) continue;
+
+      const Vertex& a = contents[0][change->before].positions[i];
+      const Vertex& b = contents[1][change->after].positions[i];
+      if (a.x == b.x && a.y == b.y && a.z == b.z) continue;
+
+      isReported[vertex] = 1;
+      const VertexMove move = { vertex, to.vertices[i], a, b };
+      diff.vertices.push_back(move);
+    }
+  }
+
+  std::sort(diff.vertices.begin(), diff.vertices.end(),
+            [](const VertexMove& a, const VertexMove& b)
+  { return a.before < b.before; });
+  return diff;
+}
@@ -0,0 +1,84 @@
+#ifndef LEVEL_DIFF_HPP_GUARD
+#define LEVEL_DIFF_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelDiff
+// PURPOSE      : Providing what has changed between two versions of a level.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Each cube is given a hash of what it is made of, which is the
+//                positions of its vertices, which of its sides have neighbours,
+//                its walls, its textures and its lighting. The hashes leave out
+//                the numbers of the cubes, the vertices and the walls so that a
+//                cube which hasn't changed matches even when those have been
+//                renumbered by cubes being added or removed.
+//
+//                The cubes with the same hash in both levels are unchanged.
+//                The rest are matched by where their centres are, these are the
+//                cubes which were modified and what is left over was added or
+//                removed. Both steps look up a hash table rather than comparing
+//                every pair of cubes, so the time taken grows with the size of
+//                the levels rather than its square.
+//
+//===----------------------------------------------------------------------===//
+
+#include "rdl.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+enum CubeChangeKind
+{
+  CubeAdded,
+  CubeRemoved,
+  CubeModified
+};
+
+// What about a modified cube is different.
+enum CubeChangeParts
+{
+  CubeVerticesChanged = 1 << 0,
+  CubeNeighborsChanged = 1 << 1,
+  CubeWallsChanged = 1 << 2,
+  CubeTexturesChanged = 1 << 3,
+  CubeLightingChanged = 1 << 4,
+  CubeSpecialChanged = 1 << 5 // The special, robot maker or value.
+};
+
+struct CubeChange
+{
+  CubeChangeKind kind;
+  int32_t before; // The cube in the first level or -1 if it was added.
+  int32_t after; // The cube in the second level or -1 if it was removed.
+  uint8_t parts; // The parts that changed for a modified cube.
+};
+
+struct VertexMove
+{
+  uint32_t before;
+  uint32_t after;
+  Vertex from;
+  Vertex to;
+};
+
+struct LevelDiff
+{
+  std::vector<CubeChange> cubes;
+  // The cubes which were removed come first in the order of the first level,
+  // then those modified in the same order, then those added in the order of
+  // the second level.
+
+  std::vector<VertexMove> vertices;
+  // The vertices of the modified cubes which are in a different place, in
+  // the order of the first level.
+
+  size_t unchangedCount; // The number of cubes which are the same.
+};
+
+LevelDiff DiffLevels(const RdlReader& before, const RdlReader& after);
+// Returns the changes that turn the first level into the second.
+
+#endif
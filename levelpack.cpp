@@ -0,0 +1,344 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelPack
+// PURPOSE      : Providing the levels of an archive already decoded.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The table of contents is checked once when the pack is
+//                opened, after that a level is only pointers into the file.
+//
+//===----------------------------------------------------------------------===//
+
+#include "levelpack.hpp"
+
+#include "quads.hpp"
+
+#include <fstream>
+
+#include <ctype.h>
+#include <string.h>
+
+static const uint32_t version = 1;
+
+// The size of the header, which is the magic number and 3 numbers.
+static const uint64_t headerSize = 4 + 3 * sizeof(uint32_t);
+
+// The boundary each section starts on.
+static const uint64_t alignment = 64;
+
+// A neighbour of -2 is where the exit of the level is.
+static const int16_t exitSide = -2;
+
+enum Section
+{
+  VerticesSection,
+  CubeVerticesSection,
+  NeighborsSection,
+  WallsSection,
+  SpecialSection,
+  MatcenSection,
+  ValueSection,
+  LightingSection,
+  TexturesSection,
+  QuadsSection,
+  SectionCount
+};
+
+// The longest name is one less than this.
+static const size_t nameSize = 16;
+
+struct LevelPackEntry
+{
+  char name[nameSize];
+  uint32_t vertexCount;
+  uint32_t cubeCount;
+  uint32_t quadCount;
+  uint32_t unused;
+  uint64_t sections[SectionCount];
+};
+
+static_assert(sizeof(Texture) == 2 * sizeof(uint16_t),
+              "The textures are written as they are in memory");
+static_assert(sizeof(PackedQuad) == 5 * sizeof(uint32_t),
+              "The quads are written as they are in memory");
+
+namespace
+{
+  // The size of each item in each section.
+  const uint64_t itemSizes[SectionCount] = {
+    sizeof(Vertex), sizeof(uint16_t[8]), sizeof(int16_t[6]),
+    sizeof(uint8_t[6]), sizeof(uint8_t), sizeof(int8_t), sizeof(int16_t),
+    sizeof(double), sizeof(Texture[6]), sizeof(PackedQuad)
+  };
+
+  // Returns the number of items in the section of the level.
+  uint64_t itemCount(uint32_t vertexCount, uint32_t cubeCount,
+                     uint32_t quadCount, int section)
+  {
+    if (section == VerticesSection) return vertexCount;
+    if (section == QuadsSection) return quadCount;
+    return cubeCount;
+  }
+
+  uint64_t aligned(uint64_t offset)
+  {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+}
+
+bool LevelPackBuilder::Add(const std::string& name, const RdlReader& level)
+{
+  if (name.size() >= nameSize || !level.IsValid()) return false;
+
+  Level packed;
+  packed.name = name;
+  packed.vertices = level.Vertices();
+  packed.cubes = level.Cubes();
+
+  const size_t vertexCount = packed.vertices.size();
+  const size_t cubeCount = packed.cubes.size();
+  if (cubeCount > INT16_MAX) return false;
+  for (auto cube = packed.cubes.begin(); cube != packed.cubes.end(); ++cube)
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      if (cube->vertices[i] >= vertexCount) return false;
+    }
+    for (int side = 0; side < 6; ++side)
+    {
+      const int16_t neighbor = cube->neighbors[side];
+      if (neighbor < exitSide || neighbor >= int16_t(cubeCount)) return false;
+    }
+  }
+
+  const auto quads = Quads(packed.cubes);
+  packed.quads.resize(quads.size());
+  for (size_t i = 0; i < quads.size(); ++i)
+  {
+    packed.quads[i].vertices[0] = static_cast<uint32_t>(quads[i].a);
+    packed.quads[i].vertices[1] = static_cast<uint32_t>(quads[i].b);
+    packed.quads[i].vertices[2] = static_cast<uint32_t>(quads[i].c);
+    packed.quads[i].vertices[3] = static_cast<uint32_t>(quads[i].d);
+    packed.quads[i].cube = quads[i].cube;
+  }
+
+  myLevels.push_back(packed);
+  return true;
+}
+
+size_t LevelPackBuilder::LevelCount() const
+{
+  return myLevels.size();
+}
+
+bool LevelPackBuilder::Write(const char* filename) const
+{
+  // The sections are laid out first so the table of contents can be written
+  // before them.
+  std::vector<LevelPackEntry> entries(myLevels.size());
+  uint64_t offset = headerSize + entries.size() * sizeof(LevelPackEntry);
+  for (size_t i = 0; i < myLevels.size(); ++i)
+  {
+    const Level& level = myLevels[i];
+    LevelPackEntry& entry = entries[i];
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, level.name.data(), level.name.size());
+    entry.vertexCount = static_cast<uint32_t>(level.vertices.size());
+    entry.cubeCount = static_cast<uint32_t>(level.cubes.size());
+    entry.quadCount = static_cast<uint32_t>(level.quads.size());
+
+    for (int section = 0; section < SectionCount; ++section)
+    {
+      offset = aligned(offset);
+      entry.sections[section] = offset;
+      offset += itemSizes[section] * itemCount(entry.vertexCount,
+                                               entry.cubeCount,
+                                               entry.quadCount, section);
+    }
+  }
+
+  std::ofstream output(filename, std::ios::binary);
+  const uint32_t header[3] = {
+    version, static_cast<uint32_t>(myLevels.size()), 0
+  };
+  output.write("DLPK", 4);
+  output.write(reinterpret_cast<const char*>(header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(entries.data()),
+               entries.size() * sizeof(LevelPackEntry));
+
+  offset = headerSize + entries.size() * sizeof(LevelPackEntry);
+  std::vector<uint8_t> column;
+  for (size_t i = 0; i < myLevels.size(); ++i)
+  {
+    const Level& level = myLevels[i];
+    for (int section = 0; section < SectionCount; ++section)
+    {
+      const uint64_t size =
+        itemSizes[section] * itemCount(entries[i].vertexCount,
+                                       entries[i].cubeCount,
+                                       entries[i].quadCount, section);
+      column.resize(size);
+
+      if (section == VerticesSection)
+      {
+        memcpy(column.data(), level.vertices.data(), size);
+      }
+      else if (section == QuadsSection)
+      {
+        memcpy(column.data(), level.quads.data(), size);
+      }
+      else
+      {
+        // The columns of the cubes are gathered from each of the cubes.
+        uint8_t* item = column.data();
+        for (auto cube = level.cubes.begin(); cube != level.cubes.end();
+             ++cube, item += itemSizes[section])
+        {
+          const void* source = nullptr;
+          switch (section)
+          {
+          case CubeVerticesSection: source = cube->vertices; break;
+          case NeighborsSection: source = cube->neighbors; break;
+          case WallsSection: source = cube->walls; break;
+          case SpecialSection: source = &cube->special; break;
+          case MatcenSection: source = &cube->matcen; break;
+          case ValueSection: source = &cube->value; break;
+          case LightingSection: source = &cube->lighting; break;
+          default: source = cube->textures; break;
+          }
+          memcpy(item, source, itemSizes[section]);
+        }
+      }
+
+      const std::vector<char> padding(entries[i].sections[section] - offset);
+      output.write(padding.data(), padding.size());
+      output.write(reinterpret_cast<const char*>(column.data()), size);
+      offset = entries[i].sections[section] + size;
+    }
+  }
+  return output.good();
+}
+
+LevelPack::LevelPack(const char* filename)
+: myFile(filename), myLevelCount(0), myEntries(nullptr)
+{
+  if (!myFile.IsValid() || myFile.Size() < headerSize) return;
+  if (memcmp(myFile.Data(), "DLPK", 4) != 0) return;
+
+  uint32_t header[3];
+  memcpy(header, myFile.Data() + 4, sizeof(header));
+  if (header[0] != version) return;
+
+  const uint64_t size = myFile.Size();
+  if (headerSize + uint64_t(header[1]) * sizeof(LevelPackEntry) > size)
+  {
+    return;
+  }
+
+  // Every section is checked to be within the file and aligned, so the
+  // levels can be pointed into without checking again.
+  const LevelPackEntry* entries =
+    reinterpret_cast<const LevelPackEntry*>(myFile.Data() + headerSize);
+  for (uint32_t i = 0; i < header[1]; ++i)
+  {
+    const LevelPackEntry& entry = entries[i];
+    if (entry.name[sizeof(entry.name) - 1] != '\0') return;
+
+    for (int section = 0; section < SectionCount; ++section)
+    {
+      const uint64_t offset = entry.sections[section];
+      const uint64_t sectionSize =
+        itemSizes[section] * itemCount(entry.vertexCount, entry.cubeCount,
+                                       entry.quadCount, section);
+      if (offset % alignment != 0 || offset > size ||
+          sectionSize > size - offset)
+      {
+        return;
+      }
+    }
+  }
+
+  myLevelCount = header[1];
+  myEntries = entries;
+}
+
+bool LevelPack::IsValid() const
+{
+  return myEntries != nullptr;
+}
+
+size_t LevelPack::LevelCount() const
+{
+  return myLevelCount;
+}
+
+PackedLevel LevelPack::Level(size_t index) const
+{
+  const LevelPackEntry& entry = myEntries[index];
+  const uint8_t* data = myFile.Data();
+  const uint64_t* sections = entry.sections;
+
+  PackedLevel level;
+  level.name = entry.name;
+  level.vertexCount = entry.vertexCount;
+  level.cubeCount = entry.cubeCount;
+  level.quadCount = entry.quadCount;
+  level.vertices =
+    reinterpret_cast<const Vertex*>(data + sections[VerticesSection]);
+  level.cubeVertices = reinterpret_cast<const uint16_t (*)[8]>(
+    data + sections[CubeVerticesSection]);
+  level.neighbors =
+    reinterpret_cast<const int16_t (*)[6]>(data + sections[NeighborsSection]);
+  level.walls =
+    reinterpret_cast<const uint8_t (*)[6]>(data + sections[WallsSection]);
+  level.special = data + sections[SpecialSection];
+  level.matcen =
+    reinterpret_cast<const int8_t*>(data + sections[MatcenSection]);
+  level.value =
+    reinterpret_cast<const int16_t*>(data + sections[ValueSection]);
+  level.lighting =
+    reinterpret_cast<const double*>(data + sections[LightingSection]);
+  level.textures =
+    reinterpret_cast<const Texture (*)[6]>(data + sections[TexturesSection]);
+  level.quads =
+    reinterpret_cast<const PackedQuad*>(data + sections[QuadsSection]);
+  return level;
+}
+
+bool LevelPack::Find(const char* name, size_t* index) const
+{
+  for (uint32_t i = 0; i < myLevelCount; ++i)
+  {
+    const char* a = myEntries[i].name;
+    const char* b = name;
+    while (*a != '\0' && tolower(static_cast<unsigned char>(*a)) ==
+                         tolower(static_cast<unsigned char>(*b)))
+    {
+      ++a;
+      ++b;
+    }
+
+    if (*a == '\0' && *b == '\0')
+    {
+      *index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+Cube LevelPack::UnpackCube(const PackedLevel& level, size_t index)
+{
+  Cube cube;
+  memcpy(cube.vertices, level.cubeVertices[index], sizeof(cube.vertices));
+  memcpy(cube.neighbors, level.neighbors[index], sizeof(cube.neighbors));
+  memcpy(cube.walls, level.walls[index], sizeof(cube.walls));
+  cube.special = level.special[index];
+  cube.matcen = level.matcen[index];
+  cube.value = level.value[index];
+  cube.lighting = level.lighting[index];
+  memcpy(cube.textures, level.textures[index], sizeof(cube.textures));
+  return cube;
+}
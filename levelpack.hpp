@@ -0,0 +1,140 @@
+#ifndef LEVEL_PACK_HPP_GUARD
+#define LEVEL_PACK_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LevelPack
+// PURPOSE      : Providing the levels of an archive already decoded.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The levels are decoded once and written to a file which is
+//                mapped into memory and used in place, so loading a level is
+//                finding it in the table of contents and pointing into the
+//                file rather than decoding it.
+//
+//                The parts of the cubes are kept in separate columns so code
+//                which only needs some of them, such as the neighbours, only
+//                touches those pages of the file.
+//
+//                The file format is as follows, the numbers are in the byte
+//                order of the machine which wrote it. Every section starts on
+//                a 64 byte boundary so the arrays in it are aligned.
+//
+//                 | "DLPK" - 4 bytes
+//                 | version, level count, 0 - 3 32-bit numbers
+//                 |---------------- Table of contents, for each level:
+//                 | name - 16 bytes, padded with \0
+//                 | vertex count, cube count, quad count, 0 - 4 32-bit numbers
+//                 | offset of each section - 10 64-bit numbers
+//                 |---------------- The sections of each level:
+//                 | vertices - 3 doubles each
+//                 | the vertices of each cube - 8 16-bit numbers each
+//                 | the neighbours of each cube - 6 16-bit numbers each
+//                 | the walls of each cube - 6 bytes each
+//                 | special, matcen - a byte each per cube
+//                 | value - a 16-bit number per cube
+//                 | lighting - a double per cube
+//                 | the textures of each cube - 6 Textures each
+//                 | quads - 4 vertices and a cube, 32-bit numbers each
+//
+//                The sections are checked to be within the file when it is
+//                opened but what is in them isn't, the levels are checked when
+//                the pack is built instead and any which refer to vertices or
+//                cubes that they don't have are left out.
+//
+//===----------------------------------------------------------------------===//
+
+#include "cube.hpp"
+#include "file.hpp"
+#include "rdl.hpp"
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct LevelPackEntry;
+
+struct PackedQuad
+{
+  uint32_t vertices[4];
+  uint32_t cube; // The index of the cube the side is part of.
+};
+
+struct PackedLevel
+{
+  const char* name;
+  uint32_t vertexCount;
+  uint32_t cubeCount;
+  uint32_t quadCount;
+
+  const Vertex* vertices;
+
+  // The columns of the cubes, each has cubeCount items. See Cube for what
+  // each of them means.
+  const uint16_t (*cubeVertices)[8];
+  const int16_t (*neighbors)[6];
+  const uint8_t (*walls)[6];
+  const uint8_t* special;
+  const int8_t* matcen;
+  const int16_t* value;
+  const double* lighting;
+  const Texture (*textures)[6];
+
+  const PackedQuad* quads; // The sides without a neighbour, see Quads().
+};
+
+class LevelPackBuilder
+{
+public:
+  bool Add(const std::string& name, const RdlReader& level);
+  // Decodes the level and adds it to the pack. Returns false if the level
+  // isn't valid, refers to vertices or cubes it doesn't have or the name is
+  // longer than 15 characters.
+
+  size_t LevelCount() const;
+
+  bool Write(const char* filename) const;
+  // Writes the pack out in the format described above.
+
+private:
+  struct Level
+  {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<Cube> cubes;
+    std::vector<PackedQuad> quads;
+  };
+
+  std::vector<Level> myLevels;
+};
+
+class LevelPack
+{
+public:
+  LevelPack(const char* filename);
+
+  bool IsValid() const;
+  // Returns true if the file was mapped and its table of contents is valid.
+
+  size_t LevelCount() const;
+
+  PackedLevel Level(size_t index) const;
+  // Returns the level, which points into the mapped file so it is only valid
+  // for as long as the pack is.
+
+  bool Find(const char* name, size_t* index) const;
+  // Finds the first level with the name, ignoring the case of the letters.
+
+  static Cube UnpackCube(const PackedLevel& level, size_t index);
+  // Puts the columns of a cube back together.
+
+private:
+  MappedFile myFile;
+  uint32_t myLevelCount;
+  const LevelPackEntry* myEntries;
+};
+
+#endif
@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LightBake
+// PURPOSE      : Providing the light of a level after it has spread between
+//                the cubes.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The cubes are split into blocks which are updated on many
+//                threads, each step reads the light of the last step and
+//                writes the next one so the blocks don't depend on each other.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lightbake.hpp"
+
+#include "cube.hpp"
+#include "geometry.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+
+// The number of cubes in a block.
+static const size_t blockSize = 1024;
+
+// The most steps that are taken, in case the light doesn't settle because
+// the transfer given is too large.
+static const size_t maximumIterations = 1000;
+
+namespace
+{
+  struct Portal
+  {
+    uint32_t cube; // The cube on the other side.
+    float share; // The transfer times the share of the surface of the cube.
+  };
+
+  double triangleArea(const Vertex& a, const Vertex& b, const Vertex& c)
+  {
+    const double u[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+    const double v[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+    const double n[3] = { u[1] * v[2] - u[2] * v[1],
+                          u[2] * v[0] - u[0] * v[2],
+                          u[0] * v[1] - u[1] * v[0] };
+    return sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) / 2;
+  }
+
+  bool isDrawn(const Cube& cube, int side)
+  {
+    return cube.neighbors[side] == -1 || cube.walls[side] != 255;
+  }
+}
+
+BakedLight BakeLight(const std::vector<Cube>& cubes,
+                     const std::vector<Vertex>& vertices,
+                     const std::vector<CubeLights>& lights,
+                     float transfer, float threshold)
+{
+  const size_t cubeCount = cubes.size();
+  BakedLight baked;
+  baked.iterations = 0;
+  baked.change = 0.0f;
+
+  // The light of each cube on its own and the portals to its neighbours.
+  std::vector<float> own(cubeCount);
+  std::vector<Portal> portals(cubeCount * 6);
+  std::vector<uint8_t> portalCounts(cubeCount);
+  ParallelFor(cubeCount, [&](size_t i, size_t)
+  {
+    const Cube& cube = cubes[i];
+    bool isValid = true;
+    for (int j = 0; j < 8; ++j)
+    {
+      if (cube.vertices[j] >= vertices.size()) isValid = false;
+    }
+
+    float total = 0.0f;
+    int drawnCount = 0;
+    double areas[6] = {};
+    double totalArea = 0.0;
+    for (int side = 0; side < 6; ++side)
+    {
+      if (isDrawn(cube, side))
+      {
+        for (int corner = 0; corner < 4; ++corner)
+        {
+          total += lights[i].corners[side][corner];
+        }
+        ++drawnCount;
+      }
+
+      if (!isValid) continue;
+      const Vertex& a = vertices[cube.vertices[sideVertices[side][0]]];
+      const Vertex& b = vertices[cube.vertices[sideVertices[side][1]]];
+      const Vertex& c = vertices[cube.vertices[sideVertices[side][2]]];
+      const Vertex& d = vertices[cube.vertices[sideVertices[side][3]]];
+      areas[side] = triangleArea(a, b, c) + triangleArea(a, c, d);
+      totalArea += areas[side];
+    }
+    own[i] = drawnCount > 0 ? total / (drawnCount * 4) : 0.0f;
+
+    // Light passes through the same sides as the line of sight does.
+    uint8_t portalCount = 0;
+    for (int side = 0; side < 6 && totalArea > 0.0; ++side)
+    {
+      const int16_t neighbor = cube.neighbors[side];
+      if (neighbor < 0 || static_cast<size_t>(neighbor) >= cubeCount ||
+          cube.walls[side] != 255)
+      {
+        continue;
+      }
+
+      Portal& portal = portals[i * 6 + portalCount++];
+      portal.cube = static_cast<uint32_t>(neighbor);
+      portal.share = static_cast<float>(transfer * areas[side] / totalArea);
+    }
+    portalCounts[i] = portalCount;
+  });
+
+  // Each step works out the light of every cube from the last step.
+  std::vector<float> light(own);
+  std::vector<float> next(cubeCount);
+  const size_t blocks = (cubeCount + blockSize - 1) / blockSize;
+  std::vector<float> changes(blocks);
+  while (cubeCount > 0 && baked.iterations < maximumIterations)
+  {
+    ParallelFor(blocks, [&](size_t block, size_t)
+    {
+      float change = 0.0f;
+      const size_t end = std::min(cubeCount, (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; ++i)
+      {
+        float value = own[i];
+        const Portal* portal = &portals[i * 6];
+        for (uint8_t j = 0; j < portalCounts[i]; ++j)
+        {
+          value += portal[j].share * light[portal[j].cube];
+        }
+        next[i] = value;
+        change = std::max(change, fabsf(value - light[i]));
+      }
+      changes[block] = change;
+    });
+
+    light.swap(next);
+    ++baked.iterations;
+    baked.change = *std::max_element(changes.begin(), changes.end());
+    if (baked.change < threshold) break;
+  }
+
+  // The light that was gained is added to the corners of the sides.
+  baked.corners.resize(cubeCount);
+  baked.sides.resize(cubeCount * 6);
+  ParallelFor(cubeCount, [&](size_t i, size_t)
+  {
+    const float gained = light[i] - own[i];
+    for (int side = 0; side < 6; ++side)
+    {
+      const bool isSideDrawn = isDrawn(cubes[i], side);
+      float total = 0.0f;
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        const float value = isSideDrawn ?
+                              lights[i].corners[side][corner] + gained :
+                              light[i];
+        baked.corners[i].corners[side][corner] = value;
+        total += value;
+      }
+      baked.sides[i * 6 + side] = total / 4;
+    }
+  });
+
+  // The corners are added up into the vertices they are at, which is done on
+  // one thread as the cubes share vertices.
+  std::vector<double> totals(vertices.size());
+  std::vector<uint32_t> counts(vertices.size());
+  std::vector<double> cubeTotals(vertices.size());
+  std::vector<uint32_t> cubeCounts(vertices.size());
+  for (size_t i = 0; i < cubeCount; ++i)
+  {
+    const Cube& cube = cubes[i];
+    for (int side = 0; side < 6; ++side)
+    {
+      const bool isSideDrawn = isDrawn(cube, side);
+      for (int corner = 0; corner < 4; ++corner)
+      {
+        const uint16_t vertex = cube.vertices[sideVertices[side][corner]];
+        if (vertex >= vertices.size()) continue;
+
+        if (isSideDrawn)
+        {
+          totals[vertex] += baked.corners[i].corners[side][corner];
+          ++counts[vertex];
+        }
+        else
+        {
+          cubeTotals[vertex] += light[i];
+          ++cubeCounts[vertex];
+        }
+      }
+    }
+  }
+
+  baked.vertices.resize(vertices.size());
+  for (size_t i = 0; i < vertices.size(); ++i)
+  {
+    if (counts[i] > 0)
+    {
+      baked.vertices[i] = static_cast<float>(totals[i] / counts[i]);
+    }
+    else if (cubeCounts[i] > 0)
+    {
+      baked.vertices[i] = static_cast<float>(cubeTotals[i] / cubeCounts[i]);
+    }
+    else
+    {
+      baked.vertices[i] = 0.0f;
+    }
+  }
+
+  baked.cubes.swap(light);
+  return baked;
+}
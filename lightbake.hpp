@@ -0,0 +1,69 @@
+#ifndef LIGHT_BAKE_HPP_GUARD
+#define LIGHT_BAKE_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LightBake
+// PURPOSE      : Providing the light of a level after it has spread between
+//                the cubes.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Each cube starts with the light of the corners of its sides
+//                which are drawn, as given by the UVLs of the level. Some of
+//                the light of each cube then passes through the open sides to
+//                its neighbours, in proportion to how much of the surface of
+//                the cube it passes into the open side is:
+//
+//                  light = own light + transfer * sum over the open sides of
+//                          (area of the side / area of all of the sides) *
+//                          light of the cube on the other side
+//
+//                This is solved by updating every cube at once from the light
+//                of the last step until no cube changes by more than the
+//                threshold. As the proportions of a cube add up to at most one
+//                and the transfer is less than one each step changes the light
+//                by less than the one before, so it always settles.
+//
+//                The light which a cube gains from its neighbours is added to
+//                each corner of its sides, so the corners keep the differences
+//                in light which the level was made with.
+//
+//===----------------------------------------------------------------------===//
+
+#include "rdl.hpp"
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+struct CubeLights;
+
+struct BakedLight
+{
+  std::vector<float> cubes; // The light of each cube.
+  std::vector<CubeLights> corners; // The light at the corners of each side.
+  std::vector<float> sides; // The light of each side of each cube, which is
+                            // at cube * 6 + side.
+  std::vector<float> vertices; // The light of each vertex of the level.
+
+  size_t iterations; // The number of steps it took to settle.
+  float change; // The most any cube changed in the last step.
+};
+
+BakedLight BakeLight(const std::vector<Cube>& cubes,
+                     const std::vector<Vertex>& vertices,
+                     const std::vector<CubeLights>& lights,
+                     float transfer = 0.5f, float threshold = 1e-4f);
+// Spreads the light of the cubes through the open sides between them. The
+// transfer is the fraction of the light which passes through an open side,
+// it must be less than 1.
+//
+// The light of a side which is drawn is the average of its corners, and the
+// light of a side which is open is the light of its cube. The light of a
+// vertex is the average of the corners which are at it, or of the cubes
+// which have it when none of their sides are drawn there.
+
+#endif
@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Lz4
+// PURPOSE      : Providing fast compression of the files in archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A block is a series of sequences, each of which is some bytes
+//                to copy as they are (literals) followed by a match, which is
+//                an offset back into the data already decompressed and a length
+//                to copy from there. The last sequence only has literals.
+//
+//                The compressor finds matches by hashing the next four bytes
+//                and looking up where those were last seen, taking the first
+//                match it finds rather than searching for the longest. When no
+//                matches are being found it skips ahead faster so data which
+//                doesn't compress isn't slow to store.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lz4.hpp"
+
+#include <vector>
+
+#include <string.h>
+
+static const int hashBits = 16;
+
+// The shortest match, which is what a match length of 0 means.
+static const size_t minimumMatch = 4;
+
+// The format requires the last 5 bytes to be literals and the last match to
+// start at least 12 bytes before the end.
+static const size_t lastLiterals = 5;
+static const size_t matchLimit = 12;
+
+// The offset of a match is 16-bit.
+static const size_t maximumOffset = 65535;
+
+// Lengths from this on have more bytes after the token.
+static const size_t tokenLimit = 15;
+
+static inline uint32_t read32(const uint8_t* data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static inline uint32_t hashOf(uint32_t sequence)
+{
+  return (sequence * 2654435761U) >> (32 - hashBits);
+}
+
+// Writes the part of a length which doesn't fit in the token.
+static uint8_t* writeLength(uint8_t* output, size_t length)
+{
+  for (; length >= 255; length -= 255) *output++ = 255;
+  *output++ = static_cast<uint8_t>(length);
+  return output;
+}
+
+static uint8_t* writeLiterals(uint8_t* output, uint8_t* token,
+                              const uint8_t* literals, size_t count)
+{
+  if (count >= tokenLimit)
+  {
+    *token = static_cast<uint8_t>(tokenLimit << 4);
+    output = writeLength(output, count - tokenLimit);
+  }
+  else
+  {
+    *token = static_cast<uint8_t>(count << 4);
+  }
+
+  memcpy(output, literals, count);
+  return output + count;
+}
+
+// Reads the part of a length which doesn't fit in the token, returning false
+// if it runs off the end of the input.
+static bool readLength(const uint8_t** input, const uint8_t* end,
+                       size_t* length)
+{
+  uint8_t byte;
+  do
+  {
+    if (*input == end) return false;
+    byte = *(*input)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+size_t Lz4CompressBound(size_t size)
+{
+  return size + size / 255 + 16;
+}
+
+size_t Lz4Compress(const uint8_t* data, size_t size, uint8_t* compressed)
+{
+  uint8_t* output = compressed;
+  size_t anchor = 0; // The start of the literals which haven't been written.
+
+  if (size > matchLimit)
+  {
+    std::vector<uint32_t> table(size_t(1) << hashBits);
+    const size_t matchEnd = size - lastLiterals;
+
+    size_t i = 0;
+    while (i + matchLimit < size)
+    {
+      const uint32_t sequence = read32(data + i);
+      uint32_t& entry = table[hashOf(sequence)];
+      size_t candidate = entry;
+      entry = static_cast<uint32_t>(i);
+
+      if (candidate >= i || i - candidate > maximumOffset ||
+          read32(data + candidate) != sequence)
+      {
+        i += 1 + ((i - anchor) >> 6);
+        continue;
+      }
+
+      // The match may start before where it was found.
+      while (i > anchor && candidate > 0 && data[i - 1] == data[candidate - 1])
+      {
+        --i;
+        --candidate;
+      }
+
+      size_t length = minimumMatch;
+      while (i + length < matchEnd &&
+             data[i + length] == data[candidate + length])
+      {
+        ++length;
+      }
+
+      uint8_t* token = output++;
+      output = writeLiterals(output, token, data + anchor, i - anchor);
+
+      const size_t offset = i - candidate;
+      *output++ = static_cast<uint8_t>(offset);
+      *output++ = static_cast<uint8_t>(offset >> 8);
+
+      const size_t extra = length - minimumMatch;
+      if (extra >= tokenLimit)
+      {
+        *token |= tokenLimit;
+        output = writeLength(output, extra - tokenLimit);
+      }
+      else
+      {
+        *token |= static_cast<uint8_t>(extra);
+      }
+
+      i += length;
+      anchor = i;
+    }
+  }
+
+  uint8_t* token = output++;
+  output = writeLiterals(output, token, data + anchor, size - anchor);
+  return output - compressed;
+}
+
+bool Lz4Decompress(const uint8_t* compressed, size_t compressedSize,
+                   uint8_t* data, size_t size)
+{
+  const uint8_t* input = compressed;
+  const uint8_t* const inputEnd = compressed + compressedSize;
+  uint8_t* output = data;
+  uint8_t* const outputEnd = data + size;
+
+  while (input < inputEnd)
+  {
+    const uint8_t token = *input++;
+
+    size_t literals = token >> 4;
+    if (literals == tokenLimit && !readLength(&input, inputEnd, &literals))
+    {
+      return false;
+    }
+    if (literals > size_t(inputEnd - input) ||
+        literals > size_t(outputEnd - output))
+    {
+      return false;
+    }
+    memcpy(output, input, literals);
+    input += literals;
+    output += literals;
+
+    // The last sequence has no match.
+    if (input == inputEnd) break;
+
+    if (inputEnd - input < 2) return false;
+    const size_t offset = input[0] | (input[1] << 8);
+    input += 2;
+    if (offset == 0 || offset > size_t(output - data)) return false;
+
+    size_t length = token & tokenLimit;
+    if (length == tokenLimit && !readLength(&input, inputEnd, &length))
+    {
+      return false;
+    }
+    length += minimumMatch;
+    if (length > size_t(outputEnd - output)) return false;
+
+    // The match may overlap what it is copied to, which repeats the bytes
+    // between them, so it can only be copied all at once if it doesn't.
+    const uint8_t* match = output - offset;
+    if (offset >= length)
+    {
+      memcpy(output, match, length);
+    }
+    else
+    {
+      for (size_t i = 0; i < length; ++i) output[i] = match[i];
+    }
+    output += length;
+  }
+  return output == outputEnd;
+}
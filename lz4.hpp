@@ -0,0 +1,38 @@
+#ifndef LZ4_HPP_GUARD
+#define LZ4_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Lz4
+// PURPOSE      : Providing fast compression of the files in archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : An implementation of the LZ4 block format by Yann Collet. The
+//                output can be decompressed by any LZ4 implementation which
+//                is given the size of the original data, and the decompressor
+//                accepts blocks from any of them.
+//
+//                Only the block format is implemented, the frame format adds
+//                headers and checksums which the compressed archive has its own
+//                versions of.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+size_t Lz4CompressBound(size_t size);
+// Returns the most bytes that size bytes of data can be compressed to.
+
+size_t Lz4Compress(const uint8_t* data, size_t size, uint8_t* compressed);
+// Compresses the data into compressed, which must have room for
+// Lz4CompressBound(size) bytes, and returns the size of the compressed data.
+
+bool Lz4Decompress(const uint8_t* compressed, size_t compressedSize,
+                   uint8_t* data, size_t size);
+// Decompresses the block into data which is exactly size bytes long. Returns
+// false if the block is damaged or doesn't decompress to size bytes, it
+// never reads or writes outside of the buffers.
+
+#endif
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : ExportManifest
+// PURPOSE      : Records what was exported so unchanged files can be skipped.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Reads and writes the manifest kept next to exported files.
+//
+//===----------------------------------------------------------------------===//
+
+#include "manifest.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+ExportManifest::ExportManifest(const char* filename) : myFilename(filename)
+{
+  std::ifstream input(filename);
+  std::string line;
+  while (std::getline(input, line))
+  {
+    std::istringstream fields(line);
+    std::string output;
+    Entry entry;
+    if (fields >> output >> std::hex >> entry.hash >> entry.exporter)
+    {
+      myEntries[output] = entry;
+    }
+  }
+}
+
+bool ExportManifest::IsUpToDate(const std::string& output, uint64_t hash,
+                                const char* exporter) const
+{
+  const auto entry = myEntries.find(output);
+  if (entry == myEntries.end()) return false;
+  if (entry->second.hash != hash) return false;
+  if (entry->second.exporter != exporter) return false;
+
+  // The output may have been removed since it was exported.
+  return std::ifstream(output.c_str()).good();
+}
+
+void ExportManifest::Update(const std::string& output, uint64_t hash,
+                            const char* exporter)
+{
+  Entry& entry = myEntries[output];
+  entry.hash = hash;
+  entry.exporter = exporter;
+}
+
+bool ExportManifest::Save() const
+{
+  std::ofstream output(myFilename.c_str());
+  for (auto entry = myEntries.cbegin(), end = myEntries.cend(); entry != end;
+       ++entry)
+  {
+    output << entry->first << " " << std::hex << std::setw(16)
+           << std::setfill('0') << entry->second.hash << " "
+           << entry->second.exporter << std::endl;
+  }
+  return output.good();
+}
@@ -0,0 +1,57 @@
+#ifndef MANIFEST_HPP_GUARD
+#define MANIFEST_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : ExportManifest
+// PURPOSE      : Records what was exported so unchanged files can be skipped.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The manifest is a text file that lives next to the exported
+//                files. Each line records an output file, the hash of the data
+//                in the archive that it was produced from and the version of
+//                the exporter that produced it:
+//
+//                  <output name> <hash as 16 hex digits> <exporter>
+//
+//                An output is up-to-date if the hash and exporter match and
+//                the output still exists.
+//
+//===----------------------------------------------------------------------===//
+
+#include <map>
+#include <string>
+
+#include <stdint.h>
+
+class ExportManifest
+{
+public:
+  ExportManifest(const char* filename);
+  // Loads the manifest from the given file if it exists.
+
+  bool IsUpToDate(const std::string& output, uint64_t hash,
+                  const char* exporter) const;
+  // Returns true if output was produced by the exporter from data with the
+  // given hash and it still exists.
+
+  void Update(const std::string& output, uint64_t hash, const char* exporter);
+  // Records that output was produced by the exporter from data with the given
+  // hash.
+
+  bool Save() const;
+  // Writes the manifest back out to the file it was loaded from.
+
+private:
+  struct Entry
+  {
+    uint64_t hash;
+    std::string exporter;
+  };
+
+  std::string myFilename;
+  std::map<std::string, Entry> myEntries;
+};
+
+#endif
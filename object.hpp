@@ -0,0 +1,130 @@
+#ifndef OBJECT_HPP_GUARD
+#define OBJECT_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Object
+// PURPOSE      : Holds the data for the objects, walls and triggers read from a
+//                Descent level file.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Objects are the things placed in the cubes of a level such as
+//                the robots, hostages, keys and where the player starts.
+//
+//                Walls are the doors, grates and other things which may be on
+//                a side between two cubes (Cube::walls is the index of one)
+//                and triggers are what happens when a wall is shot or flown
+//                through.
+//
+//===----------------------------------------------------------------------===//
+
+#include "rdl.hpp"
+
+#include <stdint.h>
+
+enum ObjectType
+{
+  ObjectWall = 0,
+  ObjectFireball = 1,
+  ObjectRobot = 2,
+  ObjectHostage = 3,
+  ObjectPlayer = 4,
+  ObjectWeapon = 5,
+  ObjectCamera = 6,
+  ObjectPowerup = 7,
+  ObjectDebris = 8,
+  ObjectReactor = 9,
+  ObjectFlare = 10,
+  ObjectClutter = 11,
+  ObjectGhost = 12,
+  ObjectLight = 13,
+  ObjectCoop = 14,
+  ObjectMarker = 15,
+};
+
+struct Object
+{
+  // The ObjectType of the object.
+  uint8_t type;
+
+  // Which kind of that type it is, for example which robot or which powerup.
+  uint8_t id;
+
+  // The cube which contains the object.
+  int16_t cube;
+
+  Vertex position;
+
+  // The rows of the matrix that gives the direction the object faces.
+  double orientation[9];
+
+  double size;
+  double shields;
+
+  // What is dropped when the object is destroyed, a type of -1 means nothing.
+  int8_t containsType;
+  int8_t containsId;
+  int8_t containsCount;
+};
+
+enum WallType
+{
+  WallNormal = 0,
+  WallBlastable = 1,
+  WallDoor = 2,
+  WallIllusion = 3,
+  WallOpen = 4,
+  WallClosed = 5,
+  WallOverlay = 6, // Descent 2 only.
+  WallCloaked = 7, // Descent 2 only.
+};
+
+enum WallFlags
+{
+  WallBlasted = 1 << 0,
+  WallDoorOpened = 1 << 1,
+  WallDoorLocked = 1 << 3,
+  WallDoorAuto = 1 << 4,
+  WallIllusionOff = 1 << 5,
+};
+
+struct Wall
+{
+  // The cube and the side of it that the wall is on.
+  int32_t cube;
+  int32_t side;
+
+  double hitPoints;
+
+  // The wall on the other side of this side, or -1 if there isn't one.
+  int32_t linkedWall;
+
+  uint8_t type; // A WallType.
+  uint8_t flags; // The WallFlags which are set.
+  uint8_t state;
+
+  // The index of the trigger for this wall or -1 if there isn't one.
+  int8_t trigger;
+
+  // The animation that is used for the door.
+  int8_t clip;
+
+  // The keys needed to open the door.
+  uint8_t keys;
+};
+
+struct Trigger
+{
+  uint8_t type;
+  uint16_t flags;
+  double value;
+  double time;
+
+  // The sides which the trigger affects.
+  uint8_t linkCount;
+  int16_t cubes[10];
+  int16_t sides[10];
+};
+
+#endif
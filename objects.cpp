@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : ObjectIndex
+// PURPOSE      : Providing the objects which are in each cube.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Builds the index by counting the objects in each cube, then
+//                placing each object after the ones before it in its cube.
+//
+//===----------------------------------------------------------------------===//
+
+#include "objects.hpp"
+
+#include "object.hpp"
+
+ObjectIndex::ObjectIndex(const std::vector<Object>& objects,
+                         size_t cubeCount)
+: myOffsets(cubeCount + 1, 0)
+{
+  for (auto object = objects.begin(); object != objects.end(); ++object)
+  {
+    if (object->cube < 0 || static_cast<size_t>(object->cube) >= cubeCount)
+    {
+      continue;
+    }
+    ++myOffsets[object->cube + 1];
+  }
+
+  for (size_t cube = 0; cube < cubeCount; ++cube)
+  {
+    myOffsets[cube + 1] += myOffsets[cube];
+  }
+
+  // Fill in each cube from its start, using a copy of the offsets as the
+  // position to write the next object to.
+  myObjects.resize(myOffsets[cubeCount]);
+  std::vector<uint32_t> next(myOffsets.begin(), myOffsets.end() - 1);
+  for (size_t i = 0; i < objects.size(); ++i)
+  {
+    const int16_t cube = objects[i].cube;
+    if (cube < 0 || static_cast<size_t>(cube) >= cubeCount) continue;
+    myObjects[next[cube]++] = static_cast<uint32_t>(i);
+  }
+}
+
+size_t ObjectIndex::CubeCount() const
+{
+  return myOffsets.size() - 1;
+}
+
+const uint32_t* ObjectIndex::ObjectsBegin(uint32_t cube) const
+{
+  return myObjects.data() + myOffsets[cube];
+}
+
+const uint32_t* ObjectIndex::ObjectsEnd(uint32_t cube) const
+{
+  return myObjects.data() + myOffsets[cube + 1];
+}
+
+const char* ObjectTypeName(uint8_t type)
+{
+  static const char* const names[] = {
+    "wall",    "fireball", "robot", "hostage", "player", "weapon", "camera",
+    "powerup", "debris",   "reactor", "flare", "clutter", "ghost", "light",
+    "coop",    "marker",
+  };
+
+  if (type >= sizeof(names) / sizeof(names[0])) return "unknown";
+  return names[type];
+}
+
+bool CanFlyThrough(const Wall& wall)
+{
+  if (wall.type == WallOpen || wall.type == WallIllusion) return true;
+  if (wall.type == WallBlastable) return (wall.flags & WallBlasted) != 0;
+  return (wall.flags & WallDoorOpened) != 0;
+}
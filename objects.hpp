@@ -0,0 +1,53 @@
+#ifndef OBJECTS_HPP_GUARD
+#define OBJECTS_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : ObjectIndex
+// PURPOSE      : Providing the objects which are in each cube.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The index is stored in compressed sparse row form, the
+//                indices of the objects in each cube are stored one after the
+//                other in a single array and each cube has the offset to where
+//                its objects start.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Object;
+struct Wall;
+
+class ObjectIndex
+{
+public:
+  ObjectIndex(const std::vector<Object>& objects, size_t cubeCount);
+  // Objects which are not in one of the cubes are left out.
+
+  size_t CubeCount() const;
+
+  const uint32_t* ObjectsBegin(uint32_t cube) const;
+  const uint32_t* ObjectsEnd(uint32_t cube) const;
+  // The indices of the objects in the given cube, in the order they are in
+  // the level.
+
+private:
+  std::vector<uint32_t> myOffsets; // The first object of each cube.
+  std::vector<uint32_t> myObjects;
+};
+
+const char* ObjectTypeName(uint8_t type);
+// Returns the name of the ObjectType.
+
+bool CanFlyThrough(const Wall& wall);
+// Returns true if the wall doesn't stop things from passing through it, as
+// it is when the level starts. This is the case for open and illusory walls,
+// walls which have been blasted and doors which are open. A closed door
+// stops them even if it could be opened.
+
+#endif
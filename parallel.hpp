@@ -0,0 +1,63 @@
+#ifndef PARALLEL_HPP_GUARD
+#define PARALLEL_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Parallel
+// PURPOSE      : Providing a simple way to spread work over all the cores.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Runs a function for each index in a range using a thread per
+//                core. The indices are handed out one at a time so it copes
+//                with items that take very different amounts of time, such as
+//                files in an archive.
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <stddef.h>
+
+inline size_t ThreadCount()
+{
+  const unsigned int count = std::thread::hardware_concurrency();
+  return count == 0 ? 1 : count;
+}
+
+// Calls function(index, thread) for each index from 0 up to count where
+// thread is the index of the thread (less than ThreadCount()) that it is
+// called from, which allows each thread to have its own scratch space.
+template <typename Function>
+void ParallelFor(size_t count, Function function)
+{
+  const size_t threadCount = count < ThreadCount() ? count : ThreadCount();
+  if (threadCount <= 1)
+  {
+    for (size_t i = 0; i < count; ++i) function(i, size_t(0));
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto worker = [&next, count, &function](size_t thread)
+  {
+    for (size_t i = next++; i < count; i = next++) function(i, thread);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount - 1);
+  for (size_t thread = 1; thread < threadCount; ++thread)
+  {
+    threads.push_back(std::thread(worker, thread));
+  }
+  worker(0);
+
+  for (auto thread = threads.begin(); thread != threads.end(); ++thread)
+  {
+    thread->join();
+  }
+}
+
+#endif
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : PcxReader
+// PURPOSE      : Providing a decoder for the PCX image format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Decodes the run-length encoded pixels of a PCX image and
+//                expands them with its palette.
+//
+//===----------------------------------------------------------------------===//
+
+#include "pcx.hpp"
+
+#include "image.hpp"
+
+#include <string.h>
+
+static const size_t headerSize = 128;
+
+// The byte before the palette at the end of the file.
+static const uint8_t paletteMarker = 12;
+
+// A byte with both of these bits set is the length of a run.
+static const uint8_t runMask = 0xC0;
+
+static uint16_t readUInt16(const uint8_t* data)
+{
+  return static_cast<uint16_t>(data[0] | data[1] << 8);
+}
+
+PcxReader::PcxReader(const uint8_t* data, size_t size)
+: myData(data), mySize(size)
+{
+}
+
+bool PcxReader::IsValid() const
+{
+  if (mySize < headerSize) return false;
+
+  const uint8_t manufacturer = myData[0];
+  const uint8_t encoding = myData[2];
+  const uint8_t bitsPerPixel = myData[3];
+  const uint8_t planes = myData[65];
+  if (manufacturer != 10 || encoding != 1 || bitsPerPixel != 8) return false;
+  if (planes != 1 && planes != 3) return false;
+
+  // An indexed image needs the palette at the end of the file.
+  if (planes == 1 &&
+      (mySize < headerSize + 769 || myData[mySize - 769] != paletteMarker))
+  {
+    return false;
+  }
+
+  return readUInt16(myData + 66) >= Width() && Width() > 0 && Height() > 0;
+}
+
+uint32_t PcxReader::Width() const
+{
+  return readUInt16(myData + 8) - readUInt16(myData + 4) + 1u;
+}
+
+uint32_t PcxReader::Height() const
+{
+  return readUInt16(myData + 10) - readUInt16(myData + 6) + 1u;
+}
+
+bool PcxReader::Decode(Image* image) const
+{
+  if (!IsValid()) return false;
+
+  const uint8_t planes = myData[65];
+  const size_t bytesPerLine = readUInt16(myData + 66);
+  const size_t lineSize = bytesPerLine * planes;
+  const size_t encodedEnd = planes == 1 ? mySize - 769 : mySize;
+
+  // A run is two bytes for at most 63 pixels so anything bigger than that is
+  // bad data, which shouldn't cause a large allocation.
+  if (lineSize * Height() > (encodedEnd - headerSize) * 32) return false;
+
+  image->width = Width();
+  image->height = Height();
+  image->pixels.resize(size_t(image->width) * image->height * 4);
+
+  // Decode every row into one buffer as some encoders let a run carry on
+  // from one row to the next. Runs are filled with memset and the bytes
+  // between runs are copied together, rather than a byte at a time.
+  std::vector<uint8_t> decoded(lineSize * image->height);
+  uint8_t* output = decoded.data();
+  uint8_t* const outputEnd = output + decoded.size();
+  const uint8_t* input = myData + headerSize;
+  const uint8_t* const inputEnd = myData + encodedEnd;
+  while (output < outputEnd && input < inputEnd)
+  {
+    if ((*input & runMask) == runMask)
+    {
+      if (input + 1 == inputEnd) return false;
+      size_t count = *input & ~runMask;
+      if (count > size_t(outputEnd - output)) count = outputEnd - output;
+      memset(output, input[1], count);
+      output += count;
+      input += 2;
+    }
+    else
+    {
+      const uint8_t* literal = input;
+      while (input < inputEnd && (*input & runMask) != runMask &&
+             size_t(input - literal) < size_t(outputEnd - output))
+      {
+        ++input;
+      }
+      memcpy(output, literal, input - literal);
+      output += input - literal;
+    }
+  }
+  if (output != outputEnd) return false;
+
+  if (planes == 1)
+  {
+    Palette palette;
+    memcpy(palette.colours, myData + mySize - 768, sizeof(palette.colours));
+    for (uint32_t y = 0; y < image->height; ++y)
+    {
+      ExpandPalette(decoded.data() + y * lineSize, image->width, palette,
+                    image->pixels.data() + size_t(y) * image->width * 4);
+    }
+  }
+  else
+  {
+    // Each row has all the red, then all the green and then all the blue.
+    for (uint32_t y = 0; y < image->height; ++y)
+    {
+      const uint8_t* line = decoded.data() + y * lineSize;
+      uint8_t* pixel = image->pixels.data() + size_t(y) * image->width * 4;
+      for (uint32_t x = 0; x < image->width; ++x, pixel += 4)
+      {
+        pixel[0] = line[x];
+        pixel[1] = line[bytesPerLine + x];
+        pixel[2] = line[bytesPerLine * 2 + x];
+        pixel[3] = 255;
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,56 @@
+#ifndef PCX_HPP_GUARD
+#define PCX_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : PcxReader
+// PURPOSE      : Providing a decoder for the PCX image format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The game uses PCX images for the full screen pictures such as
+//                the title and the briefing backgrounds.
+//
+//                The file format is as follows:
+//
+//                 | Header - 128 bytes, starting with 10 and giving the size
+//                 |          of the image, the bits per pixel, the number of
+//                 |          planes and the bytes in each row of a plane.
+//                 | Pixels - run-length encoded, a byte with the top two bits
+//                 |          set is a count of how many times the byte after
+//                 |          it is repeated and any other byte is itself.
+//                 | Palette - 12 followed by the 256 colours as 3 bytes each,
+//                 |           for images with 8 bits per pixel in one plane.
+//
+//                Images with 8 bits per pixel in one plane (indexed) or three
+//                planes (red, green and blue) are supported.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Image;
+
+class PcxReader
+{
+public:
+  // The reader should not outlive the data.
+  PcxReader(const uint8_t* data, size_t size);
+
+  bool IsValid() const;
+  // Returns true if the header is for a supported PCX image.
+
+  uint32_t Width() const;
+  uint32_t Height() const;
+
+  bool Decode(Image* image) const;
+  // Decodes the image into red, green, blue and alpha. Returns false if the
+  // data ends early.
+
+private:
+  const uint8_t* const myData;
+  const size_t mySize;
+};
+
+#endif
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Ply
+// PURPOSE      : Providing the export of levels to the Polygon File Format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Writes the vertices of a level and the quads of its surface
+//                as an ASCII PLY file, which is the same for the levels of
+//                Descent 1 and Descent 2.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ply.hpp"
+
+#include "cube.hpp"
+#include "lightbake.hpp"
+#include "quads.hpp"
+#include "rdl.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+void ExportToPly(const std::vector<Vertex>& vertices,
+                 const std::vector<Quad>& quads, const BakedLight& light,
+                 const std::string& Name, std::ostream& Output)
+{
+  const bool verticesOnly = false;
+
+  Output << "ply" << "\n";
+  Output << "format ascii 1.0" << "\n";
+  Output << "comment An exported Descent level (" << Name << ")" << "\n";
+
+  Output << "element vertex " << vertices.size() << "\n";
+  Output << "property float x" << "\n";
+  Output << "property float y" << "\n";
+  Output << "property float z" << "\n";
+  Output << "property float intensity" << "\n";
+  if (!verticesOnly)
+  {
+    Output << "element face " << quads.size() << "\n";
+    Output << "property list uchar int vertex_index" << "\n";
+    Output << "property float intensity" << "\n";
+  }
+  Output << "end_header" << "\n";
+
+  for (size_t i = 0; i < vertices.size(); ++i)
+  {
+    const Vertex& v = vertices[i];
+    Output << v.x << " " << v.y << " " << v.z << " " << light.vertices[i]
+           << "\n";
+  }
+
+  if (!verticesOnly)
+  {
+    std::for_each(quads.begin(), quads.end(),
+                  [&Output, &light](const Quad& quad)
+    {
+      Output << "4 " << quad.a << " " << quad.b << " " << quad.c << " "
+             << quad.d << " " << light.sides[quad.cube * 6 + quad.side]
+             << "\n";
+    });
+  }
+}
+
+void ExportToPly(const RdlReader& Reader, const std::string& Name,
+                 std::ostream& Output)
+{
+  std::vector<Cube> cubes(Reader.CubeCount());
+  std::vector<CubeLights> lights(cubes.size());
+  Reader.ReadCubes(cubes.data(), lights.data());
+
+  const auto vertices = Reader.Vertices();
+  const BakedLight light = BakeLight(cubes, vertices, lights);
+  ExportToPly(vertices, Quads(cubes), light, Name, Output);
+}
@@ -0,0 +1,38 @@
+#ifndef PLY_HPP_GUARD
+#define PLY_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Ply
+// PURPOSE      : Providing the export of levels to the Polygon File Format.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Writes the vertices of a level and the quads of its surface
+//                as an ASCII PLY file.
+//
+//                The baked light of the level is written as an intensity
+//                property of each vertex and each face, from 0 for black
+//                upwards with 1 at full brightness.
+//
+//===----------------------------------------------------------------------===//
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class RdlReader;
+struct BakedLight;
+struct Quad;
+struct Vertex;
+
+void ExportToPly(const RdlReader& Reader, const std::string& Name,
+                 std::ostream& Output);
+// Writes the level with its light baked.
+
+void ExportToPly(const std::vector<Vertex>& Vertices,
+                 const std::vector<Quad>& Quads, const BakedLight& Light,
+                 const std::string& Name, std::ostream& Output);
+// Writes a level which has already been decoded along with its baked light.
+
+#endif
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Png
+// PURPOSE      : Providing a way to write images as PNG files.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Writes the signature, the header, the image data as a zlib
+//                stream of stored blocks and the end chunk.
+//
+//===----------------------------------------------------------------------===//
+
+#include "png.hpp"
+
+#include "image.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#include <string.h>
+
+static const uint8_t signature[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26,
+                                      '\n' };
+
+// The most bytes that a stored deflate block can have.
+static const size_t maxBlockSize = 65535;
+
+// The table for the CRC-32 used by PNG, which isn't the same polynomial as
+// the one in crc32c.hpp.
+struct CrcTable
+{
+  uint32_t table[256];
+
+  CrcTable()
+  {
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit)
+      {
+        crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+      }
+      table[i] = crc;
+    }
+  }
+};
+
+static const CrcTable crcTable;
+
+static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+{
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc = crcTable.table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+static void appendUInt32(std::vector<uint8_t>* data, uint32_t value)
+{
+  data->push_back(static_cast<uint8_t>(value >> 24));
+  data->push_back(static_cast<uint8_t>(value >> 16));
+  data->push_back(static_cast<uint8_t>(value >> 8));
+  data->push_back(static_cast<uint8_t>(value));
+}
+
+// Writes a chunk which is its size, its type, its data and the CRC of the
+// type and data.
+static void writeChunk(std::ostream& output, const char* type,
+                       const std::vector<uint8_t>& data)
+{
+  std::vector<uint8_t> chunk;
+  chunk.reserve(data.size() + 12);
+  appendUInt32(&chunk, static_cast<uint32_t>(data.size()));
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+  appendUInt32(&chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+  output.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+bool WritePng(const Image& image, std::ostream& output)
+{
+  output.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+  std::vector<uint8_t> header;
+  appendUInt32(&header, image.width);
+  appendUInt32(&header, image.height);
+  header.push_back(8); // Bits per channel
+  header.push_back(6); // Red, green, blue and alpha
+  header.push_back(0); // Deflate
+  header.push_back(0); // Adaptive filtering
+  header.push_back(0); // Not interlaced
+  writeChunk(output, "IHDR", header);
+
+  // Each row starts with the filter, 0 is none.
+  const size_t rowSize = size_t(image.width) * 4;
+  const size_t rawSize = (rowSize + 1) * image.height;
+  const size_t blockCount = rawSize == 0 ? 1 :
+                                           (rawSize + maxBlockSize - 1) /
+                                             maxBlockSize;
+
+  std::vector<uint8_t> raw;
+  raw.reserve(rawSize);
+  for (uint32_t y = 0; y < image.height; ++y)
+  {
+    raw.push_back(0);
+    const uint8_t* row = image.pixels.data() + y * rowSize;
+    raw.insert(raw.end(), row, row + rowSize);
+  }
+
+  // The zlib header, then the blocks and then the Adler-32 of the data.
+  std::vector<uint8_t> data;
+  data.reserve(2 + rawSize + blockCount * 5 + 4);
+  data.push_back(0x78);
+  data.push_back(0x01);
+
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (size_t block = 0; block < blockCount; ++block)
+  {
+    const size_t start = block * maxBlockSize;
+    const size_t size = std::min(maxBlockSize, rawSize - start);
+    const bool isLast = block + 1 == blockCount;
+    data.push_back(isLast ? 1 : 0);
+    data.push_back(static_cast<uint8_t>(size));
+    data.push_back(static_cast<uint8_t>(size >> 8));
+    data.push_back(static_cast<uint8_t>(~size));
+    data.push_back(static_cast<uint8_t>(~size >> 8));
+    data.insert(data.end(), raw.begin() + start, raw.begin() + start + size);
+
+    // The sums can go this many bytes before they need to be reduced.
+    for (size_t i = start; i < start + size; i += 5552)
+    {
+      const size_t end = std::min(start + size, i + 5552);
+      for (size_t j = i; j < end; ++j)
+      {
+        a += raw[j];
+        b += a;
+      }
+      a %= 65521;
+      b %= 65521;
+    }
+  }
+  appendUInt32(&data, b << 16 | a);
+  writeChunk(output, "IDAT", data);
+
+  writeChunk(output, "IEND", std::vector<uint8_t>());
+  return output.good();
+}
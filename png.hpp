@@ -0,0 +1,25 @@
+#ifndef PNG_HPP_GUARD
+#define PNG_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Png
+// PURPOSE      : Providing a way to write images as PNG files.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Writes PNG files without compressing them, the image data is
+//                stored in deflate blocks that are not compressed. This keeps
+//                it simple and fast, and the images in the game are small.
+//
+//===----------------------------------------------------------------------===//
+
+#include <iosfwd>
+
+struct Image;
+
+bool WritePng(const Image& image, std::ostream& output);
+// Writes the image out as a PNG with red, green, blue and alpha for each
+// pixel. Returns false if the output couldn't be written.
+
+#endif
@@ -0,0 +1,358 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Prefetcher
+// PURPOSE      : Providing the data of the files in an archive while the ones
+//                before them are being worked on.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The io_uring is used through the system calls directly, as
+//                such this doesn't depend on liburing. The submission queue is
+//                only written to and the completion queue only read from by
+//                the thread using the prefetcher.
+//
+//                A read which the ring couldn't do, for example because the
+//                kernel is too old to read without an iovec, or which came up
+//                short is finished with an ordinary read.
+//
+//===----------------------------------------------------------------------===//
+
+#include "prefetch.hpp"
+
+#include "file.hpp"
+#include "hogreader.hpp"
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define PREFETCH_IO_URING
+#endif
+#endif
+#endif
+
+#ifdef PREFETCH_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include <memory>
+
+#include <errno.h>
+#include <string.h>
+
+// The state of each entry.
+enum
+{
+  EntryWaiting = 0, // Its read hasn't been queued.
+  EntryQueued = 1,
+  EntryReturned = 2
+};
+
+#ifdef PREFETCH_IO_URING
+struct Prefetcher::Ring
+{
+  Ring(int ringDescriptor);
+  ~Ring();
+
+  int descriptor;
+
+  // The mappings which are shared with the kernel, when the kernel supports
+  // it the completion queue is in the same mapping as the submission queue.
+  void* submissionRing;
+  size_t submissionRingSize;
+  void* completionRing;
+  size_t completionRingSize;
+  io_uring_sqe* entries;
+  size_t entriesSize;
+
+  unsigned* submissionTail;
+  unsigned submissionMask;
+  unsigned* submissionArray;
+  unsigned* completionHead;
+  unsigned* completionTail;
+  unsigned completionMask;
+  io_uring_cqe* completions;
+
+  // The number of entries which have been put in the submission queue but
+  // not yet passed to the kernel.
+  unsigned unsubmitted;
+};
+
+Prefetcher::Ring::Ring(int ringDescriptor)
+: descriptor(ringDescriptor), submissionRing(MAP_FAILED),
+  completionRing(MAP_FAILED),
+  entries(static_cast<io_uring_sqe*>(MAP_FAILED)), unsubmitted(0)
+{
+}
+
+Prefetcher::Ring::~Ring()
+{
+  if (entries != MAP_FAILED) munmap(entries, entriesSize);
+  if (completionRing != MAP_FAILED && completionRing != submissionRing)
+  {
+    munmap(completionRing, completionRingSize);
+  }
+  if (submissionRing != MAP_FAILED) munmap(submissionRing, submissionRingSize);
+  close(descriptor);
+}
+#else
+struct Prefetcher::Ring
+{
+};
+#endif
+
+Prefetcher::Prefetcher(const File& archive,
+                       const std::vector<HogEntry>& entries, size_t depth,
+                       Backend backend)
+: myArchive(archive), myEntries(entries), myBackend(Synchronous),
+  myDepth(depth == 0 ? 1 : depth), mySubmitted(0), myReturned(0),
+  myNextEntry(0), myInFlight(0), myStates(entries.size(), EntryWaiting),
+  myBuffers(entries.size()), myRing(nullptr)
+{
+  if (backend != Synchronous && StartRing()) myBackend = IoUring;
+}
+
+Prefetcher::~Prefetcher()
+{
+  // The kernel may still be writing into the buffers so it has to finish
+  // first.
+  if (myRing) Drain();
+  delete myRing;
+}
+
+Prefetcher::Backend Prefetcher::ActiveBackend() const
+{
+  return myBackend;
+}
+
+bool Prefetcher::Next(PrefetchedEntry* entry)
+{
+  if (myReturned == myEntries.size()) return false;
+
+#ifdef PREFETCH_IO_URING
+  if (myBackend == IoUring)
+  {
+    // The reads are handed to the kernel as soon as they are queued, even if
+    // there are completions waiting, so there are always depth of them being
+    // read.
+    Submit();
+    while (myRing->unsubmitted > 0)
+    {
+      const int result = syscall(__NR_io_uring_enter, myRing->descriptor,
+                                 myRing->unsubmitted, 0, 0, nullptr, 0);
+      if (result >= 0)
+      {
+        myRing->unsubmitted -= result;
+        if (result == 0) break; // The kernel can't take any more for now.
+      }
+      else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+      {
+        Drain();
+        myBackend = Synchronous;
+        return Next(entry);
+      }
+      else if (errno != EINTR)
+      {
+        break; // The kernel is busy, they are handed to it while waiting.
+      }
+    }
+
+    unsigned head = *myRing->completionHead;
+    for (;;)
+    {
+      const unsigned tail =
+        __atomic_load_n(myRing->completionTail, __ATOMIC_ACQUIRE);
+      if (head != tail) break;
+
+      const int result = syscall(__NR_io_uring_enter, myRing->descriptor,
+                                 myRing->unsubmitted, 1,
+                                 IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (result >= 0)
+      {
+        myRing->unsubmitted -= result;
+      }
+      else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+      {
+        // The ring can no longer be waited on, so the entries which haven't
+        // been returned are read directly instead once the kernel has
+        // finished with the buffers.
+        Drain();
+        myBackend = Synchronous;
+        return Next(entry);
+      }
+    }
+
+    const io_uring_cqe& completion =
+      myRing->completions[head & myRing->completionMask];
+    const size_t index = static_cast<size_t>(completion.user_data);
+    const int result = completion.res;
+    __atomic_store_n(myRing->completionHead, head + 1, __ATOMIC_RELEASE);
+    --myInFlight;
+
+    const HogEntry& hogEntry = myEntries[index];
+    entry->index = index;
+    entry->data.swap(myBuffers[index]);
+    myBuffers[index] = std::vector<uint8_t>();
+
+    const size_t done = result < 0 ? 0 : static_cast<size_t>(result);
+    entry->succeeded =
+      (done >= hogEntry.storedSize ||
+       myArchive.ReadAt(hogEntry.offset + done, entry->data.data() + done,
+                        hogEntry.storedSize - done)) &&
+      DecodeEntry(hogEntry, &entry->data);
+    myStates[index] = EntryReturned;
+    ++myReturned;
+    return true;
+  }
+#endif
+
+  // Read the first entry which hasn't been returned, any reads the ring had
+  // queued are read again.
+  while (myStates[myNextEntry] == EntryReturned) ++myNextEntry;
+
+  const HogEntry& hogEntry = myEntries[myNextEntry];
+  entry->index = myNextEntry;
+  entry->succeeded = ReadEntry(myArchive, hogEntry, &entry->data);
+  myStates[myNextEntry] = EntryReturned;
+  ++myReturned;
+  return true;
+}
+
+bool Prefetcher::StartRing()
+{
+#ifdef PREFETCH_IO_URING
+  if (!myArchive.IsValid()) return false;
+
+  io_uring_params parameters;
+  memset(&parameters, 0, sizeof(parameters));
+  const int descriptor =
+    syscall(__NR_io_uring_setup, static_cast<unsigned>(myDepth),
+            &parameters);
+  if (descriptor < 0) return false;
+
+  std::unique_ptr<Ring> ring(new Ring(descriptor));
+
+  ring->submissionRingSize =
+    parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+  ring->completionRingSize =
+    parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+  const bool singleMapping = parameters.features & IORING_FEAT_SINGLE_MMAP;
+  if (singleMapping)
+  {
+    if (ring->completionRingSize > ring->submissionRingSize)
+    {
+      ring->submissionRingSize = ring->completionRingSize;
+    }
+    ring->completionRingSize = ring->submissionRingSize;
+  }
+
+  ring->submissionRing =
+    mmap(nullptr, ring->submissionRingSize, PROT_READ | PROT_WRITE,
+         MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQ_RING);
+  if (ring->submissionRing != MAP_FAILED && singleMapping)
+  {
+    ring->completionRing = ring->submissionRing;
+  }
+  else if (ring->submissionRing != MAP_FAILED)
+  {
+    ring->completionRing =
+      mmap(nullptr, ring->completionRingSize, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_CQ_RING);
+  }
+
+  ring->entriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+  if (ring->completionRing != MAP_FAILED)
+  {
+    ring->entries = static_cast<io_uring_sqe*>(
+      mmap(nullptr, ring->entriesSize, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQES));
+  }
+
+  if (ring->entries == MAP_FAILED) return false;
+
+  uint8_t* submission = static_cast<uint8_t*>(ring->submissionRing);
+  uint8_t* completion = static_cast<uint8_t*>(ring->completionRing);
+  ring->submissionTail =
+    reinterpret_cast<unsigned*>(submission + parameters.sq_off.tail);
+  ring->submissionMask =
+    *reinterpret_cast<unsigned*>(submission + parameters.sq_off.ring_mask);
+  ring->submissionArray =
+    reinterpret_cast<unsigned*>(submission + parameters.sq_off.array);
+  ring->completionHead =
+    reinterpret_cast<unsigned*>(completion + parameters.cq_off.head);
+  ring->completionTail =
+    reinterpret_cast<unsigned*>(completion + parameters.cq_off.tail);
+  ring->completionMask =
+    *reinterpret_cast<unsigned*>(completion + parameters.cq_off.ring_mask);
+  ring->completions =
+    reinterpret_cast<io_uring_cqe*>(completion + parameters.cq_off.cqes);
+  // The kernel may have made the queue smaller than was asked for.
+  if (myDepth > parameters.sq_entries) myDepth = parameters.sq_entries;
+
+  myRing = ring.release();
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Prefetcher::Drain()
+{
+#ifdef PREFETCH_IO_URING
+  // The reads which were never handed to the kernel are taken back out of
+  // the queue, the kernel only looks at it when it is entered.
+  *myRing->submissionTail -= myRing->unsubmitted;
+  myInFlight -= myRing->unsubmitted;
+  myRing->unsubmitted = 0;
+
+  while (myInFlight > 0)
+  {
+    unsigned head = *myRing->completionHead;
+    const unsigned tail =
+      __atomic_load_n(myRing->completionTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) --myInFlight;
+    __atomic_store_n(myRing->completionHead, head, __ATOMIC_RELEASE);
+    if (myInFlight == 0) break;
+
+    // The reads finish whether or not the ring can be waited on, so if it
+    // can't the completions are polled for instead.
+    const int result = syscall(__NR_io_uring_enter, myRing->descriptor, 0, 1,
+                               IORING_ENTER_GETEVENTS, nullptr, 0);
+    if (result < 0 && errno != EINTR) sched_yield();
+  }
+#endif
+}
+
+void Prefetcher::Submit()
+{
+#ifdef PREFETCH_IO_URING
+  unsigned tail = *myRing->submissionTail;
+  while (myInFlight < myDepth && mySubmitted < myEntries.size())
+  {
+    const size_t index = mySubmitted++;
+    const HogEntry& hogEntry = myEntries[index];
+    myBuffers[index].resize(hogEntry.storedSize);
+
+    const unsigned slot = tail & myRing->submissionMask;
+    io_uring_sqe& request = myRing->entries[slot];
+    memset(&request, 0, sizeof(request));
+    request.opcode = IORING_OP_READ;
+    request.fd = myArchive.Descriptor();
+    request.off = hogEntry.offset;
+    request.addr = reinterpret_cast<uint64_t>(myBuffers[index].data());
+    request.len = hogEntry.storedSize;
+    request.user_data = index;
+    myRing->submissionArray[slot] = slot;
+
+    myStates[index] = EntryQueued;
+    ++tail;
+    ++myInFlight;
+    ++myRing->unsubmitted;
+  }
+  __atomic_store_n(myRing->submissionTail, tail, __ATOMIC_RELEASE);
+#endif
+}
@@ -0,0 +1,103 @@
+#ifndef PREFETCH_HPP_GUARD
+#define PREFETCH_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Prefetcher
+// PURPOSE      : Providing the data of the files in an archive while the ones
+//                before them are being worked on.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The reads for the next few files are queued with the kernel
+//                ahead of them being needed so the disk is kept busy while the
+//                files which have already been read are decoded.
+//
+//                On Linux the reads are queued with io_uring. Where that isn't
+//                available (other platforms, older kernels or when it has been
+//                turned off) each file is read when it is asked for.
+//
+//                The files are handed out in the order their reads complete,
+//                which may not be the order they were given in.
+//
+//                Files in a compressed archive are decompressed as they are
+//                handed out.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+class File;
+struct HogEntry;
+
+struct PrefetchedEntry
+{
+  size_t index; // The index of the entry in the list that was given.
+  std::vector<uint8_t> data;
+  bool succeeded; // False if the data couldn't be read.
+};
+
+class Prefetcher
+{
+public:
+  enum Backend
+  {
+    Automatic, // io_uring if it is available, otherwise synchronous.
+    IoUring,
+    Synchronous
+  };
+
+  Prefetcher(const File& archive, const std::vector<HogEntry>& entries,
+             size_t depth, Backend backend = Automatic);
+  // Starts reading the given entries of the archive, keeping up to depth of
+  // them being read at once. Neither the archive nor the entries may be
+  // destroyed before the prefetcher.
+
+  ~Prefetcher();
+
+  bool Next(PrefetchedEntry* entry);
+  // Waits for the next entry to be read and returns it. Returns false once
+  // every entry has been returned.
+
+  Backend ActiveBackend() const;
+  // Returns the backend which is being used, never Automatic.
+
+private:
+  Prefetcher(const Prefetcher&) = delete;
+  Prefetcher& operator=(const Prefetcher&) = delete;
+
+  struct Ring;
+
+  bool StartRing();
+  // Sets up the io_uring, returns false if it isn't available.
+
+  void Submit();
+  // Queues reads for the entries after the ones being read, up to the depth.
+
+  void Drain();
+  // Waits for the reads the kernel has been given to finish so it is no
+  // longer writing into the buffers, and drops the ones it hasn't been given.
+
+  const File& myArchive;
+  const std::vector<HogEntry>& myEntries;
+  Backend myBackend;
+
+  size_t myDepth;
+  size_t mySubmitted; // The number of entries whose reads have been queued.
+  size_t myReturned; // The number of entries which have been returned.
+  size_t myNextEntry; // The first entry which may not have been returned.
+  size_t myInFlight; // The number of reads which haven't been returned.
+
+  // Whether each entry is waiting, queued or returned.
+  std::vector<uint8_t> myStates;
+
+  // The buffers for the reads which are in flight, indexed by the entry.
+  std::vector<std::vector<uint8_t>> myBuffers;
+
+  Ring* myRing;
+};
+
+#endif
@@ -0,0 +1,536 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : PotentiallyVisibleSet
+// PURPOSE      : Providing which cubes can be seen from each cube.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Works out the potentially visible set of each cube by
+//                following chains of portals.
+//
+//===----------------------------------------------------------------------===//
+
+#include "pvs.hpp"
+
+#include "cube.hpp"
+#include "geometry.hpp"
+#include "parallel.hpp"
+#include "rdl.hpp"
+
+#include <deque>
+#include <ostream>
+
+#include <math.h>
+#include <string.h>
+
+// How close a point has to be to a plane to be considered on it.
+static const double epsilon = 1e-3;
+
+// The most points a clipped portal can have, each clip adds at most one.
+static const int maxPoints = 16;
+
+// The number of portals that the accurate mode will visit from a single
+// portal of a cube before it gives up and uses the result of the fast mode.
+static const size_t stepBudget = 20000;
+
+namespace
+{
+  struct Plane
+  {
+    Vertex normal;
+    double distance;
+
+    double Distance(const Vertex& point) const
+    {
+      return normal.x * point.x + normal.y * point.y + normal.z * point.z -
+             distance;
+    }
+
+    Plane Flipped() const
+    {
+      const Plane flipped = { { -normal.x, -normal.y, -normal.z }, -distance };
+      return flipped;
+    }
+  };
+
+  struct Winding
+  {
+    Vertex points[maxPoints];
+    int count;
+  };
+
+  struct Portal
+  {
+    Winding winding;
+    Plane plane; // The normal faces away from the cube the portal is in.
+    uint32_t to; // The cube on the other side.
+  };
+
+  // The portals leading out of each cube in compressed sparse row form.
+  struct Portals
+  {
+    std::vector<uint32_t> offsets;
+    std::vector<Portal> portals;
+  };
+
+  // The portals being followed at one step along a chain.
+  struct Frame
+  {
+    Winding source;
+    Winding pass;
+    Winding clipped;
+    Winding separated;
+  };
+
+  // The working space for one thread.
+  struct Scratch
+  {
+    std::vector<uint32_t> mightSee; // Stamped with the current generation.
+    std::vector<uint8_t> onChain;
+    std::vector<uint32_t> queue;
+    std::deque<Frame> frames;
+    uint32_t generation;
+    size_t steps;
+
+    Scratch() : generation(0), steps(0)
+    {
+    }
+  };
+
+  Vertex subtract(const Vertex& a, const Vertex& b)
+  {
+    const Vertex result = { a.x - b.x, a.y - b.y, a.z - b.z };
+    return result;
+  }
+
+  Vertex cross(const Vertex& a, const Vertex& b)
+  {
+    const Vertex result = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+                            a.x * b.y - a.y * b.x };
+    return result;
+  }
+
+  double dot(const Vertex& a, const Vertex& b)
+  {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+  }
+
+  // Keeps the part of the winding in front of the plane. Returns false if
+  // nothing is in front of it.
+  bool clip(const Winding& in, const Plane& plane, Winding* out)
+  {
+    double distances[maxPoints];
+    bool anyFront = false;
+    bool anyBack = false;
+    for (int i = 0; i < in.count; ++i)
+    {
+      distances[i] = plane.Distance(in.points[i]);
+      if (distances[i] > epsilon) anyFront = true;
+      if (distances[i] < -epsilon) anyBack = true;
+    }
+
+    if (!anyFront) return false;
+    if (!anyBack)
+    {
+      *out = in;
+      return true;
+    }
+
+    out->count = 0;
+    for (int i = 0; i < in.count; ++i)
+    {
+      const int next = (i + 1) % in.count;
+      const Vertex& a = in.points[i];
+      const Vertex& b = in.points[next];
+
+      // Running out of room means keeping the whole winding, which can only
+      // make the result bigger (conservative) not smaller.
+      if (out->count + 2 > maxPoints)
+      {
+        *out = in;
+        return true;
+      }
+
+      if (distances[i] >= -epsilon) out->points[out->count++] = a;
+
+      if ((distances[i] > epsilon && distances[next] < -epsilon) ||
+          (distances[i] < -epsilon && distances[next] > epsilon))
+      {
+        const double t = distances[i] / (distances[i] - distances[next]);
+        const Vertex point = { a.x + t * (b.x - a.x), a.y + t * (b.y - a.y),
+                               a.z + t * (b.z - a.z) };
+        out->points[out->count++] = point;
+      }
+    }
+    return out->count >= 3;
+  }
+
+  // Clips the target to the planes which have the source entirely on one
+  // side and the pass on the other. If flip is false the part of the target
+  // on the same side as the pass is kept, otherwise the other side.
+  bool clipToSeparators(const Winding& source, const Winding& pass,
+                        const Winding& target, bool flip, Winding* out)
+  {
+    Winding current = target;
+    for (int i = 0; i < source.count; ++i)
+    {
+      const int next = (i + 1) % source.count;
+      const Vertex edge = subtract(source.points[next], source.points[i]);
+
+      for (int j = 0; j < pass.count; ++j)
+      {
+        Vertex normal = cross(edge, subtract(pass.points[j], source.points[i]));
+        const double length = sqrt(dot(normal, normal));
+        if (length < epsilon) continue;
+
+        normal.x /= length;
+        normal.y /= length;
+        normal.z /= length;
+        Plane plane = { normal, dot(pass.points[j], normal) };
+
+        // Find which side the source is on and flip the plane so it is behind.
+        int side = 0;
+        for (int k = 0; k < source.count && side == 0; ++k)
+        {
+          if (k == i || k == next) continue;
+          const double distance = plane.Distance(source.points[k]);
+          if (distance < -epsilon) side = -1;
+          if (distance > epsilon) side = 1;
+        }
+        if (side == 0) continue; // The source is on the plane.
+        if (side == 1) plane = plane.Flipped();
+
+        // It only separates them if the pass is in front of it.
+        bool separates = true;
+        for (int k = 0; k < pass.count && separates; ++k)
+        {
+          if (k == j) continue;
+          if (plane.Distance(pass.points[k]) < -epsilon) separates = false;
+        }
+        if (!separates) continue;
+
+        if (flip) plane = plane.Flipped();
+
+        Winding clipped;
+        if (!clip(current, plane, &clipped)) return false;
+        current = clipped;
+      }
+    }
+
+    *out = current;
+    return true;
+  }
+
+  Portals buildPortals(const std::vector<Cube>& cubes,
+                       const std::vector<Vertex>& vertices)
+  {
+    Portals portals;
+    portals.offsets.reserve(cubes.size() + 1);
+    for (size_t i = 0; i < cubes.size(); ++i)
+    {
+      portals.offsets.push_back(static_cast<uint32_t>(portals.portals.size()));
+      const Cube& cube = cubes[i];
+
+      Vertex centre = { 0.0, 0.0, 0.0 };
+      for (int j = 0; j < 8; ++j)
+      {
+        const Vertex& vertex = vertices[cube.vertices[j]];
+        centre.x += vertex.x / 8;
+        centre.y += vertex.y / 8;
+        centre.z += vertex.z / 8;
+      }
+
+      for (int side = 0; side < 6; ++side)
+      {
+        const int16_t neighbour = cube.neighbors[side];
+        if (neighbour < 0 || static_cast<size_t>(neighbour) >= cubes.size())
+        {
+          continue;
+        }
+
+        // A wall (or door) blocks the view.
+        if (cube.walls[side] != 255) continue;
+
+        Portal portal;
+        portal.to = static_cast<uint32_t>(neighbour);
+        portal.winding.count = 4;
+        Vertex middle = { 0.0, 0.0, 0.0 };
+        for (int j = 0; j < 4; ++j)
+        {
+          const Vertex& vertex =
+              vertices[cube.vertices[sideVertices[side][j]]];
+          portal.winding.points[j] = vertex;
+          middle.x += vertex.x / 4;
+          middle.y += vertex.y / 4;
+          middle.z += vertex.z / 4;
+        }
+
+        // Newell's method gives a good normal even if the side isn't flat.
+        Vertex normal = { 0.0, 0.0, 0.0 };
+        for (int j = 0; j < 4; ++j)
+        {
+          const Vertex& a = portal.winding.points[j];
+          const Vertex& b = portal.winding.points[(j + 1) % 4];
+          normal.x += (a.y - b.y) * (a.z + b.z);
+          normal.y += (a.z - b.z) * (a.x + b.x);
+          normal.z += (a.x - b.x) * (a.y + b.y);
+        }
+        const double length = sqrt(dot(normal, normal));
+        if (length < epsilon) continue; // The side has collapsed.
+        normal.x /= length;
+        normal.y /= length;
+        normal.z /= length;
+
+        if (dot(normal, subtract(middle, centre)) < 0.0)
+        {
+          normal.x = -normal.x;
+          normal.y = -normal.y;
+          normal.z = -normal.z;
+        }
+
+        portal.plane.normal = normal;
+        portal.plane.distance = dot(normal, middle);
+        portals.portals.push_back(portal);
+      }
+    }
+    portals.offsets.push_back(static_cast<uint32_t>(portals.portals.size()));
+    return portals;
+  }
+
+  class RowBuilder
+  {
+  public:
+    RowBuilder(const Portals& portals, uint64_t* row, Scratch* scratch)
+    : myPortals(portals), myRow(row), myScratch(*scratch)
+    {
+    }
+
+    void Set(uint32_t cube)
+    {
+      myRow[cube / 64] |= uint64_t(1) << (cube % 64);
+    }
+
+    // Stamps the cubes which might be seen through the portal, these are the
+    // cubes reached through portals which are at least partly in front of it.
+    void Flood(const Portal& first)
+    {
+      Scratch& scratch = myScratch;
+      if (++scratch.generation == 0)
+      {
+        std::fill(scratch.mightSee.begin(), scratch.mightSee.end(), 0);
+        scratch.generation = 1;
+      }
+
+      scratch.queue.clear();
+      scratch.queue.push_back(first.to);
+      scratch.mightSee[first.to] = scratch.generation;
+      for (size_t head = 0; head < scratch.queue.size(); ++head)
+      {
+        const uint32_t cube = scratch.queue[head];
+        for (uint32_t i = myPortals.offsets[cube];
+             i < myPortals.offsets[cube + 1]; ++i)
+        {
+          const Portal& portal = myPortals.portals[i];
+          if (scratch.mightSee[portal.to] == scratch.generation) continue;
+
+          bool inFront = false;
+          for (int j = 0; j < portal.winding.count && !inFront; ++j)
+          {
+            inFront = first.plane.Distance(portal.winding.points[j]) > epsilon;
+          }
+          if (!inFront) continue;
+
+          scratch.mightSee[portal.to] = scratch.generation;
+          scratch.queue.push_back(portal.to);
+        }
+      }
+    }
+
+    void SetMightSee()
+    {
+      for (auto cube = myScratch.queue.begin(); cube != myScratch.queue.end();
+           ++cube)
+      {
+        Set(*cube);
+      }
+    }
+
+    // Follows the portals out of the cube which the source can be seen
+    // through. Returns false if it ran out of steps.
+    bool Flow(uint32_t cube, const Plane& sourcePlane, const Plane& passPlane,
+              size_t depth)
+    {
+      Scratch& scratch = myScratch;
+      while (scratch.frames.size() <= depth + 1)
+      {
+        scratch.frames.push_back(Frame());
+      }
+      const Frame& frame = scratch.frames[depth];
+      Frame& next = scratch.frames[depth + 1];
+
+      scratch.onChain[cube] = 1;
+      bool isComplete = true;
+      for (uint32_t i = myPortals.offsets[cube];
+           i < myPortals.offsets[cube + 1] && isComplete; ++i)
+      {
+        const Portal& portal = myPortals.portals[i];
+        if (scratch.onChain[portal.to]) continue;
+        if (scratch.mightSee[portal.to] != scratch.generation) continue;
+
+        if (++scratch.steps > stepBudget)
+        {
+          isComplete = false;
+          break;
+        }
+
+        // The target must be beyond the portal it is seen through.
+        if (!clip(portal.winding, passPlane, &next.clipped)) continue;
+        if (!clip(next.clipped, sourcePlane, &next.pass)) continue;
+
+        if (depth == 0)
+        {
+          next.source = frame.source;
+        }
+        else
+        {
+          // Only the part of the source behind the target can see it.
+          if (!clip(frame.source, portal.plane.Flipped(), &next.source))
+          {
+            continue;
+          }
+
+          if (!clipToSeparators(next.source, frame.pass, next.pass, false,
+                                &next.separated))
+          {
+            continue;
+          }
+
+          if (!clipToSeparators(frame.pass, next.source, next.separated, true,
+                                &next.pass))
+          {
+            continue;
+          }
+        }
+
+        Set(portal.to);
+        isComplete = Flow(portal.to, sourcePlane, portal.plane, depth + 1);
+      }
+      scratch.onChain[cube] = 0;
+      return isComplete;
+    }
+
+  private:
+    const Portals& myPortals;
+    uint64_t* myRow;
+    Scratch& myScratch;
+  };
+}
+
+PotentiallyVisibleSet::PotentiallyVisibleSet(
+    const std::vector<Cube>& cubes, const std::vector<Vertex>& vertices,
+    Mode mode)
+: myCubeCount(cubes.size()), myWordsPerRow((cubes.size() + 63) / 64),
+  myBits(myCubeCount * myWordsPerRow, 0)
+{
+  for (auto cube = cubes.begin(); cube != cubes.end(); ++cube)
+  {
+    for (int i = 0; i < 8; ++i)
+    {
+      // The level is broken, so consider every cube visible.
+      if (cube->vertices[i] >= vertices.size())
+      {
+        std::fill(myBits.begin(), myBits.end(), ~uint64_t(0));
+        return;
+      }
+    }
+  }
+
+  const Portals portals = buildPortals(cubes, vertices);
+
+  std::vector<Scratch> scratches(ThreadCount());
+  ParallelFor(myCubeCount, [&](size_t index, size_t thread)
+  {
+    Scratch& scratch = scratches[thread];
+    if (scratch.mightSee.size() != myCubeCount)
+    {
+      scratch.mightSee.assign(myCubeCount, 0);
+      scratch.onChain.assign(myCubeCount, 0);
+      scratch.generation = 0;
+    }
+
+    const uint32_t cube = static_cast<uint32_t>(index);
+    RowBuilder builder(portals, &myBits[index * myWordsPerRow], &scratch);
+    builder.Set(cube);
+
+    for (uint32_t i = portals.offsets[cube]; i < portals.offsets[cube + 1];
+         ++i)
+    {
+      const Portal& portal = portals.portals[i];
+      builder.Set(portal.to);
+      builder.Flood(portal);
+
+      if (mode == Fast)
+      {
+        builder.SetMightSee();
+        continue;
+      }
+
+      scratch.frames.resize(1);
+      scratch.frames[0].source = portal.winding;
+      scratch.frames[0].pass = portal.winding;
+      scratch.steps = 0;
+
+      scratch.onChain[cube] = 1;
+      const bool isComplete =
+          builder.Flow(portal.to, portal.plane, portal.plane, 0);
+      scratch.onChain[cube] = 0;
+
+      // There were too many chains to follow, so fall back to the cubes that
+      // might be seen to stay conservative.
+      if (!isComplete) builder.SetMightSee();
+    }
+  });
+}
+
+size_t PotentiallyVisibleSet::CubeCount() const
+{
+  return myCubeCount;
+}
+
+bool PotentiallyVisibleSet::IsVisible(uint32_t from, uint32_t to) const
+{
+  return (Row(from)[to / 64] >> (to % 64)) & 1;
+}
+
+const uint64_t* PotentiallyVisibleSet::Row(uint32_t cube) const
+{
+  return myBits.data() + cube * myWordsPerRow;
+}
+
+size_t PotentiallyVisibleSet::WordsPerRow() const
+{
+  return myWordsPerRow;
+}
+
+size_t PotentiallyVisibleSet::VisibleCount(uint32_t cube) const
+{
+  size_t count = 0;
+  const uint64_t* row = Row(cube);
+  for (size_t i = 0; i < myWordsPerRow; ++i)
+  {
+    for (uint64_t word = row[i]; word; word &= word - 1) ++count;
+  }
+  return count;
+}
+
+bool PotentiallyVisibleSet::Write(std::ostream& output) const
+{
+  const uint32_t header[3] = { 1, static_cast<uint32_t>(myCubeCount),
+                               static_cast<uint32_t>(myWordsPerRow) };
+  output.write("DPVS", 4);
+  output.write(reinterpret_cast<const char*>(header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(myBits.data()),
+               myBits.size() * sizeof(uint64_t));
+  return output.good();
+}
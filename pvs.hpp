@@ -0,0 +1,84 @@
+#ifndef PVS_HPP_GUARD
+#define PVS_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : PotentiallyVisibleSet
+// PURPOSE      : Providing which cubes can be seen from each cube.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The sides which two cubes share, without a wall on them, are
+//                portals. A cube can only be seen from another cube if there
+//                is a line which passes through a chain of portals from one to
+//                the other.
+//
+//                The accurate mode follows each chain of portals from a cube
+//                and clips the next portal to the planes that separate the
+//                first portal from the last one, if nothing is left the line
+//                of sight is blocked. This is the same approach as the vis
+//                tool for Quake.
+//
+//                The fast mode only requires that each portal in the chain is
+//                in front of the first portal. This is conservative, it never
+//                misses a cube which can be seen but may include cubes which
+//                can't.
+//
+//                The sets are stored as a bit per cube for each cube, and can
+//                be written out as a file with the following format:
+//
+//                 | "DPVS" - 4 bytes
+//                 | version - 4 bytes (1)
+//                 | cube count - 4 bytes
+//                 | words per row - 4 bytes
+//                 | rows - a row of 64-bit words per cube where bit n of the
+//                 |        row for cube m is set if n can be seen from m.
+//
+//===----------------------------------------------------------------------===//
+
+#include <iosfwd>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+struct Vertex;
+
+class PotentiallyVisibleSet
+{
+public:
+  enum Mode
+  {
+    Accurate,
+    Fast
+  };
+
+  PotentiallyVisibleSet(const std::vector<Cube>& cubes,
+                        const std::vector<Vertex>& vertices,
+                        Mode mode = Accurate);
+  // Works out the set of cubes that can be seen from each cube, the cubes
+  // are worked on in parallel.
+
+  size_t CubeCount() const;
+
+  bool IsVisible(uint32_t from, uint32_t to) const;
+  // Returns true if the cube to might be seen from the cube from.
+
+  const uint64_t* Row(uint32_t cube) const;
+  size_t WordsPerRow() const;
+  // The bits for the cubes which can be seen from the given cube.
+
+  size_t VisibleCount(uint32_t cube) const;
+  // Returns the number of cubes which can be seen from the given cube.
+
+  bool Write(std::ostream& output) const;
+  // Writes the sets out in the format described above.
+
+private:
+  size_t myCubeCount;
+  size_t myWordsPerRow;
+  std::vector<uint64_t> myBits;
+};
+
+#endif
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Quads
+// PURPOSE      : Providing the sides of the cubes which are drawn.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Generates a quad for each side of a cube which doesn't have
+//                a neighbouring cube.
+//
+//===----------------------------------------------------------------------===//
+
+#include "quads.hpp"
+
+#include "cube.hpp"
+
+void Quads(const Cube& cube, std::vector<Quad>* quads)
+{
+  const uint16_t* const vertices = cube.vertices;
+
+  // Vertices:
+  // 0 - left, front, top
+  // 1 - left, front, bottom
+  // 2 - right, front, bottom
+  // 3 - right, front, top
+  // 4 - left, back, top
+  // 5 - left, back, bottom
+  // 6 - right, back, bottom
+  // 7 - right, back, top
+
+  // Neighbours:
+  enum Neighbour
+  {
+    Right,
+    Top,
+    Left,
+    Bottom,
+    Back,
+    Front
+  };
+
+  if (cube.neighbors[Right] == -1)
+  {
+    const Quad quad = { vertices[2], vertices[3], vertices[7], vertices[6],
+                        0, Right };
+    quads->push_back(quad);
+  }
+
+  if (cube.neighbors[Top] == -1)
+  {
+    const Quad quad = { vertices[0], vertices[3], vertices[7], vertices[4],
+                        0, Top };
+    quads->push_back(quad);
+  }
+
+  if (cube.neighbors[Left] == -1)
+  {
+    const Quad quad = { vertices[0], vertices[1], vertices[5], vertices[4],
+                        0, Left };
+    quads->push_back(quad);
+  }
+
+  if (cube.neighbors[Bottom] == -1)
+  {
+    const Quad quad = { vertices[1], vertices[2], vertices[6], vertices[5],
+                        0, Bottom };
+    quads->push_back(quad);
+  }
+
+  if (cube.neighbors[Front] == -1)
+  {
+    const Quad quad = { vertices[0], vertices[1], vertices[2], vertices[3],
+                        0, Front };
+    quads->push_back(quad);
+  }
+
+  if (cube.neighbors[Back] == -1)
+  {
+    const Quad quad = { vertices[4], vertices[5], vertices[6], vertices[7],
+                        0, Back };
+    quads->push_back(quad);
+  }
+}
+
+std::vector<Quad> Quads(const std::vector<Cube>& Cubes)
+{
+  // Generate quads from the sides of the cubes.
+  std::vector<Quad> quads;
+  for (auto cube = Cubes.cbegin(), cubeEnd = Cubes.cend(); cube != cubeEnd;
+       ++cube)
+  {
+    const size_t first = quads.size();
+    Quads(*cube, &quads);
+    for (size_t i = first; i < quads.size(); ++i)
+    {
+      quads[i].cube = static_cast<uint32_t>(cube - Cubes.cbegin());
+    }
+  }
+  return quads;
+}
@@ -0,0 +1,45 @@
+#ifndef QUADS_HPP_GUARD
+#define QUADS_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Quads
+// PURPOSE      : Providing the sides of the cubes which are drawn.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The sides of the cubes without a neighbouring cube are the
+//                surface of the level, each is a quad made up of four of the
+//                vertices of the level.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+
+struct Quad
+{
+  size_t a;
+  size_t b;
+  size_t c;
+  size_t d;
+
+  // The index of the cube the side is part of.
+  uint32_t cube;
+
+  // Which side of the cube it is, in the same order as Cube::neighbors.
+  uint8_t side;
+};
+
+void Quads(const Cube& cube, std::vector<Quad>* quads);
+// Adds the quads for the sides of the cube to the list, the cube of each quad
+// is left as 0.
+
+std::vector<Quad> Quads(const std::vector<Cube>& Cubes);
+// Returns the quads for the sides of all the cubes.
+
+#endif
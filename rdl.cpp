@@ -22,8 +22,12 @@
 
 #include "arrayreader.hpp"
 #include "cube.hpp"
+#include "object.hpp"
+
+#include <algorithm>
 
 #include <assert.h>
+#include <ctype.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -57,9 +61,90 @@ struct RdlHeader
   uint32_t version;
   uint32_t mineDataOffset;
   uint32_t objectsOffset;
+
+  // This is where the hostage text started in the versions before 5, which is
+  // the end of the file as there is none. Later versions have other data here.
   uint32_t fileSize;
 };
 
+// The part of the table at the start of the game data that is used. The
+// offsets are from the start of the file and the sizes are of each entry.
+struct RdlGameInfo
+{
+  uint16_t version;
+
+  int32_t objectsOffset;
+  int32_t objectCount;
+
+  int32_t wallsOffset;
+  int32_t wallCount;
+  int32_t wallSize;
+
+  int32_t triggersOffset;
+  int32_t triggerCount;
+  int32_t triggerSize;
+};
+
+// The number that the game data starts with.
+static const uint16_t gameInfoSignature = 0x6705;
+
+// The size of the game data table up to the end of the triggers.
+static const size_t gameInfoSize = 83;
+
+// The size of the parts of an object that are always there.
+static const size_t objectSize = 79;
+
+// The size of a wall and a trigger as read from the file.
+static const size_t wallSize = 24;
+static const size_t triggerSize = 54;
+static const size_t descent2TriggerSize = 52;
+
+// Triggers were changed in version 31 of the game data (Descent 2).
+static const uint16_t descent2TriggerVersion = 31;
+
+// The movement, control and render types which have extra data in an object.
+enum MovementType
+{
+  MovementPhysics = 1,
+  MovementSpinning = 3,
+};
+
+enum ControlType
+{
+  ControlAi = 1,
+  ControlExplosion = 2,
+  ControlWeapon = 9,
+  ControlPowerup = 13,
+  ControlLight = 14,
+};
+
+enum RenderType
+{
+  RenderPolygon = 1,
+  RenderFireball = 2,
+  RenderHostage = 4,
+  RenderPowerup = 5,
+  RenderMorph = 6,
+  RenderWeaponClip = 7,
+};
+
+inline double readFixed(ArrayReader* reader)
+{
+  return fixedToFloating(reader->ReadInt32());
+}
+
+// Returns the count from the game data, limited to the number of records of
+// the given size which fit between the offset and the end of the data so a
+// count which is wrong can't make room for more than there are.
+inline size_t recordCount(int32_t count, int32_t offset, size_t size,
+                          size_t dataSize)
+{
+  if (count <= 0 || offset < 0) return 0;
+  if (static_cast<size_t>(offset) >= dataSize) return 0;
+  const size_t limit = (dataSize - offset) / size;
+  return std::min(static_cast<size_t>(count), limit);
+}
+
 struct RdlTexture
 {
   uint16_t primaryTextureNumber;
@@ -82,33 +167,73 @@ static_assert(sizeof(RdlHeader) == 20,
 #endif
 
 RdlReader::RdlReader(const std::vector<uint8_t>& Data)
+: myData(Data.data()),
+  mySize(Data.size()),
+  myHeader(reinterpret_cast<const struct RdlHeader* const>(Data.data()))
+{
+}
+
+RdlReader::RdlReader(const uint8_t* Data, size_t Size)
 : myData(Data),
-  myHeader(reinterpret_cast<const struct RdlHeader* const>(&Data.front()))
+  mySize(Size),
+  myHeader(reinterpret_cast<const RdlHeader*>(Data))
 {
-  // printf("Version: %d\n", myHeader->version);
-  // printf("Mine data offset: %d\n", myHeader->mineDataOffset);
-  // printf("Object offset: %d\n", myHeader->objectsOffset);
 }
 
 bool RdlReader::IsValid() const
 {
-  if (myData.size() < sizeof(magicRdl)) return false;
-  if (memcmp(magicRdl, &myData.front(), sizeof(magicRdl)) != 0) return false;
+  if (mySize < sizeof(magicRdl)) return false;
+  if (memcmp(magicRdl, myData, sizeof(magicRdl)) != 0) return false;
+
+  if (mySize < sizeof(RdlHeader)) return false;
 
-  return myHeader->fileSize == myData.size();
+  // Only the versions before 5 have the end of the file in the header.
+  if (myHeader->version < 5)
+  {
+    if (myHeader->fileSize != mySize) return false;
+  }
+  else if (myHeader->objectsOffset > mySize)
+  {
+    return false;
+  }
+
+  // The counts and the vertices must be within the data.
+  if (myHeader->mineDataOffset >= mySize ||
+      mySize - myHeader->mineDataOffset < 1 + 4)
+  {
+    return false;
+  }
+  return CubeOffset() <= mySize;
+}
+
+size_t RdlReader::VertexCount() const
+{
+  const size_t index = myHeader->mineDataOffset + 1 /* version byte */;
+  return (myData[index + 1] << 8) + myData[index + 0];
+}
+
+size_t RdlReader::CubeCount() const
+{
+  const size_t index = myHeader->mineDataOffset + 1 /* version byte */;
+  return (myData[index + 3] << 8) + myData[index + 2];
 }
 
 std::vector<Vertex> RdlReader::Vertices() const
 {
-  // First step, determine how many vertices there are.
-  size_t index = myHeader->mineDataOffset + 1 /* version byte */;
-  const uint16_t vertexCount = (myData[index + 1] << 8) + myData[index + 0];
-  std::vector<Vertex> vertices(vertexCount);
+  std::vector<Vertex> vertices(VertexCount());
+  ReadVertices(vertices.data());
+  return vertices;
+}
 
-  index += 4; // For reading the vertex count and skipping the cube count.
+void RdlReader::ReadVertices(Vertex* vertices) const
+{
+  const size_t vertexCount = VertexCount();
+
+  // Skip the version, the vertex count and the cube count.
+  size_t index = myHeader->mineDataOffset + 1 + 4;
 
   int32_t buffer[3];
-  for (int i = 0; i < vertexCount; index += 12, ++i)
+  for (size_t i = 0; i < vertexCount; index += 12, ++i)
   {
     // 32-bit fixed point number, in 16:16 format
     memcpy(&buffer, &myData[index], 3 * sizeof(int32_t));
@@ -119,33 +244,147 @@ std::vector<Vertex> RdlReader::Vertices() const
   }
 
   assert(index == CubeOffset());
-  return vertices;
 }
 
-std::vector<Cube> RdlReader::Cubes() const
+// The ways the cubes were stored in the different versions of the format.
+// Each is a set of constants so that the loop which reads the cubes can be
+// compiled once for each of them without checking the version for each cube.
+//
+// The special data is what makes a cube an energy centre or a robot maker,
+// the first versions only have it if the bit after the neighbours is set.
+struct Descent1Layout // Version 1
 {
-  ArrayReader reader(myData.data(), myData.size());
-  reader.Seek(myHeader->mineDataOffset + 1 /* version */);
+  static const bool specialBeforeVertices = false;
+  static const bool specialAfterVertices = true;
+  static const bool lightingInCube = true;
+  static const bool extraCubeData = false;
+};
 
-  // First step, determine how many vertices and cubes there are.
-  const uint16_t vertexCount = reader.ReadUInt16();
-  const uint16_t cubeCount = reader.ReadUInt16();
+struct Descent2EarlyLayout // Versions 2 to 4
+{
+  static const bool specialBeforeVertices = false;
+  static const bool specialAfterVertices = false;
+  static const bool lightingInCube = true;
+  static const bool extraCubeData = false;
+};
 
-  // Skip over the vertex data and go to the cubes.
-  reader.Seek(CubeOffset());
-  std::vector<Cube> cubes(cubeCount);
+struct Descent2SharewareLayout // Version 5
+{
+  static const bool specialBeforeVertices = true;
+  static const bool specialAfterVertices = false;
+  static const bool lightingInCube = true;
+  static const bool extraCubeData = false;
+};
+
+// After all of the cubes there is an array with an entry for each cube that
+// has its special data and lighting.
+struct Descent2Layout // Version 6 and later
+{
+  static const bool specialBeforeVertices = false;
+  static const bool specialAfterVertices = false;
+  static const bool lightingInCube = false;
+  static const bool extraCubeData = true;
+};
+
+// The bit of the neighbour bitmask which is set if the special data follows.
+static const uint8_t specialBit = 1 << 6;
+
+inline double cubeLighting(int16_t rawLighting)
+{
+  return rawLighting / (24 * 327.68);
+}
+
+// The light in a UVL is a fixed point number in 1.15 format.
+inline float cornerLighting(uint16_t rawLighting)
+{
+  return rawLighting / 32768.0f;
+}
+
+// Returns true if there are at least count bytes left to read.
+inline bool canRead(const ArrayReader* reader, size_t count)
+{
+  return count <= reader->Size() - reader->Index();
+}
+
+// Returns the number of bits which are set in the lowest six bits, which is
+// the number of sides that something is given for.
+inline size_t sideCount(uint8_t bitmask)
+{
+  size_t count = 0;
+  for (int side = 0; side < 6; ++side)
+  {
+    if (bitmask & (1 << side)) ++count;
+  }
+  return count;
+}
+
+inline void readSpecial(ArrayReader* reader, uint8_t neighbourBitmask,
+                        Cube* cube)
+{
+  if (neighbourBitmask & specialBit)
+  {
+    cube->special = reader->ReadByte();
+    cube->matcen = reader->ReadByte();
+    cube->value = reader->ReadInt16();
+  }
+}
+
+// Read the indices of the eight vertices that make up the cube. Returns false
+// if any of them isn't one of the vertices of the level.
+inline bool readVertices(ArrayReader* reader, uint16_t vertexCount,
+                         Cube* cube)
+{
+  bool isValid = true;
+  for (uint8_t j = 0; j < 8; ++j)
+  {
+    cube->vertices[j] = reader->ReadUInt16();
+    if (cube->vertices[j] >= vertexCount) isValid = false;
+  }
+  return isValid;
+}
+
+// The lights are only read if they are given, otherwise they are skipped.
+//
+// Returns false if the data ends before the last cube or a cube has a vertex
+// which isn't in the level. Reading stops where the data ends, the cubes with
+// a vertex which isn't in the level are still read.
+template <typename Layout>
+static bool readCubes(ArrayReader* reader, uint16_t vertexCount,
+                      uint16_t cubeCount, Cube* cubes, CubeLights* lights)
+{
+  bool isValid = true;
   for (int i = 0; i < cubeCount; ++i)
   {
     Cube& cube = cubes[i];
-    const uint8_t neighbourBitmask = reader.ReadByte();
-    const bool isEnergyCenter = (neighbourBitmask & (1 << 6)) != 0;
+    cube.special = 0;
+    cube.matcen = -1;
+    cube.value = 0;
+
+    if (!canRead(reader, 1)) return false;
+    const uint8_t neighbourBitmask = reader->ReadByte();
+
+    // Everything up to and including the wall bit mask.
+    const bool hasSpecial = (Layout::specialBeforeVertices ||
+                             Layout::specialAfterVertices) &&
+                            (neighbourBitmask & specialBit);
+    const size_t size = (hasSpecial ? 4 : 0) +
+                        2 * sideCount(neighbourBitmask) + 2 * 8 +
+                        (Layout::lightingInCube ? 2 : 0) + 1;
+    if (!canRead(reader, size)) return false;
+
+    if (Layout::specialBeforeVertices)
+    {
+      // The special data and the vertices come before the neighbours.
+      readSpecial(reader, neighbourBitmask, &cube);
+      if (!readVertices(reader, vertexCount, &cube)) isValid = false;
+    }
 
     // Read neighbour information.
     for (uint8_t j = 0; j < 6; ++j)
     {
       if (neighbourBitmask & (1 << j))
       {
-        cube.neighbors[j] = reader.ReadInt16();
+        cube.neighbors[j] = reader->ReadInt16();
       }
       else
       {
@@ -153,41 +392,29 @@ std::vector<Cube> RdlReader::Cubes() const
       }
     }
 
-    // Read the indices of the eight vertices that make up this cube.
-    for (uint8_t j = 0; j < 8; ++j)
+    if (!Layout::specialBeforeVertices)
     {
-      cube.vertices[j] = reader.ReadUInt16();
-      assert(cube.vertices[j] < vertexCount);
+      if (!readVertices(reader, vertexCount, &cube)) isValid = false;
     }
 
-    // Optionally there are four-bytes that define the energy centre.
-    // This probably needs to be given a better name.
-    if (isEnergyCenter)
+    if (Layout::specialAfterVertices)
     {
-      struct EnergyCenter
-      {
-        uint8_t special;
-        int8_t energyCenterNumber;
-        int16_t value;
-      };
-
-      // TODO: Store this information in the Cube.
-      EnergyCenter energyCentre;
-      energyCentre.special = reader.ReadByte();
-      energyCentre.energyCenterNumber = reader.ReadByte();
-      energyCentre.value = reader.ReadInt16();
+      readSpecial(reader, neighbourBitmask, &cube);
     }
 
-    const int16_t rawLighting = reader.ReadInt16();
-    cube.lighting = rawLighting / (24 * 327.68);
+    if (Layout::lightingInCube)
+    {
+      cube.lighting = cubeLighting(reader->ReadInt16());
+    }
 
     // Wall bit masks where a 1 means it is a wall or door.
-    const uint8_t wallMask = reader.ReadByte();
+    const uint8_t wallMask = reader->ReadByte();
+    if (!canRead(reader, sideCount(wallMask))) return false;
     for (uint8_t wallIndex = 0; wallIndex < 6; ++wallIndex)
     {
       if (wallMask & (1 << wallIndex))
       {
-        cube.walls[wallIndex] = reader.ReadByte();
+        cube.walls[wallIndex] = reader->ReadByte();
       }
       else
       {
@@ -204,36 +431,122 @@ std::vector<Cube> RdlReader::Cubes() const
       {
         cube.textures[j].primaryTextureNumber = 0;
         cube.textures[j].secondaryTextureNumber = 0;
+        if (lights)
+        {
+          for (int corner = 0; corner < 4; ++corner)
+          {
+            lights[i].corners[j][corner] = 0.0f;
+          }
+        }
         continue;
       }
 
-      cube.textures[j].primaryTextureNumber = reader.ReadUInt16();
+      // The textures are followed by the UVLs (3 numbers), each is 16-bits
+      // (so 2*3 bytes) for each corner.
+      if (!canRead(reader, 2 + 4 * 6)) return false;
+      cube.textures[j].primaryTextureNumber = reader->ReadUInt16();
 
       if ((cube.textures[j].primaryTextureNumber >> 15) & 1)
       {
-        cube.textures[j].secondaryTextureNumber = reader.ReadUInt16();
-        // printf("Side: %d: Texture: %d and %d\n", j + 1,
-        //        cube.textures[j].primaryTextureNumber & ~(1 << 15),
-        //        cube.textures[j].secondaryTextureNumber & 0xFFF);
+        if (!canRead(reader, 2 + 4 * 6)) return false;
+        cube.textures[j].secondaryTextureNumber = reader->ReadUInt16();
       }
       else
       {
-        // printf("Side: %d: Texture: %d\n", j + 1,
-        //        cube.textures[j].primaryTextureNumber);
+        cube.textures[j].secondaryTextureNumber = 0;
+      }
+
+      if (!lights)
+      {
+        reader->Seek(reader->Index() + 4 * 6);
+        continue;
       }
 
-      for (int k = 0; k < 4; k++)
+      for (int corner = 0; corner < 4; ++corner)
       {
-        // UVLs (3 numbers), each is 16-bits (so 2*3 bytes).
-        const int16_t u = reader.ReadInt16();
-        const int16_t v = reader.ReadInt16();
-        const uint16_t l = reader.ReadUInt16();
+        reader->Seek(reader->Index() + 2 * 2); // The texture coordinates.
+        lights[i].corners[j][corner] = cornerLighting(reader->ReadUInt16());
       }
     }
   }
+
+  if (Layout::extraCubeData)
+  {
+    if (!canRead(reader, size_t(cubeCount) * 8)) return false;
+    for (int i = 0; i < cubeCount; ++i)
+    {
+      Cube& cube = cubes[i];
+      cube.special = reader->ReadByte();
+      cube.matcen = reader->ReadByte();
+      cube.value = static_cast<int8_t>(reader->ReadByte());
+      reader->ReadByte(); // Flags for the sounds in the cube.
+
+      // The lighting is stored with four more bits than in the cube, so it is
+      // converted directly rather than narrowed to 16 bits, which would wrap
+      // the brighter lights around to negative ones.
+      const int32_t rawLighting = reader->ReadInt32();
+      cube.lighting = rawLighting / (16 * 24 * 327.68);
+    }
+  }
+  return isValid;
+}
+
+std::vector<Cube> RdlReader::Cubes() const
+{
+  std::vector<Cube> cubes(CubeCount());
+  ReadCubes(cubes.data());
   return cubes;
 }
 
+std::vector<CubeLights> RdlReader::Lights() const
+{
+  std::vector<Cube> cubes(CubeCount());
+  std::vector<CubeLights> lights(cubes.size());
+  ReadCubes(cubes.data(), lights.data());
+  return lights;
+}
+
+bool RdlReader::ReadCubes(Cube* cubes) const
+{
+  return ReadCubes(cubes, nullptr);
+}
+
+bool RdlReader::ReadCubes(Cube* cubes, CubeLights* lights) const
+{
+  ArrayReader reader(myData, mySize);
+  reader.Seek(myHeader->mineDataOffset + 1 /* version */);
+
+  // First step, determine how many vertices and cubes there are.
+  const uint16_t vertexCount = reader.ReadUInt16();
+  const uint16_t cubeCount = reader.ReadUInt16();
+
+  // Skip over the vertex data and go to the cubes.
+  reader.Seek(CubeOffset());
+
+  // The version only decides which of the readers is used.
+  const uint32_t version = myHeader->version;
+  if (version <= 1)
+  {
+    return readCubes<Descent1Layout>(&reader, vertexCount, cubeCount, cubes,
+                                     lights);
+  }
+  else if (version < 5)
+  {
+    return readCubes<Descent2EarlyLayout>(&reader, vertexCount, cubeCount,
+                                          cubes, lights);
+  }
+  else if (version == 5)
+  {
+    return readCubes<Descent2SharewareLayout>(&reader, vertexCount,
+                                              cubeCount, cubes, lights);
+  }
+  else
+  {
+    return readCubes<Descent2Layout>(&reader, vertexCount, cubeCount, cubes,
+                                     lights);
+  }
+}
+
 size_t RdlReader::CubeOffset() const
 {
   const size_t index = myHeader->mineDataOffset + 1 /* version */;
@@ -243,3 +556,252 @@ size_t RdlReader::CubeOffset() const
   // are the vertex and cube counts then lastly we skip over all the vertices.
   return myHeader->mineDataOffset + 1 + 4 + 12 * vertexCount;
 }
+
+bool RdlReader::ReadGameInfo(RdlGameInfo* info) const
+{
+  const size_t start = myHeader->objectsOffset;
+  if (start + gameInfoSize > mySize) return false;
+
+  ArrayReader reader(myData, mySize);
+  reader.Seek(start);
+  if (reader.ReadUInt16() != gameInfoSignature) return false;
+  info->version = reader.ReadUInt16();
+  if (static_cast<size_t>(reader.ReadInt32()) < gameInfoSize) return false;
+
+  // Skip over the name of the mine, the level number and the player.
+  reader.Seek(start + 35);
+  info->objectsOffset = reader.ReadInt32();
+  info->objectCount = reader.ReadInt32();
+  reader.ReadInt32(); // The size of an object in memory, not in the file.
+
+  info->wallsOffset = reader.ReadInt32();
+  info->wallCount = reader.ReadInt32();
+  info->wallSize = reader.ReadInt32();
+
+  // Skip over the doors.
+  reader.Seek(start + 71);
+  info->triggersOffset = reader.ReadInt32();
+  info->triggerCount = reader.ReadInt32();
+  info->triggerSize = reader.ReadInt32();
+  return true;
+}
+
+RdlReader::~RdlReader()
+{
+}
+
+const std::vector<Object>& RdlReader::Objects() const
+{
+  if (!myObjects) myObjects.reset(new std::vector<Object>(DecodeObjects()));
+  return *myObjects;
+}
+
+const std::vector<Wall>& RdlReader::Walls() const
+{
+  if (!myWalls) myWalls.reset(new std::vector<Wall>(DecodeWalls()));
+  return *myWalls;
+}
+
+const std::vector<Trigger>& RdlReader::Triggers() const
+{
+  if (!myTriggers)
+  {
+    myTriggers.reset(new std::vector<Trigger>(DecodeTriggers()));
+  }
+  return *myTriggers;
+}
+
+std::vector<Object> RdlReader::DecodeObjects() const
+{
+  RdlGameInfo info;
+  if (!ReadGameInfo(&info)) return std::vector<Object>();
+  if (info.objectsOffset < 0 || info.objectCount <= 0)
+  {
+    return std::vector<Object>();
+  }
+
+  // The objects are different sizes depending on their type so they can only
+  // be read one after the other.
+  ArrayReader reader(myData, mySize);
+  reader.Seek(info.objectsOffset);
+
+  const size_t count =
+    recordCount(info.objectCount, info.objectsOffset, objectSize, mySize);
+  std::vector<Object> objects;
+  objects.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    if (reader.Index() + objectSize > reader.Size()) break;
+
+    Object object;
+    object.type = reader.ReadByte();
+    object.id = reader.ReadByte();
+    const uint8_t controlType = reader.ReadByte();
+    const uint8_t movementType = reader.ReadByte();
+    const uint8_t renderType = reader.ReadByte();
+    reader.ReadByte(); // Flags
+    object.cube = reader.ReadInt16();
+
+    object.position.x = readFixed(&reader);
+    object.position.y = readFixed(&reader);
+    object.position.z = readFixed(&reader);
+    for (int j = 0; j < 9; ++j) object.orientation[j] = readFixed(&reader);
+    object.size = readFixed(&reader);
+    object.shields = readFixed(&reader);
+    reader.Seek(reader.Index() + 12); // The last position.
+    object.containsType = reader.ReadByte();
+    object.containsId = reader.ReadByte();
+    object.containsCount = reader.ReadByte();
+
+    // Skip over the data for how the object moves, is controlled and drawn.
+    size_t extra = 0;
+    if (movementType == MovementPhysics) extra += 64;
+    else if (movementType == MovementSpinning) extra += 12;
+
+    switch (controlType)
+    {
+    case ControlAi:
+      // The two path segments were removed after version 25.
+      extra += info.version <= 25 ? 24 : 20;
+      break;
+    case ControlExplosion:
+      extra += 10;
+      break;
+    case ControlWeapon:
+      extra += 8;
+      break;
+    case ControlLight:
+      extra += 4;
+      break;
+    case ControlPowerup:
+      if (info.version >= 25) extra += 4;
+      break;
+    }
+
+    switch (renderType)
+    {
+    case RenderPolygon:
+    case RenderMorph:
+      extra += 72;
+      break;
+    case RenderFireball:
+    case RenderHostage:
+    case RenderPowerup:
+    case RenderWeaponClip:
+      extra += 9;
+      break;
+    }
+
+    if (reader.Index() + extra > reader.Size()) break;
+    reader.Seek(reader.Index() + extra);
+    objects.push_back(object);
+  }
+  return objects;
+}
+
+std::vector<Wall> RdlReader::DecodeWalls() const
+{
+  RdlGameInfo info;
+  if (!ReadGameInfo(&info)) return std::vector<Wall>();
+  if (info.wallsOffset < 0 || info.wallCount <= 0) return std::vector<Wall>();
+
+  // Older versions stored the walls differently and aren't supported.
+  if (info.wallSize < static_cast<int32_t>(wallSize))
+  {
+    return std::vector<Wall>();
+  }
+
+  ArrayReader reader(myData, mySize);
+  const size_t count =
+    recordCount(info.wallCount, info.wallsOffset, info.wallSize, mySize);
+  std::vector<Wall> walls;
+  walls.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t offset = info.wallsOffset + i * info.wallSize;
+    if (offset + wallSize > reader.Size()) break;
+    reader.Seek(offset);
+
+    Wall wall;
+    wall.cube = reader.ReadInt32();
+    wall.side = reader.ReadInt32();
+    wall.hitPoints = readFixed(&reader);
+    wall.linkedWall = reader.ReadInt32();
+    wall.type = reader.ReadByte();
+    wall.flags = reader.ReadByte();
+    wall.state = reader.ReadByte();
+    wall.trigger = reader.ReadByte();
+    wall.clip = reader.ReadByte();
+    wall.keys = reader.ReadByte();
+    walls.push_back(wall);
+  }
+  return walls;
+}
+
+std::vector<Trigger> RdlReader::DecodeTriggers() const
+{
+  RdlGameInfo info;
+  if (!ReadGameInfo(&info)) return std::vector<Trigger>();
+  if (info.triggersOffset < 0 || info.triggerCount <= 0)
+  {
+    return std::vector<Trigger>();
+  }
+
+  const bool isDescent2 = info.version >= descent2TriggerVersion;
+  const size_t size = isDescent2 ? descent2TriggerSize : triggerSize;
+  if (info.triggerSize < static_cast<int32_t>(size))
+  {
+    return std::vector<Trigger>();
+  }
+
+  ArrayReader reader(myData, mySize);
+  const size_t count = recordCount(info.triggerCount, info.triggersOffset,
+                                   info.triggerSize, mySize);
+  std::vector<Trigger> triggers;
+  triggers.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const size_t offset = info.triggersOffset + i * info.triggerSize;
+    if (offset + size > reader.Size()) break;
+    reader.Seek(offset);
+
+    Trigger trigger;
+    trigger.type = reader.ReadByte();
+    if (isDescent2)
+    {
+      trigger.flags = reader.ReadByte();
+      trigger.linkCount = reader.ReadByte();
+      reader.ReadByte(); // Padding
+      trigger.value = readFixed(&reader);
+      trigger.time = readFixed(&reader);
+    }
+    else
+    {
+      trigger.flags = reader.ReadUInt16();
+      trigger.value = readFixed(&reader);
+      trigger.time = readFixed(&reader);
+      reader.ReadByte(); // The link number, which isn't used.
+      trigger.linkCount = static_cast<uint8_t>(reader.ReadInt16());
+    }
+
+    for (int j = 0; j < 10; ++j) trigger.cubes[j] = reader.ReadInt16();
+    for (int j = 0; j < 10; ++j) trigger.sides[j] = reader.ReadInt16();
+    if (trigger.linkCount > 10) trigger.linkCount = 10;
+    triggers.push_back(trigger);
+  }
+  return triggers;
+}
+
+bool IsLevelName(const char* name)
+{
+  const size_t length = strlen(name);
+  if (length < 4) return false;
+
+  char extension[5];
+  for (int i = 0; i < 4; ++i)
+  {
+    extension[i] = static_cast<char>(tolower(name[length - 4 + i]));
+  }
+  extension[4] = '\0';
+  return strcmp(extension, ".rdl") == 0 || strcmp(extension, ".rl2") == 0;
+}
@@ -18,8 +18,13 @@
 //
 //                - TODO: Document the rest of the format.
 //
+//                The header has the version, 1 is Descent 1 and versions 2 to
+//                8 are Descent 2 (with the extension RL2) which moved where
+//                some of the data for each cube is.
+//
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -35,7 +40,12 @@ typedef unsigned __int32 uint32_t;
 #endif
 
 struct Cube;
+struct CubeLights;
+struct Object;
+struct RdlGameInfo;
 struct RdlHeader;
+struct Trigger;
+struct Wall;
 
 struct Vertex
 {
@@ -49,6 +59,10 @@ class RdlReader
   // TODO: Write one that takes a file as well.
 public:
   RdlReader(const std::vector<uint8_t>& Data);
+  RdlReader(const uint8_t* Data, size_t Size);
+  // The data isn't copied so it must outlive the reader.
+
+  ~RdlReader();
 
   bool IsValid() const;
   // Returns true if magic header is correct.
@@ -56,12 +70,58 @@ public:
   std::vector<Vertex> Vertices() const;
   std::vector<Cube> Cubes() const;
 
+  size_t VertexCount() const;
+  size_t CubeCount() const;
+
+  void ReadVertices(Vertex* vertices) const;
+  bool ReadCubes(Cube* cubes) const;
+  // These decode into arrays which have room for VertexCount() vertices and
+  // CubeCount() cubes rather than allocating them.
+  //
+  // ReadCubes returns false if the level ends before the last cube or a cube
+  // has a vertex which isn't one of the vertices of the level. The cubes from
+  // the one where the level ends aren't all written to.
+
+  std::vector<CubeLights> Lights() const;
+  bool ReadCubes(Cube* cubes, CubeLights* lights) const;
+  // Also decodes the light at the corners of each side of the cubes, which
+  // is skipped over otherwise.
+
+  const std::vector<Object>& Objects() const;
+  const std::vector<Wall>& Walls() const;
+  const std::vector<Trigger>& Triggers() const;
+  // These come from the game data which follows the mine data, each is only
+  // decoded the first time it is asked for so reading just the cubes doesn't
+  // pay for it, and is kept for the next time. They are empty if the game
+  // data isn't understood.
+  //
+  // As they are kept by the reader, these may not be called from more than
+  // one thread at once.
+
 private:
   size_t CubeOffset() const;
   // The index of the first cube in the file.
 
-  const std::vector<uint8_t>& myData;
+  bool ReadGameInfo(RdlGameInfo* info) const;
+  // Reads the table at the start of the game data which gives where the
+  // objects, walls and triggers are. Returns false if it isn't valid.
+
+  std::vector<Object> DecodeObjects() const;
+  std::vector<Wall> DecodeWalls() const;
+  std::vector<Trigger> DecodeTriggers() const;
+
+  const uint8_t* const myData;
+  const size_t mySize;
   const RdlHeader* const myHeader;
+
+  // The game data which has been decoded so far.
+  mutable std::unique_ptr<std::vector<Object>> myObjects;
+  mutable std::unique_ptr<std::vector<Wall>> myWalls;
+  mutable std::unique_ptr<std::vector<Trigger>> myTriggers;
 };
 
+bool IsLevelName(const char* name);
+// Returns true if the name of a file ends with the extension of a level for
+// Descent 1 (.rdl) or Descent 2 (.rl2).
+
 #endif
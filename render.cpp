@@ -0,0 +1,343 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Render
+// PURPOSE      : Providing pictures of levels without needing a GPU.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Projects the vertices, splits the quads into triangles, sorts
+//                the triangles into tiles and then draws the tiles in parallel
+//                with a depth buffer for each.
+//
+//===----------------------------------------------------------------------===//
+
+#include "render.hpp"
+
+#include "cube.hpp"
+#include "parallel.hpp"
+#include "quads.hpp"
+#include "rdl.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+#include <string.h>
+
+// The width and height of a tile in pixels.
+static const uint32_t tileSize = 32;
+
+// The space left around the level, in pixels.
+static const float margin = 2.0f;
+
+// How much of the shade of a side doesn't depend on the way it faces.
+static const double ambient = 0.3;
+
+// The range the lighting of a cube is kept within, so unlit cubes can still
+// be seen.
+static const double minimumLighting = 0.15;
+static const double maximumLighting = 1.0;
+
+// The colour of a side that is fully lit and facing the light.
+static const double baseColour[3] = { 214.0, 204.0, 186.0 };
+
+namespace
+{
+  struct Axes
+  {
+    double right[3];
+    double up[3];
+    double forward[3]; // Away from the viewer, so smaller depths are nearer.
+  };
+
+  struct Triangle
+  {
+    float x[3];
+    float y[3];
+    float depth[3];
+    uint32_t colour;
+  };
+
+  Axes axes(RenderView view)
+  {
+    if (view == TopDown)
+    {
+      const Axes topDown = { { 1.0, 0.0, 0.0 },
+                             { 0.0, 0.0, 1.0 },
+                             { 0.0, -1.0, 0.0 } };
+      return topDown;
+    }
+
+    // Looking from above one corner of the level towards the opposite one.
+    const double a = 1.0 / sqrt(2.0);
+    const double b = 1.0 / sqrt(6.0);
+    const double c = 1.0 / sqrt(3.0);
+    const Axes isometric = { { a, 0.0, -a },
+                             { -b, 2.0 * b, -b },
+                             { -c, -c, -c } };
+    return isometric;
+  }
+
+  double dot(const double a[3], const Vertex& b)
+  {
+    return a[0] * b.x + a[1] * b.y + a[2] * b.z;
+  }
+
+  // Returns the colour of the quad packed as red, green, blue and alpha in the
+  // order they are in memory.
+  uint32_t shade(const Vertex& a, const Vertex& b, const Vertex& c,
+                 double lighting, const double light[3])
+  {
+    const double u[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+    const double v[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+    const Vertex normal = { u[1] * v[2] - u[2] * v[1],
+                            u[2] * v[0] - u[0] * v[2],
+                            u[0] * v[1] - u[1] * v[0] };
+    const double length = sqrt(normal.x * normal.x + normal.y * normal.y +
+                               normal.z * normal.z);
+    const double facing = length > 0.0 ? fabs(dot(light, normal)) / length :
+                                          0.0;
+
+    lighting = std::min(std::max(lighting, minimumLighting), maximumLighting);
+    const double intensity = (ambient + (1.0 - ambient) * facing) * lighting;
+
+    uint8_t colour[4];
+    for (int i = 0; i < 3; ++i)
+    {
+      colour[i] = static_cast<uint8_t>(baseColour[i] * intensity + 0.5);
+    }
+    colour[3] = 255;
+
+    uint32_t packed;
+    memcpy(&packed, colour, sizeof(packed));
+    return packed;
+  }
+
+  // Draws the triangles into one tile of the image.
+  void drawTile(const std::vector<Triangle>& triangles,
+                const std::vector<uint32_t>& bin, uint32_t left, uint32_t top,
+                uint32_t right, uint32_t bottom, Image* image)
+  {
+    float depths[tileSize * tileSize];
+    uint32_t colours[tileSize * tileSize];
+    for (uint32_t i = 0; i < tileSize * tileSize; ++i)
+    {
+      depths[i] = HUGE_VALF;
+      colours[i] = 0;
+    }
+
+    for (auto index = bin.begin(); index != bin.end(); ++index)
+    {
+      const Triangle& triangle = triangles[*index];
+      float x[3] = { triangle.x[0], triangle.x[1], triangle.x[2] };
+      float y[3] = { triangle.y[0], triangle.y[1], triangle.y[2] };
+      float z[3] = { triangle.depth[0], triangle.depth[1],
+                     triangle.depth[2] };
+
+      // Make the winding the same for every triangle so inside is positive.
+      float area =
+        (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+      if (area < 0.0f)
+      {
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(z[1], z[2]);
+        area = -area;
+      }
+      if (area < 1e-6f) continue;
+
+      // Only visit the rows and columns of the tile that the triangle covers.
+      const float minX = std::min(x[0], std::min(x[1], x[2]));
+      const float maxX = std::max(x[0], std::max(x[1], x[2]));
+      const float minY = std::min(y[0], std::min(y[1], y[2]));
+      const float maxY = std::max(y[0], std::max(y[1], y[2]));
+      const int startX = std::max(static_cast<int>(left),
+                                  static_cast<int>(floorf(minX)));
+      const int endX = std::min(static_cast<int>(right),
+                                static_cast<int>(ceilf(maxX)) + 1);
+      const int startY = std::max(static_cast<int>(top),
+                                  static_cast<int>(floorf(minY)));
+      const int endY = std::min(static_cast<int>(bottom),
+                                static_cast<int>(ceilf(maxY)) + 1);
+
+      // The edge functions are linear in x, so each is a + b * x for a row.
+      const float inverseArea = 1.0f / area;
+      const float stepX[3] = { -(y[2] - y[1]), -(y[0] - y[2]),
+                               -(y[1] - y[0]) };
+      const uint32_t colour = triangle.colour;
+
+      for (int row = startY; row < endY; ++row)
+      {
+        const float py = row + 0.5f;
+        const float startPx = startX + 0.5f;
+        const float start[3] = {
+          (x[2] - x[1]) * (py - y[1]) - (y[2] - y[1]) * (startPx - x[1]),
+          (x[0] - x[2]) * (py - y[2]) - (y[0] - y[2]) * (startPx - x[2]),
+          (x[1] - x[0]) * (py - y[0]) - (y[1] - y[0]) * (startPx - x[0]),
+        };
+
+        // The part of the row in the tile that the triangle may cover.
+        const size_t first = (row - top) * tileSize + (startX - left);
+        float* const depthRow = depths + first;
+        uint32_t* const colourRow = colours + first;
+        const int count = endX - startX;
+        for (int i = 0; i < count; ++i)
+        {
+          const float w0 = start[0] + stepX[0] * i;
+          const float w1 = start[1] + stepX[1] * i;
+          const float w2 = start[2] + stepX[2] * i;
+          const float depth = (w0 * z[0] + w1 * z[1] + w2 * z[2]) * inverseArea;
+          const bool isDrawn = w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f &&
+                               depth < depthRow[i];
+          depthRow[i] = isDrawn ? depth : depthRow[i];
+          colourRow[i] = isDrawn ? colour : colourRow[i];
+        }
+      }
+    }
+
+    for (uint32_t row = top; row < bottom; ++row)
+    {
+      uint8_t* const pixels =
+        image->pixels.data() + (size_t(row) * image->width + left) * 4;
+      memcpy(pixels, colours + (row - top) * tileSize, (right - left) * 4);
+    }
+  }
+}
+
+Image Render(const std::vector<Vertex>& vertices,
+             const std::vector<Cube>& cubes, const std::vector<Quad>& quads,
+             RenderView view, uint32_t width, uint32_t height)
+{
+  Image image;
+  image.width = width;
+  image.height = height;
+  image.pixels.assign(size_t(width) * height * 4, 0);
+  if (quads.empty() || width == 0 || height == 0) return image;
+
+  // Project the vertices onto the view and work out the area they cover.
+  const Axes view3d = axes(view);
+  std::vector<float> screenX(vertices.size());
+  std::vector<float> screenY(vertices.size());
+  std::vector<float> depth(vertices.size());
+  double minimum[2] = { HUGE_VAL, HUGE_VAL };
+  double maximum[2] = { -HUGE_VAL, -HUGE_VAL };
+  for (auto quad = quads.begin(); quad != quads.end(); ++quad)
+  {
+    const size_t corners[4] = { quad->a, quad->b, quad->c, quad->d };
+    for (int i = 0; i < 4; ++i)
+    {
+      if (corners[i] >= vertices.size()) continue;
+      const Vertex& vertex = vertices[corners[i]];
+      const double x = dot(view3d.right, vertex);
+      const double y = dot(view3d.up, vertex);
+      minimum[0] = std::min(minimum[0], x);
+      minimum[1] = std::min(minimum[1], y);
+      maximum[0] = std::max(maximum[0], x);
+      maximum[1] = std::max(maximum[1], y);
+    }
+  }
+  if (minimum[0] > maximum[0]) return image;
+
+  // Scale the level to fit and centre it, up on the screen is up the image.
+  const double spanX = std::max(maximum[0] - minimum[0], 1e-6);
+  const double spanY = std::max(maximum[1] - minimum[1], 1e-6);
+  const double scale = std::min((width - 2 * margin) / spanX,
+                                (height - 2 * margin) / spanY);
+  const double offsetX = (width - spanX * scale) / 2;
+  const double offsetY = (height - spanY * scale) / 2;
+  for (size_t i = 0; i < vertices.size(); ++i)
+  {
+    const Vertex& vertex = vertices[i];
+    screenX[i] = static_cast<float>(
+      offsetX + (dot(view3d.right, vertex) - minimum[0]) * scale);
+    screenY[i] = static_cast<float>(
+      offsetY + (maximum[1] - dot(view3d.up, vertex)) * scale);
+    depth[i] = static_cast<float>(dot(view3d.forward, vertex));
+  }
+
+  // The light comes from over the shoulder of the viewer.
+  double light[3];
+  for (int i = 0; i < 3; ++i)
+  {
+    light[i] =
+      0.3 * view3d.right[i] + 0.5 * view3d.up[i] - view3d.forward[i];
+  }
+  const double length =
+    sqrt(light[0] * light[0] + light[1] * light[1] + light[2] * light[2]);
+  for (int i = 0; i < 3; ++i) light[i] /= length;
+
+  // Split the quads into triangles, from the first to the third corner like
+  // the sides of the cubes are.
+  std::vector<Triangle> triangles;
+  triangles.reserve(quads.size() * 2);
+  for (auto quad = quads.begin(); quad != quads.end(); ++quad)
+  {
+    const size_t corners[4] = { quad->a, quad->b, quad->c, quad->d };
+    if (*std::max_element(corners, corners + 4) >= vertices.size()) continue;
+
+    const double lighting =
+      quad->cube < cubes.size() ? cubes[quad->cube].lighting : 1.0;
+    const uint32_t colour = shade(vertices[quad->a], vertices[quad->b],
+                                  vertices[quad->c], lighting, light);
+
+    const size_t split[2][3] = { { quad->a, quad->b, quad->c },
+                                 { quad->a, quad->c, quad->d } };
+    for (int i = 0; i < 2; ++i)
+    {
+      Triangle triangle;
+      for (int j = 0; j < 3; ++j)
+      {
+        triangle.x[j] = screenX[split[i][j]];
+        triangle.y[j] = screenY[split[i][j]];
+        triangle.depth[j] = depth[split[i][j]];
+      }
+      triangle.colour = colour;
+      triangles.push_back(triangle);
+    }
+  }
+
+  // Put each triangle in the bins of the tiles its bounds overlap.
+  const uint32_t tilesX = (width + tileSize - 1) / tileSize;
+  const uint32_t tilesY = (height + tileSize - 1) / tileSize;
+  std::vector<std::vector<uint32_t>> bins(tilesX * tilesY);
+  for (uint32_t i = 0; i < triangles.size(); ++i)
+  {
+    const Triangle& triangle = triangles[i];
+    const float minX = std::min(triangle.x[0],
+                                std::min(triangle.x[1], triangle.x[2]));
+    const float maxX = std::max(triangle.x[0],
+                                std::max(triangle.x[1], triangle.x[2]));
+    const float minY = std::min(triangle.y[0],
+                                std::min(triangle.y[1], triangle.y[2]));
+    const float maxY = std::max(triangle.y[0],
+                                std::max(triangle.y[1], triangle.y[2]));
+    if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height)
+    {
+      continue;
+    }
+
+    const uint32_t firstX = static_cast<uint32_t>(std::max(minX, 0.0f));
+    const uint32_t firstY = static_cast<uint32_t>(std::max(minY, 0.0f));
+    const uint32_t lastX = std::min(static_cast<uint32_t>(maxX), width - 1);
+    const uint32_t lastY = std::min(static_cast<uint32_t>(maxY), height - 1);
+    for (uint32_t tileY = firstY / tileSize; tileY <= lastY / tileSize;
+         ++tileY)
+    {
+      for (uint32_t tileX = firstX / tileSize; tileX <= lastX / tileSize;
+           ++tileX)
+      {
+        bins[tileY * tilesX + tileX].push_back(i);
+      }
+    }
+  }
+
+  ParallelFor(bins.size(), [&](size_t tile, size_t)
+  {
+    const uint32_t left = static_cast<uint32_t>(tile % tilesX) * tileSize;
+    const uint32_t top = static_cast<uint32_t>(tile / tilesX) * tileSize;
+    drawTile(triangles, bins[tile], left, top,
+             std::min(left + tileSize, width),
+             std::min(top + tileSize, height), &image);
+  });
+  return image;
+}
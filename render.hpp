@@ -0,0 +1,46 @@
+#ifndef RENDER_HPP_GUARD
+#define RENDER_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Render
+// PURPOSE      : Providing pictures of levels without needing a GPU.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Draws the quads of a level from outside of it with an
+//                orthographic projection, each shaded by the lighting of its
+//                cube and by how much it faces the light.
+//
+//                The image is split into tiles and each triangle is put in
+//                the list of every tile its bounds touch, then the tiles are
+//                drawn in parallel. Each tile is drawn a row of pixels at a
+//                time, where the edge functions are stepped along the row and
+//                each pixel is tested against them and the depth buffer and
+//                then written in the same loop.
+//
+//===----------------------------------------------------------------------===//
+
+#include "image.hpp"
+
+#include <vector>
+
+#include <stdint.h>
+
+struct Cube;
+struct Quad;
+struct Vertex;
+
+enum RenderView
+{
+  TopDown, // Looking straight down.
+  Isometric // Looking down at the corner of the level.
+};
+
+Image Render(const std::vector<Vertex>& vertices,
+             const std::vector<Cube>& cubes, const std::vector<Quad>& quads,
+             RenderView view, uint32_t width, uint32_t height);
+// Returns a picture of the level which fits the level in the image. The
+// pixels that nothing is drawn on are transparent.
+
+#endif
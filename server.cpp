@@ -0,0 +1,539 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Server
+// PURPOSE      : Providing a resident process which answers queries about a
+//                set of archives over a Unix domain socket.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The archives and the caches are shared by the connections,
+//                the archives don't change once the server has started and
+//                the caches are safe to use from multiple threads.
+//
+//                The connections which have been accepted are put in a queue
+//                which the worker threads take them from.
+//
+//===----------------------------------------------------------------------===//
+
+#include "server.hpp"
+
+#include "hogreader.hpp"
+#include "lightbake.hpp"
+#include "ply.hpp"
+#include "txbiterator.hpp"
+#include "txbreader.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+
+// A request only holds the names of an archive and an entry so anything
+// larger than this is a mistake.
+static const uint32_t maximumRequestSize = 4096;
+
+// The number of connections which are handled at once, which is the number
+// of worker threads.
+static const size_t maximumConnections = 32;
+
+#ifdef MSG_NOSIGNAL
+// A client going away is found out from the send failing rather than from
+// the signal which would stop the server.
+static const int sendFlags = MSG_NOSIGNAL;
+#else
+static const int sendFlags = 0;
+#endif
+
+struct HogServer::Archive
+{
+  Archive(const char* filename) : name(filename), reader(filename) {}
+
+  std::string name;
+  HogReader reader;
+  std::vector<HogEntry> entries; // In the order they are in the archive.
+  std::map<std::string, size_t> index; // The lower case name to the entry.
+};
+
+namespace
+{
+  // The names in an archive are looked up ignoring case like the game does.
+  std::string lowerCase(std::string name)
+  {
+    for (auto c = name.begin(); c != name.end(); ++c)
+    {
+      *c = static_cast<char>(tolower(*c));
+    }
+    return name;
+  }
+
+#ifndef _WIN32
+  bool sendAll(int socket, const void* data, size_t size)
+  {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0)
+    {
+      const ssize_t sent = send(socket, bytes, size, sendFlags);
+      if (sent < 0 && errno == EINTR) continue;
+      if (sent <= 0) return false;
+      bytes += sent;
+      size -= static_cast<size_t>(sent);
+    }
+    return true;
+  }
+
+  bool receiveAll(int socket, void* data, size_t size)
+  {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0)
+    {
+      const ssize_t received = recv(socket, bytes, size, 0);
+      if (received < 0 && errno == EINTR) continue;
+      if (received <= 0) return false;
+      bytes += received;
+      size -= static_cast<size_t>(received);
+    }
+    return true;
+  }
+
+  // Writes a frame whose body is the given byte followed by the rest.
+  bool writeFrame(int socket, uint8_t first, const std::string& rest)
+  {
+    const uint32_t size = static_cast<uint32_t>(rest.size() + 1);
+    const uint8_t header[5] = {
+      static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+      static_cast<uint8_t>(size >> 16), static_cast<uint8_t>(size >> 24),
+      first };
+    return sendAll(socket, header, sizeof(header)) &&
+           sendAll(socket, rest.data(), rest.size());
+  }
+
+  bool readFrame(int socket, std::string* body, uint32_t maximumSize)
+  {
+    uint8_t header[4];
+    if (!receiveAll(socket, header, sizeof(header))) return false;
+
+    const uint32_t size = header[0] | (header[1] << 8) | (header[2] << 16) |
+                          (static_cast<uint32_t>(header[3]) << 24);
+    if (size > maximumSize) return false;
+
+    body->resize(size);
+    return size == 0 || receiveAll(socket, &(*body)[0], size);
+  }
+
+  void serveConnection(HogServer* server, int connection)
+  {
+#ifdef SO_NOSIGPIPE
+    const int noSignal = 1;
+    setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &noSignal,
+               sizeof(noSignal));
+#endif
+
+    std::string request;
+    std::string result;
+    while (readFrame(connection, &request, maximumRequestSize))
+    {
+      const bool handled = server->Handle(request, &result);
+      const uint8_t status = handled ? ServerOk : ServerError;
+      if (!writeFrame(connection, status, result)) break;
+    }
+  }
+
+  bool socketAddress(const char* socketPath, sockaddr_un* address)
+  {
+    const size_t length = strlen(socketPath);
+    if (length >= sizeof(address->sun_path)) return false;
+
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    memcpy(address->sun_path, socketPath, length + 1);
+    return true;
+  }
+#endif
+}
+
+HogServer::HogServer(LevelCache& levels, size_t exportCacheSize)
+: myLevels(levels), myExports(exportCacheSize), myListener(-1),
+  myIsStopping(false)
+{
+}
+
+HogServer::~HogServer()
+{
+  Stop();
+}
+
+bool HogServer::AddArchive(const char* filename)
+{
+  std::unique_ptr<Archive> archive(new Archive(filename));
+  if (!archive->reader.IsValid()) return false;
+
+  archive->entries = archive->reader.Entries();
+  for (size_t i = 0; i < archive->entries.size(); ++i)
+  {
+    // The first of the entries with the same name is the one that is used.
+    const std::string name = lowerCase(archive->entries[i].name);
+    if (archive->index.find(name) == archive->index.end())
+    {
+      archive->index[name] = i;
+    }
+  }
+
+  myArchives[filename] = std::move(archive);
+  return true;
+}
+
+bool HogServer::Serve(const char* socketPath)
+{
+#ifdef _WIN32
+  return false;
+#else
+  sockaddr_un address;
+  if (!socketAddress(socketPath, &address)) return false;
+
+  // A socket left behind by a server which was stopped is replaced, anything
+  // else at the path is left alone and binding to it will fail.
+  struct stat status;
+  if (lstat(socketPath, &status) == 0 && S_ISSOCK(status.st_mode))
+  {
+    unlink(socketPath);
+  }
+
+  const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener == -1) return false;
+
+  if (bind(listener, reinterpret_cast<const sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listener, SOMAXCONN) != 0)
+  {
+    close(listener);
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    if (myIsStopping)
+    {
+      close(listener);
+      return true;
+    }
+    myListener = listener;
+    for (size_t i = 0; i < maximumConnections; ++i)
+    {
+      myWorkers.push_back(std::thread(&HogServer::Work, this));
+    }
+  }
+
+  bool isStopped = false;
+  for (;;)
+  {
+    // Only accept a connection when there is a worker free to handle it, the
+    // rest wait in the backlog of the socket.
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myChanged.wait(lock, [this]
+      {
+        return myIsStopping ||
+               myPending.size() + myConnections.size() < maximumConnections;
+      });
+      if (myIsStopping) break;
+    }
+
+    const int connection = accept(listener, nullptr, nullptr);
+    if (connection == -1)
+    {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      break;
+    }
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    if (myIsStopping)
+    {
+      close(connection);
+      break;
+    }
+    myPending.push_back(connection);
+    myChanged.notify_all();
+  }
+
+  // Stop the workers, shutting down the connections they are handling so
+  // that they aren't left waiting for the next request.
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    isStopped = myIsStopping;
+    myIsStopping = true;
+    myListener = -1;
+    for (auto connection = myConnections.begin();
+         connection != myConnections.end(); ++connection)
+    {
+      shutdown(*connection, SHUT_RDWR);
+    }
+    myChanged.notify_all();
+  }
+
+  for (auto worker = myWorkers.begin(); worker != myWorkers.end(); ++worker)
+  {
+    worker->join();
+  }
+  myWorkers.clear();
+
+  for (auto connection = myPending.begin(); connection != myPending.end();
+       ++connection)
+  {
+    close(*connection);
+  }
+  myPending.clear();
+
+  close(listener);
+  return isStopped;
+#endif
+}
+
+void HogServer::Stop()
+{
+#ifndef _WIN32
+  std::lock_guard<std::mutex> lock(myMutex);
+  myIsStopping = true;
+
+  // Shutting down the socket wakes up Serve() if it is waiting to accept a
+  // connection.
+  if (myListener != -1) shutdown(myListener, SHUT_RDWR);
+  myChanged.notify_all();
+#endif
+}
+
+void HogServer::Work()
+{
+#ifndef _WIN32
+  for (;;)
+  {
+    int connection;
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myChanged.wait(lock, [this]
+      {
+        return myIsStopping || !myPending.empty();
+      });
+      if (myIsStopping) return;
+
+      connection = myPending.front();
+      myPending.pop_front();
+      myConnections.insert(connection);
+    }
+
+    serveConnection(this, connection);
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    myConnections.erase(connection);
+    close(connection);
+    myChanged.notify_all();
+  }
+#endif
+}
+
+bool HogServer::Handle(const std::string& request, std::string* response)
+{
+  response->clear();
+
+  const size_t separator = request.find('\0', 1);
+  if (request.empty() || separator == std::string::npos)
+  {
+    *response = "the request is incomplete";
+    return false;
+  }
+
+  const char command = request[0];
+  if (command == ServerStatistics)
+  {
+    const struct
+    {
+      const char* name;
+      CacheStatistics statistics;
+    } caches[] = { { "levels", myLevels.Statistics() },
+                   { "exports", myExports.Statistics() } };
+
+    std::ostringstream output;
+    for (auto cache = std::begin(caches); cache != std::end(caches); ++cache)
+    {
+      output << cache->name << " hits " << cache->statistics.hits
+             << " misses " << cache->statistics.misses << " evictions "
+             << cache->statistics.evictions << " count "
+             << cache->statistics.count << " bytes "
+             << cache->statistics.bytes << " capacity "
+             << cache->statistics.capacity << '\n';
+    }
+    *response = output.str();
+    return true;
+  }
+
+  const std::string archiveName = request.substr(1, separator - 1);
+  const std::string entryName = request.substr(separator + 1);
+
+  const auto found = myArchives.find(archiveName);
+  if (found == myArchives.end())
+  {
+    *response = "unknown archive " + archiveName;
+    return false;
+  }
+  const Archive& archive = *found->second;
+
+  if (command == ServerList)
+  {
+    std::ostringstream output;
+    for (auto entry = archive.entries.begin(); entry != archive.entries.end();
+         ++entry)
+    {
+      output << entry->name << ' ' << entry->size << '\n';
+    }
+    *response = output.str();
+    return true;
+  }
+
+  const auto index = archive.index.find(lowerCase(entryName));
+  if (index == archive.index.end())
+  {
+    *response = "unknown entry " + entryName;
+    return false;
+  }
+  const HogEntry& entry = archive.entries[index->second];
+
+  if (command == ServerExportLevel)
+  {
+    const auto ply = ExportLevel(archive, entry, response);
+    if (!ply) return false;
+
+    *response = *ply;
+    return true;
+  }
+
+  std::vector<uint8_t> data;
+  if (!ReadEntry(archive.reader.Archive(), entry, &data))
+  {
+    *response = "unable to read " + entryName;
+    return false;
+  }
+
+  if (command == ServerFetch)
+  {
+    response->assign(data.begin(), data.end());
+    return true;
+  }
+  else if (command == ServerDecodeText)
+  {
+    const TxbReader reader(data);
+    std::copy(reader.begin(), reader.end(), std::back_inserter(*response));
+    return true;
+  }
+
+  *response = "unknown command";
+  return false;
+}
+
+std::shared_ptr<const std::string> HogServer::ExportLevel(
+  const Archive& archive, const HogEntry& entry, std::string* error)
+{
+  const std::string name = lowerCase(entry.name);
+  const auto exported = myExports.Find(archive.name, name);
+  if (exported) return exported;
+
+  if (!IsLevelName(entry.name))
+  {
+    *error = std::string(entry.name) + " is not a level";
+    return nullptr;
+  }
+
+  bool isRead = true;
+  const auto level = CachedLevel(myLevels, archive.name, name,
+                                 [&archive, &entry, &isRead](
+                                   std::vector<uint8_t>* data)
+  {
+    isRead = ReadEntry(archive.reader.Archive(), entry, data);
+    return isRead;
+  });
+  if (!level)
+  {
+    *error = isRead ? std::string(entry.name) + " is not a valid level" :
+                      std::string("unable to read ") + entry.name;
+    return nullptr;
+  }
+
+  // The light is baked the same way as when the level is exported by the hog
+  // tool, so both give the same PLY.
+  const BakedLight light =
+    BakeLight(level->cubes, level->vertices, level->lights);
+  std::ostringstream output;
+  ExportToPly(level->vertices, level->quads, light, entry.name, output);
+  std::shared_ptr<std::string> ply(new std::string(output.str()));
+  return myExports.Insert(archive.name, name, ply, ply->capacity());
+}
+
+HogClient::HogClient(const char* socketPath) : mySocket(-1)
+{
+#ifndef _WIN32
+  sockaddr_un address;
+  if (!socketAddress(socketPath, &address)) return;
+
+  mySocket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (mySocket == -1) return;
+
+  if (connect(mySocket, reinterpret_cast<const sockaddr*>(&address),
+              sizeof(address)) != 0)
+  {
+    close(mySocket);
+    mySocket = -1;
+  }
+#endif
+}
+
+HogClient::~HogClient()
+{
+#ifndef _WIN32
+  if (mySocket != -1) close(mySocket);
+#endif
+}
+
+bool HogClient::IsValid() const
+{
+  return mySocket != -1;
+}
+
+bool HogClient::Request(ServerCommand command, const std::string& archive,
+                        const std::string& entry, std::string* response)
+{
+#ifdef _WIN32
+  *response = "Unix domain sockets are not supported";
+  return false;
+#else
+  if (!IsValid())
+  {
+    *response = "not connected to the server";
+    return false;
+  }
+
+  std::string body = archive;
+  body.push_back('\0');
+  body += entry;
+  if (!writeFrame(mySocket, static_cast<uint8_t>(command), body) ||
+      !readFrame(mySocket, response, UINT32_MAX) || response->empty())
+  {
+    close(mySocket);
+    mySocket = -1;
+    *response = "the connection to the server was lost";
+    return false;
+  }
+
+  const bool succeeded = (*response)[0] == ServerOk;
+  response->erase(0, 1);
+  return succeeded;
+#endif
+}
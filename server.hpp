@@ -0,0 +1,150 @@
+#ifndef SERVER_HPP_GUARD
+#define SERVER_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Server
+// PURPOSE      : Providing a resident process which answers queries about a
+//                set of archives over a Unix domain socket.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The archives are opened and their directories are read once
+//                when the server starts, and the most recently used levels are
+//                kept decoded (in a LevelCache which may be shared with the
+//                rest of the program) along with what they were exported as,
+//                so a request only pays for the work that is particular to it.
+//
+//                Each request and response is a frame, which is the size of
+//                the body as a 4 byte little endian number followed by the
+//                body.
+//
+//                 | size - 4 bytes
+//                 | body - size bytes
+//
+//                The body of a request is the command (a ServerCommand) as 1
+//                byte followed by the name of the archive, a \0 and then the
+//                name of the entry (which is empty for the list and
+//                statistics commands).
+//
+//                The body of a response is the status (a ServerStatus) as 1
+//                byte followed by the result or, if the status is an error, a
+//                message which describes the problem.
+//
+//===----------------------------------------------------------------------===//
+
+#include "entrycache.hpp"
+#include "levelcache.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct HogEntry;
+
+enum ServerCommand
+{
+  ServerList = 'l', // The name and size of each entry, a line per entry.
+  ServerFetch = 'f', // The data of the entry as-is.
+  ServerExportLevel = 'p', // The level as a PLY file.
+  ServerDecodeText = 't', // The text of a TXB file.
+  ServerStatistics = 's' // The hits and misses of the caches.
+};
+
+enum ServerStatus
+{
+  ServerOk = 0,
+  ServerError = 1
+};
+
+class HogServer
+{
+public:
+  HogServer(LevelCache& levels, size_t exportCacheSize);
+  // The server decodes levels into the given cache and keeps up to
+  // exportCacheSize bytes of exported levels.
+
+  ~HogServer();
+
+  bool AddArchive(const char* filename);
+  // Opens the archive and reads its directory. Requests refer to the archive
+  // by the filename that is given here.
+
+  bool Serve(const char* socketPath);
+  // Listens on a Unix domain socket at the given path and answers requests
+  // until Stop() is called. The connections are handled by a fixed number of
+  // worker threads, one connection at a time each, so any more connections
+  // wait to be accepted until one of the others is closed. Returns false if
+  // the socket could not be created or accepting connections failed.
+
+  void Stop();
+  // Makes Serve() close the connections, wait for the worker threads to
+  // finish and return. This may be called from any thread.
+
+  bool Handle(const std::string& request, std::string* response);
+  // Answers the body of one request with the result, or returns false with
+  // a message which describes the problem in response.
+
+private:
+  struct Archive;
+
+  std::shared_ptr<const std::string> ExportLevel(const Archive& archive,
+                                                 const HogEntry& entry,
+                                                 std::string* error);
+  // Returns the level as a PLY file, from the cache if it has been exported
+  // before.
+
+  void Work();
+  // Handles the connections which have been accepted until the server stops.
+
+  std::map<std::string, std::unique_ptr<Archive>> myArchives;
+  LevelCache& myLevels;
+
+  // Writing out a level takes longer than decoding it so what it is written
+  // out as is kept as well.
+  EntryCache<std::string> myExports;
+
+  // The connections which have been accepted but not handled yet and the
+  // ones which are being handled, which are shut down when the server stops.
+  std::mutex myMutex;
+  std::condition_variable myChanged;
+  std::deque<int> myPending;
+  std::set<int> myConnections;
+  std::vector<std::thread> myWorkers;
+  int myListener;
+  bool myIsStopping;
+};
+
+class HogClient
+{
+public:
+  HogClient(const char* socketPath);
+  // Connects to the server listening on the given path.
+
+  ~HogClient();
+
+  bool IsValid() const;
+  // Returns true if the client is connected.
+
+  bool Request(ServerCommand command, const std::string& archive,
+               const std::string& entry, std::string* response);
+  // Sends the request and waits for the response. Returns false if the
+  // request failed, in which case response describes the problem.
+
+private:
+  HogClient(const HogClient&) = delete;
+  HogClient& operator=(const HogClient&) = delete;
+
+  int mySocket;
+};
+
+#endif
@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LineOfSight
+// PURPOSE      : Providing whether one point in a level can be seen from
+//                another.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Follows segments through the cubes of a level by finding the
+//                side of each cube that the segment leaves through.
+//
+//===----------------------------------------------------------------------===//
+
+#include "sight.hpp"
+
+#include "cube.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+#include <math.h>
+
+// The number of queries that are given to a thread at a time.
+static const size_t batchSize = 256;
+
+// How close to zero the determinant has to be for a segment to be considered
+// parallel to a triangle.
+static const double epsilon = 1e-9;
+
+LineOfSight::LineOfSight(const std::vector<Cube>& cubes,
+                         const std::vector<Vertex>& vertices)
+: myPlanes(cubes.size()), myIsValid(cubes.size()),
+  myNext(cubes.size() * 6)
+{
+  ParallelFor(cubes.size(), [&](size_t i, size_t)
+  {
+    const Cube& cube = cubes[i];
+
+    bool isValid = true;
+    for (int j = 0; j < 8; ++j)
+    {
+      if (cube.vertices[j] >= vertices.size()) isValid = false;
+    }
+
+    // Nothing can be seen from or through a cube which can't be built.
+    myIsValid[i] = isValid ? 1 : 0;
+    if (isValid) myPlanes[i] = Planes(cube, vertices);
+
+    for (int side = 0; side < 6; ++side)
+    {
+      const int16_t neighbour = cube.neighbors[side];
+      const bool isOpen = isValid && neighbour >= 0 &&
+                          static_cast<size_t>(neighbour) < cubes.size() &&
+                          cube.walls[side] == 255;
+      myNext[i * 6 + side] = isOpen ? neighbour : -1;
+    }
+  });
+}
+
+bool LineOfSight::IsVisible(const SightQuery& query) const
+{
+  if (query.cube >= myPlanes.size()) return false;
+
+  const float from[3] = { static_cast<float>(query.from.x),
+                          static_cast<float>(query.from.y),
+                          static_cast<float>(query.from.z) };
+  const float to[3] = { static_cast<float>(query.to.x),
+                        static_cast<float>(query.to.y),
+                        static_cast<float>(query.to.z) };
+
+  // The segment moves from one cube to the next each step so it can't take
+  // more steps than there are cubes, unless it gets stuck going back and
+  // forth along a side in which case it is treated as blocked.
+  uint32_t cube = query.cube;
+  for (size_t step = 0; step <= myPlanes.size(); ++step)
+  {
+    if (!myIsValid[cube]) return false;
+    const CubePlanes& planes = myPlanes[cube];
+
+    // Work out how far along the segment (from 0 to 1) it leaves the inside
+    // of each plane.
+    static const float offset[12] = {};
+    float leave[12];
+    LeavePlanes(planes, from, to, offset, -HUGE_VALF, leave);
+
+    // A segment leaves a side that bends outwards when it leaves either of
+    // its triangles, otherwise when it leaves both of them.
+    float exit = HUGE_VALF;
+    int exitSide = -1;
+    for (int side = 0; side < 6; ++side)
+    {
+      const float first = leave[side * 2];
+      const float second = leave[side * 2 + 1];
+      const float leaves = ((planes.convexSides >> side) & 1) ?
+                               std::min(first, second) :
+                               std::max(first, second);
+      if (leaves < exit)
+      {
+        exit = leaves;
+        exitSide = side;
+      }
+    }
+
+    if (exit >= 1.0f) return true;
+
+    const int32_t next = myNext[cube * 6 + exitSide];
+    if (next < 0) return false;
+    cube = static_cast<uint32_t>(next);
+  }
+
+  return false;
+}
+
+void LineOfSight::IsVisible(const SightQuery* queries, size_t count,
+                            uint8_t* visible) const
+{
+  const size_t batches = (count + batchSize - 1) / batchSize;
+  ParallelFor(batches, [=](size_t batch, size_t)
+  {
+    const size_t end = std::min(count, (batch + 1) * batchSize);
+    for (size_t i = batch * batchSize; i < end; ++i)
+    {
+      visible[i] = IsVisible(queries[i]) ? 1 : 0;
+    }
+  });
+}
+
+std::vector<SightTriangle> SolidTriangles(const std::vector<Cube>& cubes,
+                                          const std::vector<Vertex>& vertices)
+{
+  std::vector<SightTriangle> triangles;
+  for (auto cube = cubes.begin(); cube != cubes.end(); ++cube)
+  {
+    for (int side = 0; side < 6; ++side)
+    {
+      if (cube->neighbors[side] >= 0 && cube->walls[side] == 255) continue;
+
+      const Vertex& a = vertices[cube->vertices[sideVertices[side][0]]];
+      const Vertex& b = vertices[cube->vertices[sideVertices[side][1]]];
+      const Vertex& c = vertices[cube->vertices[sideVertices[side][2]]];
+      const Vertex& d = vertices[cube->vertices[sideVertices[side][3]]];
+      const SightTriangle first = { a, b, c };
+      const SightTriangle second = { a, c, d };
+      triangles.push_back(first);
+      triangles.push_back(second);
+    }
+  }
+  return triangles;
+}
+
+bool IsVisibleByTestingAll(const std::vector<SightTriangle>& triangles,
+                           const Vertex& from, const Vertex& to)
+{
+  const double direction[3] = { to.x - from.x, to.y - from.y, to.z - from.z };
+
+  // This is the Moller-Trumbore test, limited to the length of the segment.
+  for (auto triangle = triangles.begin(); triangle != triangles.end();
+       ++triangle)
+  {
+    const Vertex& a = triangle->a;
+    const double edge1[3] = { triangle->b.x - a.x, triangle->b.y - a.y,
+                              triangle->b.z - a.z };
+    const double edge2[3] = { triangle->c.x - a.x, triangle->c.y - a.y,
+                              triangle->c.z - a.z };
+    const double p[3] = { direction[1] * edge2[2] - direction[2] * edge2[1],
+                          direction[2] * edge2[0] - direction[0] * edge2[2],
+                          direction[0] * edge2[1] - direction[1] * edge2[0] };
+    const double determinant =
+      edge1[0] * p[0] + edge1[1] * p[1] + edge1[2] * p[2];
+    if (fabs(determinant) < epsilon) continue;
+
+    const double inverse = 1.0 / determinant;
+    const double s[3] = { from.x - a.x, from.y - a.y, from.z - a.z };
+    const double u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverse;
+    if (u < 0.0 || u > 1.0) continue;
+
+    const double q[3] = { s[1] * edge1[2] - s[2] * edge1[1],
+                          s[2] * edge1[0] - s[0] * edge1[2],
+                          s[0] * edge1[1] - s[1] * edge1[0] };
+    const double v =
+      (direction[0] * q[0] + direction[1] * q[1] + direction[2] * q[2]) *
+      inverse;
+    if (v < 0.0 || u + v > 1.0) continue;
+
+    const double t = (edge2[0] * q[0] + edge2[1] * q[1] + edge2[2] * q[2]) *
+                     inverse;
+    if (t >= 0.0 && t <= 1.0) return false;
+  }
+  return true;
+}
@@ -0,0 +1,78 @@
+#ifndef SIGHT_HPP_GUARD
+#define SIGHT_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : LineOfSight
+// PURPOSE      : Providing whether one point in a level can be seen from
+//                another.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The segment between the two points is followed from the cube
+//                it starts in to the cube on the other side of whichever side
+//                it leaves through, until it either reaches its end or leaves
+//                through a side with no cube on the other side or a wall.
+//
+//                Only the cubes along the segment are looked at rather than
+//                every side in the level, and the sides of each cube are
+//                tested against the segment all at once using the planes from
+//                geometry.hpp.
+//
+//===----------------------------------------------------------------------===//
+
+#include "geometry.hpp"
+#include "rdl.hpp"
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+
+struct SightQuery
+{
+  Vertex from;
+  Vertex to;
+  uint32_t cube; // The cube that contains the from point.
+};
+
+class LineOfSight
+{
+public:
+  LineOfSight(const std::vector<Cube>& cubes,
+              const std::vector<Vertex>& vertices);
+
+  bool IsVisible(const SightQuery& query) const;
+  // Returns true if nothing blocks the segment between the two points.
+
+  void IsVisible(const SightQuery* queries, size_t count,
+                 uint8_t* visible) const;
+  // Sets visible[i] to 1 if the segment of queries[i] isn't blocked and 0 if
+  // it is. The queries are split between threads.
+
+private:
+  std::vector<CubePlanes> myPlanes;
+  std::vector<uint8_t> myIsValid; // Set if the cube could be built.
+
+  // The cube through each side of each cube, or -1 if the side is solid.
+  std::vector<int32_t> myNext;
+};
+
+struct SightTriangle
+{
+  Vertex a;
+  Vertex b;
+  Vertex c;
+};
+
+std::vector<SightTriangle> SolidTriangles(const std::vector<Cube>& cubes,
+                                          const std::vector<Vertex>& vertices);
+// Returns the triangles of the sides which block the line of sight.
+
+bool IsVisibleByTestingAll(const std::vector<SightTriangle>& triangles,
+                           const Vertex& from, const Vertex& to);
+// Returns true if the segment doesn't pass through any of the triangles.
+
+#endif
@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : TarWriter
+// PURPOSE      : Providing a writer for (uncompressed) tar archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Writes files into a POSIX ustar archive as a single stream.
+//
+//===----------------------------------------------------------------------===//
+
+#include "tarwriter.hpp"
+
+#include <string.h>
+#include <time.h>
+
+// The size of a header and the unit that the data is padded to.
+static const size_t blockSize = 512;
+
+// The amount of data that is collected before it is written out.
+static const size_t bufferSize = 4 << 20;
+
+struct TarHeader
+{
+  char name[100];
+  char mode[8];
+  char uid[8];
+  char gid[8];
+  char size[12];
+  char mtime[12];
+  char checksum[8];
+  char typeflag;
+  char linkname[100];
+  char magic[6];
+  char version[2];
+  char uname[32];
+  char gname[32];
+  char devmajor[8];
+  char devminor[8];
+  char prefix[155];
+  char padding[12];
+};
+
+static_assert(sizeof(TarHeader) == blockSize,
+              "The TarHeader structure is incorrectly packed");
+
+// Writes value as a zero padded octal number which fills the field, the last
+// character is the null terminator.
+static void writeOctal(char* field, size_t size, unsigned long long value)
+{
+  field[size - 1] = '\0';
+  for (size_t i = size - 1; i > 0; --i)
+  {
+    field[i - 1] = static_cast<char>('0' + (value & 7));
+    value >>= 3;
+  }
+}
+
+TarWriter::TarWriter(FILE* output)
+: myOutput(output), myBuffer(bufferSize), myBufferUsed(0), isFinished(false)
+{
+}
+
+TarWriter::~TarWriter()
+{
+  if (!isFinished) Finish();
+}
+
+bool TarWriter::AddFile(const std::string& name, const void* data, size_t size)
+{
+  if (name.size() > sizeof(TarHeader().name)) return false;
+
+  TarHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.name, name.data(), name.size());
+  writeOctal(header.mode, sizeof(header.mode), 0644);
+  writeOctal(header.uid, sizeof(header.uid), 0);
+  writeOctal(header.gid, sizeof(header.gid), 0);
+  writeOctal(header.size, sizeof(header.size), size);
+  writeOctal(header.mtime, sizeof(header.mtime), time(nullptr));
+  header.typeflag = '0'; // A regular file.
+  memcpy(header.magic, "ustar", 6);
+  memcpy(header.version, "00", 2);
+
+  // The checksum is the sum of the bytes of the header when the checksum
+  // field itself is filled with spaces.
+  memset(header.checksum, ' ', sizeof(header.checksum));
+  unsigned int checksum = 0;
+  const unsigned char* bytes = reinterpret_cast<unsigned char*>(&header);
+  for (size_t i = 0; i < sizeof(header); ++i) checksum += bytes[i];
+  writeOctal(header.checksum, 7, checksum);
+
+  if (!Write(&header, sizeof(header))) return false;
+  if (!Write(data, size)) return false;
+
+  static const char zeros[blockSize] = {};
+  const size_t padding = (blockSize - size % blockSize) % blockSize;
+  return Write(zeros, padding);
+}
+
+bool TarWriter::AddFile(const std::string& name, const std::string& data)
+{
+  return AddFile(name, data.data(), data.size());
+}
+
+bool TarWriter::Finish()
+{
+  isFinished = true;
+
+  static const char zeros[blockSize * 2] = {};
+  if (!Write(zeros, sizeof(zeros))) return false;
+  if (!Flush()) return false;
+  return fflush(myOutput) == 0;
+}
+
+bool TarWriter::Write(const void* data, size_t size)
+{
+  const char* source = static_cast<const char*>(data);
+  while (size > 0)
+  {
+    // Large writes skip the buffer when it is empty.
+    if (myBufferUsed == 0 && size >= myBuffer.size())
+    {
+      return fwrite(source, size, 1, myOutput) == 1;
+    }
+
+    const size_t space = myBuffer.size() - myBufferUsed;
+    const size_t count = size < space ? size : space;
+    memcpy(myBuffer.data() + myBufferUsed, source, count);
+    myBufferUsed += count;
+    source += count;
+    size -= count;
+
+    if (myBufferUsed == myBuffer.size() && !Flush()) return false;
+  }
+  return true;
+}
+
+bool TarWriter::Flush()
+{
+  if (myBufferUsed == 0) return true;
+
+  const bool written = fwrite(myBuffer.data(), myBufferUsed, 1, myOutput) == 1;
+  myBufferUsed = 0;
+  return written;
+}
@@ -0,0 +1,63 @@
+#ifndef TAR_WRITER_HPP_GUARD
+#define TAR_WRITER_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : TarWriter
+// PURPOSE      : Providing a writer for (uncompressed) tar archives.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Writes files into a POSIX ustar archive as a single stream.
+//
+//                This allows many exported files to be written as one large
+//                file (or to standard output) rather than creating a file for
+//                each one which is slow on network file systems.
+//
+//                The format is as follows:
+//
+//                 |---------------- Start of the first file
+//                 | header - 512 bytes (name, size in octal, checksum etc)
+//                 | data - padded with zeros to a multiple of 512 bytes.
+//                 |---------------- The next header/file comes straight after.
+//                 | ...
+//                 |---------------- End of the archive
+//                 | zeros - two blocks of 512 bytes.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdio.h>
+
+class TarWriter
+{
+public:
+  TarWriter(FILE* output);
+  // The output should be opened in binary mode. The writer does not close it.
+
+  ~TarWriter();
+  // Finishes the archive if Finish() wasn't called.
+
+  bool AddFile(const std::string& name, const void* data, size_t size);
+  bool AddFile(const std::string& name, const std::string& data);
+  // Adds a file with the given name and data to the archive.
+
+  bool Finish();
+  // Writes the end of the archive marker and flushes the output.
+
+private:
+  bool Write(const void* data, size_t size);
+  // Buffers data so the output is written in large sequential blocks.
+
+  bool Flush();
+
+  FILE* myOutput;
+  std::vector<char> myBuffer;
+  size_t myBufferUsed;
+  bool isFinished;
+};
+
+#endif
@@ -0,0 +1,356 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : TextIndex
+// PURPOSE      : Providing a search of the words in the briefings of missions.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The words are found with a binary search of the sorted table
+//                of words in the mapped file, then their postings are read in
+//                place.
+//
+//===----------------------------------------------------------------------===//
+
+#include "textindex.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <ctype.h>
+#include <string.h>
+
+static const uint32_t version = 1;
+
+// The numbers in the header after the magic number.
+static const size_t headerCount = 6;
+
+struct TextIndex::Word
+{
+  uint32_t text; // The offset of the text in the strings.
+  uint32_t length;
+  uint32_t firstPosting;
+  uint32_t postingCount;
+};
+
+struct TextIndex::Posting
+{
+  uint32_t document;
+  uint32_t offset;
+};
+
+std::vector<std::pair<std::string, uint32_t>> TextWords(
+  const std::string& text)
+{
+  std::vector<std::pair<std::string, uint32_t>> words;
+  size_t start = 0;
+  for (size_t i = 0; i <= text.size(); ++i)
+  {
+    if (i < text.size() && isalnum(static_cast<unsigned char>(text[i])))
+    {
+      continue;
+    }
+
+    if (i > start)
+    {
+      std::string word = text.substr(start, i - start);
+      for (auto c = word.begin(); c != word.end(); ++c)
+      {
+        *c = static_cast<char>(tolower(static_cast<unsigned char>(*c)));
+      }
+      words.push_back(std::make_pair(word, static_cast<uint32_t>(start)));
+    }
+    start = i + 1;
+  }
+  return words;
+}
+
+void TextIndexBuilder::Add(const std::string& archive,
+                           const std::string& entry, const std::string& text)
+{
+  // The entries of an archive are usually added one after the other.
+  if (myArchives.empty() || myArchives.back() != archive)
+  {
+    myArchives.push_back(archive);
+  }
+
+  const uint32_t document = static_cast<uint32_t>(myDocuments.size());
+  myDocuments.push_back(
+    std::make_pair(static_cast<uint32_t>(myArchives.size() - 1), entry));
+
+  const auto words = TextWords(text);
+  for (auto word = words.begin(); word != words.end(); ++word)
+  {
+    const Posting posting = { document, word->second };
+    myWords[word->first].push_back(posting);
+  }
+}
+
+bool TextIndexBuilder::Write(const char* filename) const
+{
+  std::vector<uint32_t> archives;
+  std::vector<uint32_t> documents;
+  std::vector<uint32_t> words;
+  std::vector<uint32_t> postings;
+  std::string strings;
+
+  // The names come last so the file ends with a \0, which means they can be
+  // read without checking where the file ends.
+  for (auto word = myWords.begin(); word != myWords.end(); ++word)
+  {
+    words.push_back(static_cast<uint32_t>(strings.size()));
+    words.push_back(static_cast<uint32_t>(word->first.size()));
+    words.push_back(static_cast<uint32_t>(postings.size() / 2));
+    words.push_back(static_cast<uint32_t>(word->second.size()));
+    strings += word->first;
+
+    for (auto posting = word->second.begin(); posting != word->second.end();
+         ++posting)
+    {
+      postings.push_back(posting->document);
+      postings.push_back(posting->offset);
+    }
+  }
+
+  for (auto archive = myArchives.begin(); archive != myArchives.end();
+       ++archive)
+  {
+    archives.push_back(static_cast<uint32_t>(strings.size()));
+    strings += *archive;
+    strings.push_back('\0');
+  }
+
+  for (auto document = myDocuments.begin(); document != myDocuments.end();
+       ++document)
+  {
+    documents.push_back(document->first);
+    documents.push_back(static_cast<uint32_t>(strings.size()));
+    strings += document->second;
+    strings.push_back('\0');
+  }
+
+  const uint32_t header[headerCount] = {
+    version, static_cast<uint32_t>(myArchives.size()),
+    static_cast<uint32_t>(myDocuments.size()),
+    static_cast<uint32_t>(myWords.size()),
+    static_cast<uint32_t>(postings.size() / 2),
+    static_cast<uint32_t>(strings.size())
+  };
+
+  std::ofstream output(filename, std::ios::binary);
+  output.write("DTXI", 4);
+  output.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+  const std::vector<uint32_t>* const sections[] = {
+    &archives, &documents, &words, &postings
+  };
+  for (auto section = std::begin(sections); section != std::end(sections);
+       ++section)
+  {
+    output.write(reinterpret_cast<const char*>((*section)->data()),
+                 (*section)->size() * sizeof(uint32_t));
+  }
+  output.write(strings.data(), strings.size());
+  return output.good();
+}
+
+TextIndex::TextIndex(const char* filename)
+: myFile(filename), myWordCount(0), myArchives(nullptr),
+  myDocuments(nullptr), myWords(nullptr), myPostings(nullptr),
+  myStrings(nullptr)
+{
+  const size_t headerSize = 4 + headerCount * sizeof(uint32_t);
+  if (!myFile.IsValid() || myFile.Size() < headerSize) return;
+  if (memcmp(myFile.Data(), "DTXI", 4) != 0) return;
+
+  uint32_t header[headerCount];
+  memcpy(header, myFile.Data() + 4, sizeof(header));
+  if (header[0] != version) return;
+
+  // The sizes are added up as 64-bit numbers so they can't overflow.
+  const uint64_t archivesSize = uint64_t(header[1]) * sizeof(uint32_t);
+  const uint64_t documentsSize = uint64_t(header[2]) * 2 * sizeof(uint32_t);
+  const uint64_t wordsSize = uint64_t(header[3]) * sizeof(Word);
+  const uint64_t postingsSize = uint64_t(header[4]) * sizeof(Posting);
+  const uint64_t stringsSize = header[5];
+  if (headerSize + archivesSize + documentsSize + wordsSize + postingsSize +
+      stringsSize != myFile.Size())
+  {
+    return;
+  }
+
+  const uint8_t* data = myFile.Data() + headerSize;
+  const uint8_t* strings =
+    data + archivesSize + documentsSize + wordsSize + postingsSize;
+  if (stringsSize == 0 || strings[stringsSize - 1] != '\0') return;
+
+  // Everything that is read from the file is checked to be within it, so a
+  // damaged index gives wrong results rather than crashing.
+  const auto isWithin = [&](uint32_t offset, uint32_t length)
+  { return uint64_t(offset) + length <= stringsSize; };
+  const uint32_t* archives = reinterpret_cast<const uint32_t*>(data);
+  for (uint32_t i = 0; i < header[1]; ++i)
+  {
+    if (!isWithin(archives[i], 1)) return;
+  }
+  const uint32_t* documents =
+    reinterpret_cast<const uint32_t*>(data + archivesSize);
+  for (uint32_t i = 0; i < header[2]; ++i)
+  {
+    if (documents[i * 2] >= header[1]) return;
+    if (!isWithin(documents[i * 2 + 1], 1)) return;
+  }
+  const Word* words =
+    reinterpret_cast<const Word*>(data + archivesSize + documentsSize);
+  for (uint32_t i = 0; i < header[3]; ++i)
+  {
+    if (!isWithin(words[i].text, words[i].length)) return;
+    if (uint64_t(words[i].firstPosting) + words[i].postingCount > header[4])
+    {
+      return;
+    }
+  }
+  const Posting* postings = reinterpret_cast<const Posting*>(
+    data + archivesSize + documentsSize + wordsSize);
+  for (uint32_t i = 0; i < header[4]; ++i)
+  {
+    if (postings[i].document >= header[2]) return;
+  }
+
+  myWordCount = header[3];
+  myArchives = archives;
+  myDocuments = documents;
+  myWords = words;
+  myPostings = postings;
+  myStrings = reinterpret_cast<const char*>(strings);
+}
+
+bool TextIndex::IsValid() const
+{
+  return myStrings != nullptr;
+}
+
+const TextIndex::Word* TextIndex::FindWord(const std::string& word) const
+{
+  if (!IsValid()) return nullptr;
+
+  const auto isBefore = [this](const Word& a, const std::string& b)
+  {
+    const int order = memcmp(myStrings + a.text, b.data(),
+                             std::min<size_t>(a.length, b.size()));
+    return order < 0 || (order == 0 && a.length < b.size());
+  };
+
+  const Word* found =
+    std::lower_bound(myWords, myWords + myWordCount, word, isBefore);
+  if (found == myWords + myWordCount || found->length != word.size() ||
+      memcmp(myStrings + found->text, word.data(), word.size()) != 0)
+  {
+    return nullptr;
+  }
+  return found;
+}
+
+TextMatch TextIndex::Match(const Posting& posting) const
+{
+  const uint32_t* document = myDocuments + posting.document * 2;
+  TextMatch match;
+  match.archive = myStrings + myArchives[document[0]];
+  match.entry = myStrings + document[1];
+  match.offset = posting.offset;
+  return match;
+}
+
+std::vector<TextMatch> TextIndex::Find(const std::string& word) const
+{
+  std::vector<TextMatch> matches;
+  const auto words = TextWords(word);
+  if (words.size() != 1) return matches;
+
+  const Word* found = FindWord(words.front().first);
+  if (!found) return matches;
+
+  matches.reserve(found->postingCount);
+  const Posting* postings = myPostings + found->firstPosting;
+  for (uint32_t i = 0; i < found->postingCount; ++i)
+  {
+    matches.push_back(Match(postings[i]));
+  }
+  return matches;
+}
+
+std::vector<TextMatch> TextIndex::Search(const std::string& query) const
+{
+  std::vector<TextMatch> matches;
+  const auto words = TextWords(query);
+  if (words.empty()) return matches;
+
+  std::vector<const Word*> found;
+  for (auto word = words.begin(); word != words.end(); ++word)
+  {
+    const Word* indexed = FindWord(word->first);
+    if (!indexed) return matches;
+    found.push_back(indexed);
+  }
+
+  // The postings are sorted by document so the documents which have every
+  // word are found by merging the documents of each word in turn.
+  std::vector<uint32_t> documents;
+  for (auto word = found.begin(); word != found.end(); ++word)
+  {
+    std::vector<uint32_t> wordDocuments;
+    const Posting* postings = myPostings + (*word)->firstPosting;
+    for (uint32_t i = 0; i < (*word)->postingCount; ++i)
+    {
+      if (wordDocuments.empty() ||
+          wordDocuments.back() != postings[i].document)
+      {
+        wordDocuments.push_back(postings[i].document);
+      }
+    }
+
+    if (word == found.begin())
+    {
+      documents.swap(wordDocuments);
+      continue;
+    }
+
+    std::vector<uint32_t> both;
+    std::set_intersection(documents.begin(), documents.end(),
+                          wordDocuments.begin(), wordDocuments.end(),
+                          std::back_inserter(both));
+    documents.swap(both);
+  }
+
+  std::vector<Posting> postings;
+  for (auto word = found.begin(); word != found.end(); ++word)
+  {
+    const Posting* wordPostings = myPostings + (*word)->firstPosting;
+    for (uint32_t i = 0; i < (*word)->postingCount; ++i)
+    {
+      if (std::binary_search(documents.begin(), documents.end(),
+                             wordPostings[i].document))
+      {
+        postings.push_back(wordPostings[i]);
+      }
+    }
+  }
+
+  std::sort(postings.begin(), postings.end(),
+            [](const Posting& a, const Posting& b)
+  {
+    return a.document < b.document ||
+           (a.document == b.document && a.offset < b.offset);
+  });
+  postings.erase(std::unique(postings.begin(), postings.end(),
+                             [](const Posting& a, const Posting& b)
+  { return a.document == b.document && a.offset == b.offset; }),
+                 postings.end());
+
+  matches.reserve(postings.size());
+  for (auto posting = postings.begin(); posting != postings.end(); ++posting)
+  {
+    matches.push_back(Match(*posting));
+  }
+  return matches;
+}
@@ -0,0 +1,115 @@
+#ifndef TEXT_INDEX_HPP_GUARD
+#define TEXT_INDEX_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : TextIndex
+// PURPOSE      : Providing a search of the words in the briefings of missions.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : An inverted index of the decoded text of TXB files, from each
+//                word to every place it occurs in them. A word is a run of
+//                letters and digits and is folded to lower case.
+//
+//                The index is built once and written to a file which is mapped
+//                into memory and searched in place, so no TXB is decoded and
+//                nothing is built up in memory before searching.
+//
+//                The file format is as follows, the numbers are 32-bit and in
+//                the byte order of the machine which wrote it.
+//
+//                 | "DTXI" - 4 bytes
+//                 | version, archive count, document count, word count,
+//                 | posting count, string size - 6 numbers
+//                 |---------------- Archives
+//                 | offset of the name in the strings - 1 number each
+//                 |---------------- Documents (the entries in the archives)
+//                 | archive, offset of the name - 2 numbers each
+//                 |---------------- Words, sorted by their text
+//                 | offset of the text, length, first posting, posting
+//                 | count - 4 numbers each
+//                 |---------------- Postings, sorted by document then offset
+//                 | document, offset in its text - 2 numbers each
+//                 |---------------- Strings
+//                 | the names and the words, the names end with a \0
+//
+//===----------------------------------------------------------------------===//
+
+#include "file.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct TextMatch
+{
+  std::string archive;
+  std::string entry;
+  uint32_t offset; // Where the word starts in the decoded text.
+};
+
+class TextIndexBuilder
+{
+public:
+  void Add(const std::string& archive, const std::string& entry,
+           const std::string& text);
+  // Adds the words of the decoded text of the entry.
+
+  bool Write(const char* filename) const;
+  // Writes the index out in the format described above.
+
+private:
+  struct Posting
+  {
+    uint32_t document;
+    uint32_t offset;
+  };
+
+  std::vector<std::string> myArchives;
+  std::vector<std::pair<uint32_t, std::string>> myDocuments;
+  std::map<std::string, std::vector<Posting>> myWords;
+};
+
+class TextIndex
+{
+public:
+  TextIndex(const char* filename);
+
+  bool IsValid() const;
+  // Returns true if the file was mapped and has the right header.
+
+  std::vector<TextMatch> Find(const std::string& word) const;
+  // Returns every place the word occurs.
+
+  std::vector<TextMatch> Search(const std::string& query) const;
+  // Returns every place the words of the query occur in the entries which
+  // contain all of them.
+
+private:
+  struct Word;
+  struct Posting;
+
+  const Word* FindWord(const std::string& word) const;
+  // Returns the word or nullptr if it isn't in the index.
+
+  TextMatch Match(const Posting& posting) const;
+
+  MappedFile myFile;
+  uint32_t myWordCount;
+  const uint32_t* myArchives;
+  const uint32_t* myDocuments;
+  const Word* myWords;
+  const Posting* myPostings;
+  const char* myStrings;
+};
+
+std::vector<std::pair<std::string, uint32_t>> TextWords(
+  const std::string& text);
+// Returns the words in the text folded to lower case along with where each
+// of them starts.
+
+#endif
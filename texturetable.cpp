@@ -0,0 +1,345 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : TextureTable
+// PURPOSE      : Providing which textures are used where across many levels.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : The queries each go through the one or two columns they need
+//                from the start to the end.
+//
+//===----------------------------------------------------------------------===//
+
+#include "texturetable.hpp"
+
+#include "cube.hpp"
+
+#include <istream>
+#include <ostream>
+
+static const uint32_t version = 1;
+
+// The texture number is in the low bits, the high bit of the primary texture
+// says if there is a secondary texture and the high bits of the secondary
+// texture are how it is turned.
+static const uint16_t primaryMask = 0x7FFF;
+static const uint16_t secondaryMask = 0x3FFF;
+
+namespace
+{
+  template <typename Number>
+  void writeNumber(std::ostream& output, Number number)
+  {
+    output.write(reinterpret_cast<const char*>(&number), sizeof(number));
+  }
+
+  template <typename Number>
+  bool readNumber(std::istream& input, Number* number)
+  {
+    input.read(reinterpret_cast<char*>(number), sizeof(*number));
+    return input.good();
+  }
+
+  void writeString(std::ostream& output, const std::string& text)
+  {
+    writeNumber(output, static_cast<uint32_t>(text.size()));
+    output.write(text.data(), text.size());
+  }
+
+  bool readString(std::istream& input, std::string* text)
+  {
+    // Nothing this long is written, so it means the file is damaged.
+    const uint32_t limit = 4096;
+
+    uint32_t length;
+    if (!readNumber(input, &length) || length > limit) return false;
+    text->resize(length);
+    if (length > 0) input.read(&(*text)[0], length);
+    return input.good();
+  }
+
+  // Returns the number of bytes from the position of the stream to its end,
+  // or false if the stream can't tell.
+  bool bytesLeft(std::istream& input, uint64_t* bytes)
+  {
+    const std::istream::pos_type position = input.tellg();
+    if (position < 0 || !input.seekg(0, std::ios::end)) return false;
+    const std::istream::pos_type end = input.tellg();
+    if (end < position || !input.seekg(position)) return false;
+    *bytes = static_cast<uint64_t>(end - position);
+    return true;
+  }
+
+  template <typename Number>
+  void writeColumn(std::ostream& output, const std::vector<Number>& column)
+  {
+    output.write(reinterpret_cast<const char*>(column.data()),
+                 column.size() * sizeof(Number));
+  }
+
+  template <typename Number>
+  bool readColumn(std::istream& input, size_t rows,
+                  std::vector<Number>* column)
+  {
+    column->resize(rows);
+    input.read(reinterpret_cast<char*>(column->data()),
+               rows * sizeof(Number));
+    return input.good() || (rows == 0 && !input.bad());
+  }
+}
+
+uint32_t TextureTable::AddLevel(const std::string& archive,
+                                const std::string& level)
+{
+  // The levels of an archive are usually added one after the other.
+  if (myArchives.empty() || myArchives.back() != archive)
+  {
+    myArchives.push_back(archive);
+  }
+
+  myLevelArchives.push_back(static_cast<uint32_t>(myArchives.size() - 1));
+  myLevels.push_back(level);
+  return static_cast<uint32_t>(myLevels.size() - 1);
+}
+
+void TextureTable::AddCubes(uint32_t level, const std::vector<Cube>& cubes)
+{
+  for (size_t i = 0; i < cubes.size(); ++i)
+  {
+    const Cube& cube = cubes[i];
+    for (uint8_t side = 0; side < 6; ++side)
+    {
+      if (cube.neighbors[side] != -1 && cube.walls[side] == 255) continue;
+
+      const Texture& texture = cube.textures[side];
+      const bool hasSecondary = (texture.primaryTextureNumber >> 15) & 1;
+      myLevel.push_back(level);
+      myCube.push_back(static_cast<uint32_t>(i));
+      mySide.push_back(side);
+      myPrimary.push_back(texture.primaryTextureNumber & primaryMask);
+      mySecondary.push_back(
+        hasSecondary ? texture.secondaryTextureNumber & secondaryMask : 0);
+    }
+  }
+}
+
+void TextureTable::Append(const TextureTable& other)
+{
+  const uint32_t firstLevel = static_cast<uint32_t>(myLevels.size());
+  for (size_t i = 0; i < other.myLevels.size(); ++i)
+  {
+    AddLevel(other.myArchives[other.myLevelArchives[i]], other.myLevels[i]);
+  }
+
+  for (auto level = other.myLevel.begin(); level != other.myLevel.end();
+       ++level)
+  {
+    myLevel.push_back(firstLevel + *level);
+  }
+  myCube.insert(myCube.end(), other.myCube.begin(), other.myCube.end());
+  mySide.insert(mySide.end(), other.mySide.begin(), other.mySide.end());
+  myPrimary.insert(myPrimary.end(), other.myPrimary.begin(),
+                   other.myPrimary.end());
+  mySecondary.insert(mySecondary.end(), other.mySecondary.begin(),
+                     other.mySecondary.end());
+}
+
+size_t TextureTable::RowCount() const
+{
+  return myLevel.size();
+}
+
+std::vector<TextureUsage> TextureTable::Histogram() const
+{
+  std::vector<uint32_t> primary(textureLimit);
+  std::vector<uint32_t> secondary(textureLimit);
+  std::vector<uint32_t> levels(textureLimit);
+
+  // The rows of a level are together, so a texture is used by another level
+  // when the last level it was seen in is different.
+  const uint32_t none = UINT32_MAX;
+  std::vector<uint32_t> lastLevel(textureLimit, none);
+  for (size_t row = 0; row < myLevel.size(); ++row)
+  {
+    const uint16_t texture = myPrimary[row];
+    ++primary[texture];
+    if (lastLevel[texture] != myLevel[row])
+    {
+      lastLevel[texture] = myLevel[row];
+      ++levels[texture];
+    }
+
+    const uint16_t overlay = mySecondary[row];
+    if (overlay == 0) continue;
+    ++secondary[overlay];
+    if (lastLevel[overlay] != myLevel[row])
+    {
+      lastLevel[overlay] = myLevel[row];
+      ++levels[overlay];
+    }
+  }
+
+  std::vector<TextureUsage> usages;
+  for (size_t texture = 0; texture < textureLimit; ++texture)
+  {
+    if (levels[texture] == 0) continue;
+
+    const TextureUsage usage = {
+      static_cast<uint16_t>(texture), primary[texture], secondary[texture],
+      levels[texture]
+    };
+    usages.push_back(usage);
+  }
+  return usages;
+}
+
+std::vector<TextureLevelUsage> TextureTable::LevelsUsing(
+  uint16_t texture) const
+{
+  std::vector<uint32_t> primary(myLevels.size());
+  std::vector<uint32_t> secondary(myLevels.size());
+  for (size_t row = 0; row < myLevel.size(); ++row)
+  {
+    if (myPrimary[row] == texture) ++primary[myLevel[row]];
+  }
+  if (texture != 0)
+  {
+    for (size_t row = 0; row < myLevel.size(); ++row)
+    {
+      if (mySecondary[row] == texture) ++secondary[myLevel[row]];
+    }
+  }
+
+  std::vector<TextureLevelUsage> usages;
+  for (size_t level = 0; level < myLevels.size(); ++level)
+  {
+    if (primary[level] == 0 && secondary[level] == 0) continue;
+
+    TextureLevelUsage usage;
+    usage.archive = myArchives[myLevelArchives[level]];
+    usage.level = myLevels[level];
+    usage.primaryCount = primary[level];
+    usage.secondaryCount = secondary[level];
+    usages.push_back(usage);
+  }
+  return usages;
+}
+
+std::vector<uint16_t> TextureTable::Unused(uint16_t textureCount) const
+{
+  std::vector<uint8_t> isUsed(textureLimit);
+  for (size_t row = 0; row < myLevel.size(); ++row)
+  {
+    isUsed[myPrimary[row]] = 1;
+    isUsed[mySecondary[row]] = 1;
+  }
+
+  // The secondary column uses 0 for none, so whether texture 0 is used only
+  // depends on the primary column.
+  isUsed[0] = 0;
+  for (size_t row = 0; row < myLevel.size() && !isUsed[0]; ++row)
+  {
+    if (myPrimary[row] == 0) isUsed[0] = 1;
+  }
+
+  std::vector<uint16_t> unused;
+  const size_t count = std::min<size_t>(textureCount, textureLimit);
+  for (size_t texture = 0; texture < count; ++texture)
+  {
+    if (!isUsed[texture]) unused.push_back(static_cast<uint16_t>(texture));
+  }
+  return unused;
+}
+
+bool TextureTable::Write(std::ostream& output) const
+{
+  output.write("DTEX", 4);
+  writeNumber(output, version);
+  writeNumber(output, static_cast<uint32_t>(myArchives.size()));
+  writeNumber(output, static_cast<uint32_t>(myLevels.size()));
+  writeNumber(output, static_cast<uint32_t>(myLevel.size()));
+
+  for (auto archive = myArchives.begin(); archive != myArchives.end();
+       ++archive)
+  {
+    writeString(output, *archive);
+  }
+  for (size_t level = 0; level < myLevels.size(); ++level)
+  {
+    writeNumber(output, myLevelArchives[level]);
+    writeString(output, myLevels[level]);
+  }
+
+  writeColumn(output, myLevel);
+  writeColumn(output, myCube);
+  writeColumn(output, mySide);
+  writeColumn(output, myPrimary);
+  writeColumn(output, mySecondary);
+  return output.good();
+}
+
+bool TextureTable::Read(std::istream& input)
+{
+  char magic[4];
+  input.read(magic, sizeof(magic));
+  if (!input.good() || std::string(magic, 4) != "DTEX") return false;
+
+  uint32_t fileVersion, archiveCount, levelCount, rowCount;
+  if (!readNumber(input, &fileVersion) || fileVersion != version ||
+      !readNumber(input, &archiveCount) || !readNumber(input, &levelCount) ||
+      !readNumber(input, &rowCount))
+  {
+    return false;
+  }
+
+  // The counts are checked against the size of the file before anything is
+  // allocated for them, so a damaged table can't ask for more memory than
+  // its own size. Each archive has at least the length of its name and each
+  // level the index of its archive as well.
+  const uint64_t rowSize = sizeof(myLevel[0]) + sizeof(myCube[0]) +
+                           sizeof(mySide[0]) + sizeof(myPrimary[0]) +
+                           sizeof(mySecondary[0]);
+  const uint64_t needed = uint64_t(archiveCount) * 4 +
+                          uint64_t(levelCount) * 8 + rowCount * rowSize;
+  uint64_t size;
+  if (!bytesLeft(input, &size) || needed > size) return false;
+
+  myArchives.resize(archiveCount);
+  for (uint32_t i = 0; i < archiveCount; ++i)
+  {
+    if (!readString(input, &myArchives[i])) return false;
+  }
+
+  myLevelArchives.resize(levelCount);
+  myLevels.resize(levelCount);
+  for (uint32_t i = 0; i < levelCount; ++i)
+  {
+    if (!readNumber(input, &myLevelArchives[i]) ||
+        myLevelArchives[i] >= archiveCount ||
+        !readString(input, &myLevels[i]))
+    {
+      return false;
+    }
+  }
+
+  if (!readColumn(input, rowCount, &myLevel) ||
+      !readColumn(input, rowCount, &myCube) ||
+      !readColumn(input, rowCount, &mySide) ||
+      !readColumn(input, rowCount, &myPrimary) ||
+      !readColumn(input, rowCount, &mySecondary))
+  {
+    return false;
+  }
+
+  // The queries index by these so they are checked once here.
+  for (uint32_t row = 0; row < rowCount; ++row)
+  {
+    if (myLevel[row] >= levelCount || myPrimary[row] >= textureLimit ||
+        mySecondary[row] >= textureLimit)
+    {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,111 @@
+#ifndef TEXTURE_TABLE_HPP_GUARD
+#define TEXTURE_TABLE_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : TextureTable
+// PURPOSE      : Providing which textures are used where across many levels.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : A table with a row for every side of every cube that has a
+//                texture, which is the sides without a neighbouring cube and
+//                the sides with a wall.
+//
+//                The table is stored a column at a time rather than a row at
+//                a time, so a query only goes through the columns it needs,
+//                each of which is a plain array of small numbers. The names of
+//                the archives and the levels are stored once each and the rows
+//                refer to them by index.
+//
+//                The file format is as follows, the numbers are in the byte
+//                order of the machine which wrote it.
+//
+//                 | "DTEX" - 4 bytes
+//                 | version, archive count, level count, row count - 32-bit
+//                 |---------------- Archives
+//                 | length - 32-bit, name
+//                 |---------------- Levels
+//                 | archive, length - 32-bit, name
+//                 |---------------- Columns, each has a value for every row
+//                 | level - 32-bit
+//                 | cube - 32-bit
+//                 | side - 8-bit
+//                 | primary texture - 16-bit
+//                 | secondary texture - 16-bit
+//
+//===----------------------------------------------------------------------===//
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Cube;
+
+// The number of textures that a texture number can refer to, as the high bit
+// of the primary texture is used for something else.
+const size_t textureLimit = 0x8000;
+
+struct TextureUsage
+{
+  uint16_t texture;
+  uint32_t primaryCount; // The number of sides with it as their texture.
+  uint32_t secondaryCount; // The number with it drawn over their texture.
+  uint32_t levelCount; // The number of levels which use it.
+};
+
+struct TextureLevelUsage
+{
+  std::string archive;
+  std::string level;
+  uint32_t primaryCount;
+  uint32_t secondaryCount;
+};
+
+class TextureTable
+{
+public:
+  uint32_t AddLevel(const std::string& archive, const std::string& level);
+  // Adds a level with no rows and returns its index.
+
+  void AddCubes(uint32_t level, const std::vector<Cube>& cubes);
+  // Adds the sides with textures of the cubes of the level.
+
+  void Append(const TextureTable& other);
+  // Adds the levels and the rows of the other table, this is used to put
+  // together the tables which were made in parallel.
+
+  size_t RowCount() const;
+
+  std::vector<TextureUsage> Histogram() const;
+  // Returns how much each texture that is used is used, in order of the
+  // texture.
+
+  std::vector<TextureLevelUsage> LevelsUsing(uint16_t texture) const;
+  // Returns the levels which use the texture and how much.
+
+  std::vector<uint16_t> Unused(uint16_t textureCount) const;
+  // Returns the textures less than textureCount which aren't used. Counts
+  // above textureLimit are treated as textureLimit.
+
+  bool Write(std::ostream& output) const;
+  bool Read(std::istream& input);
+  // Writes and reads the table in the format described above.
+
+private:
+  std::vector<std::string> myArchives;
+  std::vector<uint32_t> myLevelArchives;
+  std::vector<std::string> myLevels;
+
+  // The columns.
+  std::vector<uint32_t> myLevel;
+  std::vector<uint32_t> myCube;
+  std::vector<uint8_t> mySide;
+  std::vector<uint16_t> myPrimary;
+  std::vector<uint16_t> mySecondary; // 0 if there isn't one.
+};
+
+#endif
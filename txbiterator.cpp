@@ -19,14 +19,27 @@
 
 #include "txbiterator.hpp"
 
-char TxbReaderIterator::CurrentValue() const
+static char decodeByte(uint8_t Source)
 {
-  if (*mySource == 0x0A)
+  if (Source == 0x0A)
   {
     return 0x0A;
   }
 
-  return (((*mySource & 0x3F) << 2) + ((*mySource & 0xC0) >> 6)) ^ 0xA7;
+  return (((Source & 0x3F) << 2) + ((Source & 0xC0) >> 6)) ^ 0xA7;
+}
+
+char TxbReaderIterator::CurrentValue() const
+{
+  return decodeByte(*mySource);
+}
+
+void DecodeTxb(const uint8_t* Source, size_t Size, char* Text)
+{
+  for (size_t i = 0; i < Size; ++i)
+  {
+    Text[i] = decodeByte(Source[i]);
+  }
 }
 
 TxbReaderIterator::TxbReaderIterator(const uint8_t* Source)
@@ -16,6 +16,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <iterator>
+#include <stddef.h>
 #include <stdint.h>
 
 class TxbReaderIterator
@@ -60,4 +61,9 @@ public:
   };
 };
 
+void DecodeTxb(const uint8_t* Source, size_t Size, char* Text);
+// Decodes all of the TXB data into the text, which must have room for Size
+// characters as each byte becomes one character. The text may be the same
+// memory as the data to decode it in place.
+
 #endif
@@ -0,0 +1,336 @@
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Verify
+// PURPOSE      : Providing integrity checks for Descent .HOG files.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Checks the layout of a HOG file and the checksums of the files
+//                within it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "verify.hpp"
+
+#include "crc32c.hpp"
+#include "file.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include <string.h>
+
+// The size of the header which precedes the data of each file in the archive.
+static const uint64_t fileHeaderSize = 13 + 4;
+
+// The sizes of the header of a compressed archive and of each entry in its
+// table.
+static const uint64_t compressedHeaderSize = 3 + 1 + 4 + 8;
+static const uint64_t tableEntrySize = 13 + 1 + 4 + 4 + 8;
+
+// Checks that the stored data of the entries of a compressed archive exactly
+// covers the space from the end of its header to the start of its table.
+static bool verifyCompressedLayout(const std::vector<HogEntry>& entries,
+                                   uint64_t tableOffset, std::string* error)
+{
+  std::vector<const HogEntry*> sorted(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) sorted[i] = &entries[i];
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const HogEntry* a, const HogEntry* b)
+  { return a->offset < b->offset; });
+
+  std::ostringstream message;
+  uint64_t offset = compressedHeaderSize;
+  const char* previous = nullptr;
+  for (auto entry = sorted.begin(); entry != sorted.end(); ++entry)
+  {
+    if ((*entry)->offset < offset)
+    {
+      message << (*entry)->name << " at offset " << (*entry)->offset
+              << " overlaps " << (previous ? previous : "the header")
+              << " which ends at offset " << offset;
+      *error = message.str();
+      return false;
+    }
+    if ((*entry)->offset > offset)
+    {
+      message << ((*entry)->offset - offset) << " bytes at offset " << offset
+              << " are not part of any file";
+      *error = message.str();
+      return false;
+    }
+    offset += (*entry)->storedSize;
+    previous = (*entry)->name;
+  }
+
+  if (offset != tableOffset)
+  {
+    message << (tableOffset - offset) << " bytes at offset " << offset
+            << " before the table are not part of any file";
+    *error = message.str();
+    return false;
+  }
+  return true;
+}
+
+// The amount of a file that is read in at a time when computing its checksum.
+static const size_t blockSize = 1 << 20;
+
+bool VerifyLayout(const File& archive, std::vector<HogEntry>* entries,
+                  std::string* error)
+{
+  std::ostringstream message;
+  const uint64_t archiveSize = archive.Size();
+
+  uint8_t magic[3];
+  if (!archive.ReadAt(0, magic, sizeof(magic)))
+  {
+    *error = "unable to read the start of the archive";
+    return false;
+  }
+
+  // A compressed archive has a table of its files instead of headers, which
+  // is checked by reading it.
+  if (memcmp(magic, "DHZ", sizeof(magic)) == 0)
+  {
+    if (!ReadCompressedTable(archive, entries))
+    {
+      *error = "the table of the compressed archive is not valid";
+      return false;
+    }
+
+    // The table is valid so it is the last thing in the archive.
+    const uint64_t tableOffset = archiveSize - entries->size() * tableEntrySize;
+    return verifyCompressedLayout(*entries, tableOffset, error);
+  }
+
+  if (memcmp(magic, "DHF", sizeof(magic)) != 0)
+  {
+    *error = "the archive does not start with DHF or DHZ";
+    return false;
+  }
+
+  uint64_t offset = sizeof(magic);
+  while (offset < archiveSize)
+  {
+    if (offset + fileHeaderSize > archiveSize)
+    {
+      message << (archiveSize - offset) << " bytes left over at offset "
+              << offset << " which is too small for a header";
+      *error = message.str();
+      return false;
+    }
+
+    uint8_t header[fileHeaderSize];
+    if (!archive.ReadAt(offset, header, sizeof(header)))
+    {
+      message << "unable to read the header at offset " << offset;
+      *error = message.str();
+      return false;
+    }
+
+    HogEntry entry;
+    memcpy(entry.name, header, 13);
+    memcpy(&entry.size, header + 13, 4);
+    entry.offset = offset + fileHeaderSize;
+    entry.storedSize = entry.size;
+    entry.compression = HogStored;
+
+    if (memchr(entry.name, '\0', sizeof(entry.name)) == nullptr)
+    {
+      message << "the name of the file at offset " << offset
+              << " is not terminated";
+      *error = message.str();
+      return false;
+    }
+
+    if (entry.offset + entry.size > archiveSize)
+    {
+      message << entry.name << " at offset " << entry.offset << " is "
+              << entry.size << " bytes but the archive ends "
+              << (archiveSize - entry.offset) << " bytes after it starts";
+      *error = message.str();
+      return false;
+    }
+
+    entries->push_back(entry);
+    offset = entry.offset + entry.size;
+  }
+
+  return true;
+}
+
+std::vector<HogChecksum> Checksums(const File& archive,
+                                   const std::vector<HogEntry>& entries,
+                                   std::vector<std::string>* errors)
+{
+  std::vector<HogChecksum> checksums(entries.size());
+  std::vector<std::vector<uint8_t>> buffers(ThreadCount());
+  std::vector<uint8_t> isRead(entries.size());
+
+  ParallelFor(entries.size(),
+              [&](size_t index, size_t thread)
+  {
+    const HogEntry& entry = entries[index];
+    std::vector<uint8_t>& buffer = buffers[thread];
+    buffer.resize(blockSize);
+
+    uint32_t crc = 0;
+    isRead[index] = 1;
+    if (entry.compression != HogStored)
+    {
+      // A compressed file is read in whole to decompress it, so that its
+      // checksum is of its data rather than how it is stored.
+      if (ReadEntry(archive, entry, &buffer))
+      {
+        crc = Crc32c(buffer.data(), buffer.size(), crc);
+      }
+      else
+      {
+        isRead[index] = 0;
+      }
+    }
+    else
+    {
+      for (uint64_t done = 0; done < entry.size;)
+      {
+        const size_t count = static_cast<size_t>(
+            entry.size - done < blockSize ? entry.size - done : blockSize);
+        if (!archive.ReadAt(entry.offset + done, buffer.data(), count))
+        {
+          isRead[index] = 0;
+          break;
+        }
+        crc = Crc32c(buffer.data(), count, crc);
+        done += count;
+      }
+    }
+
+    checksums[index].name = entry.name;
+    checksums[index].size = entry.size;
+    checksums[index].crc = crc;
+  });
+
+  // Padding between files is not part of the contents.
+  std::vector<HogChecksum> files;
+  files.reserve(checksums.size());
+  for (size_t i = 0; i < checksums.size(); ++i)
+  {
+    if (!isRead[i])
+    {
+      std::ostringstream message;
+      message << "unable to read " << entries[i].name << " at offset "
+              << entries[i].offset;
+      if (entries[i].compression != HogStored) message << " or decompress it";
+      errors->push_back(message.str());
+    }
+    else if (!checksums[i].name.empty())
+    {
+      files.push_back(checksums[i]);
+    }
+  }
+  return files;
+}
+
+bool ReadChecksums(const char* filename, std::vector<HogChecksum>* checksums)
+{
+  std::ifstream input(filename);
+  if (!input) return false;
+
+  std::string line;
+  while (std::getline(input, line))
+  {
+    std::istringstream fields(line);
+    HogChecksum checksum;
+    if (fields >> std::hex >> checksum.crc >> std::dec >> checksum.size >>
+        checksum.name)
+    {
+      checksums->push_back(checksum);
+    }
+  }
+  return true;
+}
+
+void WriteChecksums(const std::vector<HogChecksum>& checksums,
+                    std::ostream& output)
+{
+  for (auto checksum = checksums.begin(); checksum != checksums.end();
+       ++checksum)
+  {
+    output << std::hex << std::setw(8) << std::setfill('0') << checksum->crc
+           << std::dec << " " << checksum->size << " " << checksum->name
+           << std::endl;
+  }
+}
+
+std::vector<std::string> CompareChecksums(
+    const std::vector<HogChecksum>& expected,
+    const std::vector<HogChecksum>& actual)
+{
+  std::vector<std::string> differences;
+
+  // The files are keyed by their name and how many files with that name came
+  // before them, so files with the same name are each compared.
+  typedef std::pair<std::string, size_t> Key;
+  const auto describe = [](const Key& key) -> std::string
+  {
+    if (key.second == 0) return key.first;
+    std::ostringstream name;
+    name << key.first << " (copy " << key.second + 1 << ")";
+    return name.str();
+  };
+
+  std::map<Key, const HogChecksum*> remaining;
+  std::map<std::string, size_t> occurrences;
+  for (auto checksum = expected.begin(); checksum != expected.end();
+       ++checksum)
+  {
+    const Key key(checksum->name, occurrences[checksum->name]++);
+    remaining[key] = &*checksum;
+  }
+
+  occurrences.clear();
+  for (auto checksum = actual.begin(); checksum != actual.end(); ++checksum)
+  {
+    const Key key(checksum->name, occurrences[checksum->name]++);
+    const std::string name = describe(key);
+    const auto match = remaining.find(key);
+    if (match == remaining.end())
+    {
+      differences.push_back(name + " is not in the checksums");
+      continue;
+    }
+
+    if (match->second->size != checksum->size)
+    {
+      std::ostringstream message;
+      message << name << " is " << checksum->size << " bytes but should be "
+              << match->second->size;
+      differences.push_back(message.str());
+    }
+    else if (match->second->crc != checksum->crc)
+    {
+      std::ostringstream message;
+      message << name << " has a CRC of " << std::hex << std::setw(8)
+              << std::setfill('0') << checksum->crc << " but should be "
+              << std::setw(8) << match->second->crc;
+      differences.push_back(message.str());
+    }
+    remaining.erase(match);
+  }
+
+  for (auto checksum = remaining.begin(); checksum != remaining.end();
+       ++checksum)
+  {
+    differences.push_back(describe(checksum->first) +
+                          " is missing from the archive");
+  }
+
+  return differences;
+}
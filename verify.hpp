@@ -0,0 +1,66 @@
+#ifndef VERIFY_HPP_GUARD
+#define VERIFY_HPP_GUARD
+//===----------------------------------------------------------------------===//
+//
+//                     The Descent map loader
+//
+// NAME         : Verify
+// PURPOSE      : Providing integrity checks for Descent .HOG files.
+// COPYRIGHT    : (c) 2026 Sean Donnellan. All Rights Reserved.
+// AUTHORS      : Sean Donnellan (darkdonno@gmail.com)
+// DESCRIPTION  : Checks that the headers in a HOG file describe the whole file
+//                (with nothing truncated or left over) and computes the CRC-32C
+//                of each file so they can be compared to a known good list.
+//
+//                The list of checksums is a text file with a line per file:
+//
+//                  <CRC-32C as 8 hex digits> <size> <name>
+//
+//                which is what the verify mode of the hog tool prints.
+//
+//===----------------------------------------------------------------------===//
+
+#include "hogreader.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+class File;
+
+struct HogChecksum
+{
+  std::string name;
+  uint32_t size;
+  uint32_t crc;
+};
+
+bool VerifyLayout(const File& archive, std::vector<HogEntry>* entries,
+                  std::string* error);
+// Walks every header in the archive and returns the entries in it. Returns
+// false and describes the problem in error if the entries don't exactly
+// cover the archive. For a compressed archive the table is read instead and
+// the stored data of its entries must cover the space between the header
+// and the table without overlapping.
+
+std::vector<HogChecksum> Checksums(const File& archive,
+                                   const std::vector<HogEntry>& entries,
+                                   std::vector<std::string>* errors);
+// Returns the CRC-32C of the data of each entry. The entries are checked in
+// parallel. An entry which can't be read is described in errors instead of
+// being given a checksum.
+
+bool ReadChecksums(const char* filename, std::vector<HogChecksum>* checksums);
+void WriteChecksums(const std::vector<HogChecksum>& checksums,
+                    std::ostream& output);
+
+std::vector<std::string> CompareChecksums(
+    const std::vector<HogChecksum>& expected,
+    const std::vector<HogChecksum>& actual);
+// Returns a description of each difference between the two lists. When more
+// than one file has the same name they are matched up in the order they are
+// in the lists.
+
+#endif